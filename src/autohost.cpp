@@ -159,7 +159,8 @@ void AutoHost::OnSaidBattle( const wxString& /*unused*/, const wxString& msg )
 		if ( params.IsEmpty() ) DoAction( _T( "cannot switch to void mapname" ) );
 		else
 		{
-            const wxString mapname = GetBestMatch( lslTowxArrayString(LSL::usync().GetMapList()), params );
+            m_map_matcher.SetCandidates( LSL::usync().GetMapList() );
+            const wxString mapname = TowxString( m_map_matcher.GetBest( STD_STRING(params) ) );
 			try
 			{
 				m_battle.SetLocalMap(STD_STRING(mapname));
@@ -7,6 +7,8 @@
 #include <wx/string.h>
 #include <wx/arrstr.h>
 
+#include "utils/fuzzymatcher.h"
+
 class IBattle;
 class User;
 class wxString;
@@ -34,6 +36,8 @@ class AutoHost
     bool m_enabled;
     time_t m_lastActionTime;
     wxArrayString m_userlist;
+    //! normalized map names for !map, rebuilt when the map list changes
+    FuzzyMatcher m_map_matcher;
 };
 
 #endif // SPRINGLOBBY_HEADERGUARD_AUTOHOST_H
@@ -33,6 +33,8 @@
 #include "log.h"
 #include "iserver.h"
 #include "gui/ui.h"
+#include "utils/partitioner.h"
+#include "contentregistry.h"
 
 
 const unsigned int TIMER_INTERVAL         = 1000;
@@ -54,6 +56,8 @@ Battle::Battle( IServer& serv, int id ) :
 	m_autohost_manager = new AutohostManager(); //FIXME: don't instantiate for each battle, only for the battle we've joined
 	m_autohost_manager->SetBattle(this);
 	ConnectGlobalEvent(this, GlobalEvent::OnUnitsyncReloaded, wxObjectEventFunction(&Battle::OnUnitsyncReloaded));
+	m_content_serial = contentRegistry().GetSerial();
+	ConnectGlobalEvent(this, GlobalEvent::OnContentAdded, wxObjectEventFunction(&Battle::OnContentAdded));
     m_opts.battleid =  m_id;
 }
 
@@ -550,6 +554,89 @@ void Battle::ForceSpectator( User& user, bool spectator )
 }
 
 
+Battle::StatusEdit::Change& Battle::StatusEdit::Get( User& user )
+{
+	std::map<User*, Change>::iterator it = m_changes.find( &user );
+	if ( it != m_changes.end() ) return it->second;
+	m_users.push_back( &user );
+	return m_changes[&user];
+}
+
+void Battle::StatusEdit::SetTeam( User& user, int team )
+{
+	Change& change = Get( user );
+	change.fields |= EDIT_TEAM;
+	change.status.team = team;
+}
+
+void Battle::StatusEdit::SetAlly( User& user, int ally )
+{
+	Change& change = Get( user );
+	change.fields |= EDIT_ALLY;
+	change.status.ally = ally;
+}
+
+void Battle::StatusEdit::SetColour( User& user, const LSL::lslColor& col )
+{
+	Change& change = Get( user );
+	change.fields |= EDIT_COLOUR;
+	change.status.colour = col;
+}
+
+void Battle::StatusEdit::SetSpectator( User& user, bool spectator )
+{
+	Change& change = Get( user );
+	change.fields |= EDIT_SPECTATOR;
+	change.status.spectator = spectator;
+}
+
+void Battle::ApplyStatusEdit( const StatusEdit& edit )
+{
+	if ( edit.IsEmpty() ) return;
+	// all commands go out in one write
+	m_serv.BeginSendBatch();
+	for ( size_t i = 0; i < edit.m_users.size(); i++ )
+	{
+		User& user = *edit.m_users[i];
+		const StatusEdit::Change& change = edit.m_changes.find( &user )->second;
+		const UserBattleStatus current = user.BattleStatus();
+		unsigned int fields = 0;
+		if ( ( change.fields & StatusEdit::EDIT_TEAM ) && change.status.team != current.team ) fields |= StatusEdit::EDIT_TEAM;
+		if ( ( change.fields & StatusEdit::EDIT_ALLY ) && change.status.ally != current.ally ) fields |= StatusEdit::EDIT_ALLY;
+		if ( ( change.fields & StatusEdit::EDIT_COLOUR ) && change.status.colour != current.colour ) fields |= StatusEdit::EDIT_COLOUR;
+		if ( ( change.fields & StatusEdit::EDIT_SPECTATOR ) && change.status.spectator != current.spectator ) fields |= StatusEdit::EDIT_SPECTATOR;
+		if ( fields == 0 ) continue;
+
+		if ( current.IsBot() || &user == &GetMe() )
+		{
+			// the whole status is sent, so one update carries all fields
+			UserBattleStatus status = current;
+			if ( fields & StatusEdit::EDIT_TEAM ) {
+				IBattle::ForceTeam( user, change.status.team );
+				status.team = change.status.team;
+			}
+			if ( fields & StatusEdit::EDIT_ALLY ) {
+				IBattle::ForceAlly( user, change.status.ally );
+				status.ally = change.status.ally;
+			}
+			if ( fields & StatusEdit::EDIT_COLOUR ) {
+				IBattle::ForceColour( user, change.status.colour );
+				status.colour = change.status.colour;
+			}
+			if ( fields & StatusEdit::EDIT_SPECTATOR ) status.spectator = change.status.spectator;
+			if ( current.IsBot() ) m_serv.UpdateBot( m_opts.battleid, user, status );
+			else m_serv.SendMyBattleStatus( status );
+			continue;
+		}
+		if ( fields & StatusEdit::EDIT_TEAM ) ForceTeam( user, change.status.team );
+		if ( fields & StatusEdit::EDIT_ALLY ) ForceAlly( user, change.status.ally );
+		if ( fields & StatusEdit::EDIT_COLOUR ) ForceColour( user, change.status.colour );
+		if ( fields & StatusEdit::EDIT_SPECTATOR ) ForceSpectator( user, change.status.spectator );
+	}
+	m_serv.EndSendBatch();
+}
+
+
 void Battle::KickPlayer( User& user )
 {
     m_serv.BattleKickPlayer( m_opts.battleid, user );
@@ -564,38 +651,44 @@ void Battle::SetHandicap( User& user, int handicap)
 
 void Battle::ForceUnsyncedToSpectate()
 {
+    StatusEdit edit;
     size_t numusers = GetNumUsers();
     for ( size_t i = 0; i < numusers; ++i )
     {
         User &user = GetUser(i);
         UserBattleStatus& bs = user.BattleStatus();
         if ( bs.IsBot() ) continue;
-        if ( !bs.spectator && !bs.sync ) ForceSpectator( user, true );
+        if ( !bs.spectator && !bs.sync ) edit.SetSpectator( user, true );
     }
+    ApplyStatusEdit( edit );
 }
 
 void Battle::ForceUnReadyToSpectate()
 {
+    StatusEdit edit;
     size_t numusers = GetNumUsers();
     for ( size_t i = 0; i < numusers; ++i )
     {
         User &user = GetUser(i);
         UserBattleStatus& bs = user.BattleStatus();
         if ( bs.IsBot() ) continue;
-        if ( !bs.spectator && !bs.ready ) ForceSpectator( user, true );
+        if ( !bs.spectator && !bs.ready ) edit.SetSpectator( user, true );
     }
+    ApplyStatusEdit( edit );
 }
 
 void Battle::ForceUnsyncedAndUnreadyToSpectate()
 {
+    StatusEdit edit;
     size_t numusers = GetNumUsers();
     for ( size_t i = 0; i < numusers; ++i )
     {
         User &user = GetUser(i);
         UserBattleStatus& bs = user.BattleStatus();
         if ( bs.IsBot() ) continue;
-				if ( !bs.spectator && ( !bs.sync || !bs.ready ) ) ForceSpectator( user, true );
+				if ( !bs.spectator && ( !bs.sync || !bs.ready ) ) edit.SetSpectator( user, true );
     }
+    ApplyStatusEdit( edit );
 }
 
 
@@ -668,6 +761,7 @@ void Battle::StartSpring()
 		SendMyBattleStatus();
 		// set m_generating_script, this will make the script.txt writer realize we're just clients even if using a relayhost
 		m_generating_script = true;
+		m_serv.CloseUdpSocket();
 		GetMe().Status().in_game = spring().Run( *this );
 		m_generating_script = false;
 		GetMe().SendMyUserStatus();
@@ -722,141 +816,117 @@ void Battle::SetInGame( bool value )
 void Battle::FixColours()
 {
     if ( !IsFounderMe() )return;
-    std::vector<LSL::lslColor> &palette = GetFixColoursPalette( m_teams_sizes.size() + 1 );
-    std::vector<int> palette_use( palette.size(), 0 );
+    const LSL::lslColor my_col = GetMe().BattleStatus().colour; // Never changes color of founder (me) :-)
 
-    LSL::lslColor my_col = GetMe().BattleStatus().colour; // Never changes color of founder (me) :-)
-    int my_diff = 0;
-    int my_col_i = GetClosestFixColour( my_col, palette_use,my_diff );
-    palette_use[my_col_i]++;
+    std::vector<int> teams;
+    std::vector<LSL::lslColor> wanted;
     std::set<int> parsed_teams;
-
+    const bool me_playing = !GetMe().BattleStatus().spectator;
+    if ( me_playing ) parsed_teams.insert( GetMe().BattleStatus().team ); // players sharing my team get my colour
     for ( user_map_t::size_type i = 0; i < GetNumUsers(); i++ )
     {
         User &user=GetUser(i);
         if ( &user == &GetMe() ) continue; // skip founder ( yourself )
         UserBattleStatus& status = user.BattleStatus();
         if ( status.spectator ) continue;
-        if ( parsed_teams.find( status.team ) != parsed_teams.end() ) continue; // skip duplicates
-        parsed_teams.insert( status.team );
+        if ( !parsed_teams.insert( status.team ).second ) continue; // skip duplicates
+        teams.push_back( status.team );
+        wanted.push_back( status.colour );
+    }
 
-        LSL::lslColor &user_col=status.colour;
-        int user_col_i=GetClosestFixColour(user_col,palette_use, 60);
-        palette_use[user_col_i]++;
-				for ( user_map_t::size_type j = 0; j < GetNumUsers(); j++ )
-				{
-					User &usr=GetUser(j);
-					if ( usr.BattleStatus().team == status.team )
-					{
-						 ForceColour( usr, palette[user_col_i]);
-					}
-				}
+    const std::vector<LSL::lslColor> colours = GetSeparatedColours( my_col, wanted );
+    std::map<int, LSL::lslColor> team_colours;
+    for ( size_t i = 0; i < teams.size(); i++ ) team_colours[teams[i]] = colours[i];
+    if ( me_playing ) team_colours[GetMe().BattleStatus().team] = my_col;
+
+    StatusEdit edit;
+    for ( user_map_t::size_type i = 0; i < GetNumUsers(); i++ )
+    {
+        User &usr=GetUser(i);
+        if ( &usr == &GetMe() ) continue;
+        std::map<int, LSL::lslColor>::const_iterator it = team_colours.find( usr.BattleStatus().team );
+        if ( it == team_colours.end() ) continue;
+        edit.SetColour( usr, it->second );
     }
+    ApplyStatusEdit( edit );
 }
 
 
-bool PlayerRankCompareFunction( User *a, User *b ) // should never operate on nulls. Hence, ASSERT_LOGIC is appropriate here.
+//! time the balancer may spend searching for a better assignment than the initial heuristic
+const long BALANCE_TIME_BUDGET_MS = 100;
+
+int my_random( int range )
 {
-    ASSERT_LOGIC( a, _T("fail in Autobalance, NULL player") );
-    ASSERT_LOGIC( b, _T("fail in Autobalance, NULL player") );
-    return ( a->GetBalanceRank() > b->GetBalanceRank() );
+    return rand() % range;
 }
 
-bool PlayerTeamCompareFunction( User *a, User *b ) // should never operate on nulls. Hence, ASSERT_LOGIC is appropriate here.
+void shuffle(std::vector<User *> &players) // proper shuffle.
 {
-    ASSERT_LOGIC( a, _T("fail in Autobalance, NULL player") );
-    ASSERT_LOGIC( b, _T("fail in Autobalance, NULL player") );
-    return ( a->BattleStatus().team > b->BattleStatus().team );
+    for ( size_t i=0; i < players.size(); ++i ) // the players below i are shuffled, the players above arent
+    {
+        int rn = i + my_random( players.size() - i ); // the top of shuffled part becomes random card from unshuffled part
+        User *tmp = players[i];
+        players[i] = players[rn];
+        players[rn] = tmp;
+    }
 }
 
-struct Alliance
+/** Weight every player by balance rank, clan members are grouped so they end up in the same bin.
+ * Random balancing weights everyone equally, so only the number of players per bin is balanced.
+ */
+static std::vector<Partitioner::Item> GetBalanceItems( const std::vector<User*>& players, IBattle::BalanceType balance_type, bool support_clans, bool strong_clans, size_t bins )
 {
-    std::vector<User *>players;
-    float ranksum;
-    int allynum;
-    Alliance(): ranksum(0), allynum(-1) {}
-    Alliance(int i): ranksum(0), allynum(i) {}
-    void AddPlayer( User *player )
+    std::map<std::string, std::vector<size_t> > clans;
+    if ( support_clans )
     {
-        if ( player )
+        for ( size_t i = 0; i < players.size(); ++i )
         {
-            players.push_back( player );
-            ranksum += player->GetBalanceRank();
+            const std::string clan = players[i]->GetClan();
+            if ( !clan.empty() ) clans[clan].push_back( i );
         }
     }
-    void AddAlliance( Alliance &other )
-    {
-		for ( std::vector<User *>::const_iterator i = other.players.begin(); i != other.players.end(); ++i ) AddPlayer( *i );
-    }
-    bool operator < ( const Alliance &other ) const
+
+    std::vector<Partitioner::Item> items( players.size() );
+    for ( size_t i = 0; i < players.size(); ++i )
     {
-        return ranksum < other.ranksum;
+        ASSERT_LOGIC( players[i], _T("fail in Autobalance, NULL player") );
+        items[i].weight = ( balance_type == IBattle::balance_random ) ? 1.0 : players[i]->GetBalanceRank();
     }
-};
 
-struct ControlTeam
-{
-    std::vector<User*> players;
-    float ranksum;
-    int teamnum;
-    ControlTeam(): ranksum(0), teamnum(-1) {}
-    ControlTeam( int i ): ranksum(0), teamnum(i) {}
-    void AddPlayer( User *player )
+    int group = 0;
+    for ( std::map<std::string, std::vector<size_t> >::const_iterator it = clans.begin(); it != clans.end(); ++it )
     {
-        if ( player )
+        const std::vector<size_t>& members = it->second;
+        // if clan is too small (only 1 clan member in battle) or too big, dont count it as clan
+        if ( ( members.size() < 2 ) || ( !strong_clans && ( members.size() > ( ( players.size() + bins - 1 ) / bins ) ) ) )
         {
-            players.push_back( player );
-            ranksum += player->GetBalanceRank();
+            wxLogMessage( _T("removing clan %s"), TowxString( it->first ).c_str() );
+            continue;
         }
+        wxLogMessage( _T("Inserting clan %s"), TowxString( it->first ).c_str() );
+        for ( size_t i = 0; i < members.size(); ++i ) items[members[i]].group = group;
+        group++;
     }
-    void AddTeam( ControlTeam &other )
-    {
-		for ( std::vector<User*>::const_iterator i = other.players.begin(); i != other.players.end(); ++i ) AddPlayer( *i );
-    }
-    bool operator < (const ControlTeam &other) const
-    {
-        return ranksum < other.ranksum;
-    }
-};
-
-int my_random( int range )
-{
-    return rand() % range;
+    return items;
 }
 
-void shuffle(std::vector<User *> &players) // proper shuffle.
+//! partition players into bins, keeping as many players as possible in the bin matching their current index
+static std::vector<int> BalancePlayers( const std::vector<User*>& players, const std::vector<int>& current, IBattle::BalanceType balance_type, bool support_clans, bool strong_clans, size_t bins )
 {
-    for ( size_t i=0; i < players.size(); ++i ) // the players below i are shuffled, the players above arent
-    {
-        int rn = i + my_random( players.size() - i ); // the top of shuffled part becomes random card from unshuffled part
-        User *tmp = players[i];
-        players[i] = players[rn];
-        players[rn] = tmp;
-    }
+    const std::vector<Partitioner::Item> items = GetBalanceItems( players, balance_type, support_clans, strong_clans, bins );
+    Partitioner::Stats stats;
+    std::vector<int> res = Partitioner::Balance( items, bins, BALANCE_TIME_BUDGET_MS, &stats );
+    wxLogMessage( _T("balanced %u players into %u groups: rank spread %.3f (heuristic %.3f), %lu nodes in %ld ms%s"),
+                  (unsigned int)players.size(), (unsigned int)bins, stats.spread, stats.initial_spread,
+                  stats.nodes, stats.elapsed_ms, stats.optimal ? _T(", optimal") : _T("") );
+    Partitioner::MinimizeRelabel( res, current, bins );
+    return res;
 }
 
-/*
-bool ClanRemovalFunction(const std::map<wxString, Alliance>::value_type &v){
-  return v.second.players.size()<2;
-}
-*/
-/*
-struct ClannersRemovalPredicate{
-  std::map<wxString, Alliance> &clans;
-  PlayerRemovalPredicate(std::map<wxString, Alliance> &clans_):clans(clans_)
-  {
-  }
-  bool operator()(User *u) const{
-    return clans.find(u->GetClan());
-  }
-}*/
-
 void Battle::Autobalance( BalanceType balance_type, bool support_clans, bool strong_clans, int numallyteams )
 {
     wxLogMessage(_T("Autobalancing alliances, type=%d, clans=%d, strong_clans=%d, numallyteams=%d"),balance_type, support_clans,strong_clans, numallyteams);
-    //size_t i;
-    //int num_alliances;
-    std::vector<Alliance>alliances;
+    std::vector<int> allynums;
 	if ( numallyteams == 0 || numallyteams == -1 ) // 0 or 1 -> use num start rects
     {
         int ally = 0;
@@ -866,152 +936,68 @@ void Battle::Autobalance( BalanceType balance_type, bool support_clans, bool str
             if ( sr.IsOk() )
             {
                 ally=i;
-                alliances.push_back( Alliance( ally ) );
+                allynums.push_back( ally );
                 ally++;
             }
         }
         // make at least two alliances
-        while ( alliances.size() < 2 )
+        while ( allynums.size() < 2 )
         {
-            alliances.push_back( Alliance( ally ) );
+            allynums.push_back( ally );
             ally++;
         }
     }
     else
     {
-        for ( int i = 0; i < numallyteams; i++ ) alliances.push_back( Alliance( i ) );
+        for ( int i = 0; i < numallyteams; i++ ) allynums.push_back( i );
     }
 
-    //for(i=0;i<alliances.size();++i)alliances[i].allynum=i;
-
-    wxLogMessage( _T("number of alliances: %u"), alliances.size() );
-
-    std::vector<User*> players_sorted;
-    players_sorted.reserve( GetNumUsers() );
-
-    for ( size_t i = 0; i < GetNumUsers(); ++i )
-    {
-        User& usr = GetUser( i );
-        if ( !usr.BattleStatus().spectator )
-        {
-            players_sorted.push_back( &usr );
-        }
-    }
+    wxLogMessage( _T("number of alliances: %u"), allynums.size() );
 
     // remove players in the same team so only one remains
     std::map< int, User*> dedupe_teams;
-	for ( std::vector<User*>::const_iterator it = players_sorted.begin(); it != players_sorted.end(); ++it )
+    for ( size_t i = 0; i < GetNumUsers(); ++i )
     {
-        dedupe_teams[(*it)->BattleStatus().team] = *it;
+        User& usr = GetUser( i );
+        if ( !usr.BattleStatus().spectator ) dedupe_teams[usr.BattleStatus().team] = &usr;
     }
-    players_sorted.clear();
-    players_sorted.reserve( dedupe_teams.size() );
+    std::vector<User*> players;
+    players.reserve( dedupe_teams.size() );
 	for ( std::map<int, User*>::const_iterator it = dedupe_teams.begin(); it != dedupe_teams.end(); ++it )
     {
-        players_sorted.push_back( it->second );
+        players.push_back( it->second );
     }
 
-    shuffle( players_sorted );
+    shuffle( players );
 
-    std::map<wxString, Alliance> clan_alliances;
-    if ( support_clans )
+    std::vector<int> current( players.size(), -1 );
+    for ( size_t i = 0; i < players.size(); ++i )
     {
-        for ( size_t i=0; i < players_sorted.size(); ++i )
-        {
-            wxString clan = TowxString(players_sorted[i]->GetClan());
-            if ( !clan.empty() )
-            {
-                clan_alliances[clan].AddPlayer( players_sorted[i] );
-            }
-        }
-    };
-
-    if ( balance_type != balance_random ) std::sort( players_sorted.begin(), players_sorted.end(), PlayerRankCompareFunction );
-
-    if ( support_clans )
-    {
-		std::map<wxString, Alliance>::iterator clan_it = clan_alliances.begin();
-        while ( clan_it != clan_alliances.end() )
-        {
-            Alliance &clan = (*clan_it).second;
-            // if clan is too small (only 1 clan member in battle) or too big, dont count it as clan
-            if ( ( clan.players.size() < 2 ) || ( !strong_clans && ( clan.players.size() > ( ( players_sorted.size() + alliances.size() -1 ) / alliances.size() ) ) ) )
-            {
-                wxLogMessage( _T("removing clan %s"), (*clan_it).first.c_str() );
-                std::map<wxString, Alliance>::iterator next = clan_it;
-                ++next;
-                clan_alliances.erase( clan_it );
-                clan_it = next;
-                continue;
-            }
-            wxLogMessage( _T("Inserting clan %s"), (*clan_it).first.c_str() );
-            std::sort( alliances.begin(), alliances.end() );
-            float lowestrank = alliances[0].ranksum;
-            int rnd_k = 1;// number of alliances with rank equal to lowestrank
-            while ( size_t( rnd_k ) < alliances.size() )
-            {
-                if ( fabs( alliances[rnd_k].ranksum - lowestrank ) > 0.01 ) break;
-                rnd_k++;
-            }
-            wxLogMessage( _T("number of lowestrank alliances with same rank=%d"), rnd_k );
-            alliances[my_random( rnd_k )].AddAlliance( clan );
-            ++clan_it;
-        }
+        std::vector<int>::const_iterator it = std::find( allynums.begin(), allynums.end(), players[i]->BattleStatus().ally );
+        if ( it != allynums.end() ) current[i] = it - allynums.begin();
     }
 
-    for ( size_t i = 0; i < players_sorted.size(); ++i )
-    {
-        // skip clanners, those have been added already.
-        if ( clan_alliances.count( TowxString(players_sorted[i]->GetClan()) ) > 0 )
-        {
-            wxLogMessage( _T("clanner already added, nick=%s"), players_sorted[i]->GetNick().c_str() );
-            continue;
-        }
+    const std::vector<int> res = BalancePlayers( players, current, balance_type, support_clans, strong_clans, allynums.size() );
 
-        // find alliances with lowest ranksum
-        // insert current user into random one out of them
-        // since performance doesnt matter here, i simply sort alliances,
-        // then find how many alliances in beginning have lowest ranksum
-        // note that balance player ranks range from 1 to 1.1 now
-        // i.e. them are quasi equal
-        // so we're essentially adding to alliance with smallest number of players,
-        // the one with smallest ranksum.
-
-        std::sort( alliances.begin(), alliances.end() );
-        float lowestrank = alliances[0].ranksum;
-        int rnd_k = 1;// number of alliances with rank equal to lowestrank
-        while ( size_t( rnd_k ) < alliances.size() )
-        {
-            if ( fabs( alliances[rnd_k].ranksum - lowestrank ) > 0.01 ) break;
-            rnd_k++;
-        }
-        wxLogMessage( _T("number of lowestrank alliances with same rank=%d"), rnd_k );
-        alliances[my_random( rnd_k )].AddPlayer( players_sorted[i] );
-    }
+    std::map<int, int> team_ally;
+    for ( size_t i = 0; i < players.size(); ++i ) team_ally[players[i]->BattleStatus().team] = allynums[res[i]];
 
-    UserList::user_map_t::size_type totalplayers = GetNumUsers();
-    for ( size_t i = 0; i < alliances.size(); ++i )
+    // change ally num of all players in the team, only where it actually changes
+    StatusEdit edit;
+    for ( size_t h = 0; h < GetNumUsers(); h++ )
     {
-        for ( size_t j = 0; j < alliances[i].players.size(); ++j )
-        {
-            ASSERT_LOGIC( alliances[i].players[j], _T("fail in Autobalance, NULL player") );
-            int balanceteam = alliances[i].players[j]->BattleStatus().team;
-            wxLogMessage( _T("setting team %d to alliance %d"), balanceteam, i );
-            for ( size_t h = 0; h < totalplayers; h++ ) // change ally num of all players in the team
-            {
-              User& usr = GetUser( h );
-              if ( usr.BattleStatus().team == balanceteam ) ForceAlly( usr, alliances[i].allynum );
-            }
-        }
+        User& usr = GetUser( h );
+        std::map<int, int>::const_iterator it = team_ally.find( usr.BattleStatus().team );
+        if ( it == team_ally.end() || usr.BattleStatus().ally == it->second ) continue;
+        wxLogMessage( _T("setting team %d to alliance %d"), it->first, it->second );
+        edit.SetAlly( usr, it->second );
     }
+    ApplyStatusEdit( edit );
 }
 
 void Battle::FixTeamIDs( BalanceType balance_type, bool support_clans, bool strong_clans, int numcontrolteams )
 {
     wxLogMessage(_T("Autobalancing teams, type=%d, clans=%d, strong_clans=%d, numcontrolteams=%d"),balance_type, support_clans, strong_clans, numcontrolteams);
-    //size_t i;
-    //int num_alliances;
-    std::vector<ControlTeam> control_teams;
 
 	if ( numcontrolteams == 0 || numcontrolteams == -1 ) numcontrolteams = GetNumUsers() - GetSpectators(); // 0 or -1 -> use num players, will use comshare only if no available team slots
     IBattle::StartType position_type = (IBattle::StartType)
@@ -1038,6 +1024,7 @@ void Battle::FixTeamIDs( BalanceType balance_type, bool support_clans, bool stro
       }
       std::set<int> teams;
       int t = 0;
+      StatusEdit edit;
       for( size_t i = 0; i < GetNumUsers(); ++i )
       {
         User &user = GetUser(i);
@@ -1046,7 +1033,7 @@ void Battle::FixTeamIDs( BalanceType balance_type, bool support_clans, bool stro
           if( teams.count( user.BattleStatus().team ) )
           {
             while( allteams.count(t) || teams.count( t ) ) t++;
-            ForceTeam( GetUser(i), t );
+            edit.SetTeam( GetUser(i), t );
             teams.insert( t );
           }
           else
@@ -1055,118 +1042,42 @@ void Battle::FixTeamIDs( BalanceType balance_type, bool support_clans, bool stro
           }
         }
       }
+      ApplyStatusEdit( edit );
       return;
     }
-    for ( int i = 0; i < numcontrolteams; i++ ) control_teams.push_back( ControlTeam( i ) );
-
-    wxLogMessage(_T("number of teams: %u"), control_teams.size() );
-
-    std::vector<User*> players_sorted;
-    players_sorted.reserve( GetNumUsers() );
+    if ( numcontrolteams < 1 ) return;
 
-    int player_team_counter = 0;
+    wxLogMessage(_T("number of teams: %u"), numcontrolteams );
 
+    std::vector<User*> players;
+    players.reserve( GetNumUsers() );
     for ( size_t i = 0; i < GetNumUsers(); ++i ) // don't count spectators
     {
-        if ( !GetUser(i).BattleStatus().spectator )
-        {
-            players_sorted.push_back( &GetUser(i) );
-            // -- server fail? it doesnt work right.
-            //ForceTeam(GetUser(i),player_team_counter);
-            player_team_counter++;
-        }
+        if ( !GetUser(i).BattleStatus().spectator ) players.push_back( &GetUser(i) );
     }
 
-    shuffle( players_sorted );
-
-    std::map<wxString, ControlTeam> clan_teams;
-    if ( support_clans )
-    {
-        for ( size_t i = 0; i < players_sorted.size(); ++i )
-        {
-            wxString clan = TowxString(players_sorted[i]->GetClan());
-            if ( !clan.empty() )
-            {
-                clan_teams[clan].AddPlayer( players_sorted[i] );
-            }
-        }
-    };
-
-    if ( balance_type != balance_random ) std::sort( players_sorted.begin(), players_sorted.end(), PlayerRankCompareFunction );
-
-    if ( support_clans )
-    {
-        std::map<wxString, ControlTeam>::iterator clan_it = clan_teams.begin();
-        while ( clan_it != clan_teams.end() )
-        {
-            ControlTeam &clan = (*clan_it).second;
-            // if clan is too small (only 1 clan member in battle) or too big, dont count it as clan
-            if ( ( clan.players.size() < 2 ) || ( !strong_clans && ( clan.players.size() >  ( ( players_sorted.size() + control_teams.size() -1 ) / control_teams.size() ) ) ) )
-            {
-                wxLogMessage(_T("removing clan %s"),(*clan_it).first.c_str());
-                std::map<wxString, ControlTeam>::iterator next = clan_it;
-                ++next;
-                clan_teams.erase( clan_it );
-                clan_it = next;
-                continue;
-            }
-            wxLogMessage( _T("Inserting clan %s"), (*clan_it).first.c_str() );
-            std::sort( control_teams.begin(), control_teams.end() );
-            float lowestrank = control_teams[0].ranksum;
-            int rnd_k = 1; // number of alliances with rank equal to lowestrank
-            while ( size_t( rnd_k ) < control_teams.size() )
-            {
-                if ( fabs( control_teams[rnd_k].ranksum - lowestrank ) > 0.01 ) break;
-                rnd_k++;
-            }
-            wxLogMessage(_T("number of lowestrank teams with same rank=%d"), rnd_k );
-            control_teams[my_random( rnd_k )].AddTeam( clan );
-            ++clan_it;
-        }
-    }
+    shuffle( players );
 
-    for (size_t i = 0; i < players_sorted.size(); ++i )
+    std::vector<int> current( players.size(), -1 );
+    for ( size_t i = 0; i < players.size(); ++i )
     {
-        // skip clanners, those have been added already.
-        if ( clan_teams.count( TowxString(players_sorted[i]->GetClan()) ) > 0 )
-        {
-            wxLogMessage( _T("clanner already added, nick=%s"),players_sorted[i]->GetNick().c_str() );
-            continue;
-        }
-
-        // find teams with lowest ranksum
-        // insert current user into random one out of them
-        // since performance doesnt matter here, i simply sort teams,
-        // then find how many teams in beginning have lowest ranksum
-        // note that balance player ranks range from 1 to 1.1 now
-        // i.e. them are quasi equal
-        // so we're essentially adding to teams with smallest number of players,
-        // the one with smallest ranksum.
-
-        std::sort( control_teams.begin(), control_teams.end() );
-        float lowestrank = control_teams[0].ranksum;
-        int rnd_k = 1; // number of alliances with rank equal to lowestrank
-        while ( size_t( rnd_k ) < control_teams.size() )
-        {
-            if ( fabs ( control_teams[rnd_k].ranksum - lowestrank ) > 0.01 ) break;
-            rnd_k++;
-        }
-        wxLogMessage( _T("number of lowestrank teams with same rank=%d"), rnd_k );
-        control_teams[my_random( rnd_k )].AddPlayer( players_sorted[i] );
+        const int team = players[i]->BattleStatus().team;
+        if ( team < numcontrolteams ) current[i] = team;
     }
 
+    const std::vector<int> res = BalancePlayers( players, current, balance_type, support_clans, strong_clans, numcontrolteams );
 
-    for ( size_t i=0; i < control_teams.size(); ++i )
+    StatusEdit edit;
+    for ( size_t i = 0; i < players.size(); ++i )
     {
-        for ( size_t j = 0; j < control_teams[i].players.size(); ++j )
-        {
-            ASSERT_LOGIC( control_teams[i].players[j], _T("fail in Autobalance teams, NULL player") );
-			wxString msg = wxFormat( _T("setting player %s to team and ally %d") ) % control_teams[i].players[j]->GetNick() % i;
-            wxLogMessage( _T("%s"), msg.c_str() );
-            ForceTeam( *control_teams[i].players[j], control_teams[i].teamnum );
-            ForceAlly( *control_teams[i].players[j], control_teams[i].teamnum );
-        }
+        UserBattleStatus& bs = players[i]->BattleStatus();
+        if ( bs.team == res[i] && bs.ally == res[i] ) continue;
+        wxString msg = wxFormat( _T("setting player %s to team and ally %d") ) % players[i]->GetNick() % res[i];
+        wxLogMessage( _T("%s"), msg.c_str() );
+        edit.SetTeam( *players[i], res[i] );
+        edit.SetAlly( *players[i], res[i] );
     }
+    ApplyStatusEdit( edit );
 }
 
 void Battle::OnUnitsyncReloaded( wxEvent& /*data*/ )
@@ -1174,6 +1085,20 @@ void Battle::OnUnitsyncReloaded( wxEvent& /*data*/ )
 	if ( m_is_self_in ) SendMyBattleStatus();
 }
 
+void Battle::OnContentAdded( wxEvent& data )
+{
+	std::vector<ContentRegistry::Entry> added;
+	const bool complete = contentRegistry().GetAddedSince( m_content_serial, added );
+	bool engine_added = false;
+	for ( size_t i = 0; i < added.size(); i++ ) {
+		if ( added[i].type == ContentRegistry::CT_ENGINE ) engine_added = true;
+	}
+	if ( !complete || engine_added ||
+	     ContentRegistry::Contains( added, ContentRegistry::CT_MAP, GetHostMapName() ) ||
+	     ContentRegistry::Contains( added, ContentRegistry::CT_GAME, GetHostModName() ) )
+		OnUnitsyncReloaded( data );
+}
+
 void Battle::ShouldAutoUnspec()
 {
 	if ( m_auto_unspec && !IsLocked() && GetMe().BattleStatus().spectator )
@@ -3,7 +3,9 @@
 #ifndef SPRINGLOBBY_HEADERGUARD_BATTLE_H
 #define SPRINGLOBBY_HEADERGUARD_BATTLE_H
 
+#include <map>
 #include <set>
+#include <vector>
 
 #include "autohost.h"
 #include "utils/globalevents.h"
@@ -66,6 +68,39 @@ public:
 	virtual void ForceAlly( User& user, int ally );
 	virtual void ForceColour( User& user, const LSL::lslColor& col );
 	virtual void ForceSpectator( User& user, bool spectator );
+
+	/** Collects forced status changes of several users, see ApplyStatusEdit().
+	 * A later change of the same field replaces the earlier one, changes which
+	 * end up at the current value are dropped.
+	 */
+	class StatusEdit
+	{
+	public:
+		void SetTeam( User& user, int team );
+		void SetAlly( User& user, int ally );
+		void SetColour( User& user, const LSL::lslColor& col );
+		void SetSpectator( User& user, bool spectator );
+		bool IsEmpty() const { return m_users.empty(); }
+
+	private:
+		friend class Battle;
+		enum {
+			EDIT_TEAM = 1,
+			EDIT_ALLY = 2,
+			EDIT_COLOUR = 4,
+			EDIT_SPECTATOR = 8
+		};
+		struct Change {
+			Change(): fields( 0 ) {}
+			unsigned int fields; //! EDIT_* of the changed fields
+			UserBattleStatus status; //! the wanted values of the changed fields
+		};
+		Change& Get( User& user );
+		std::vector<User*> m_users; //! in the order of their first change
+		std::map<User*, Change> m_changes;
+	};
+	//! send the changes of @p edit, one status update per bot or for me, the forced fields for others
+	virtual void ApplyStatusEdit( const StatusEdit& edit );
 //    virtual void BattleKickPlayer( User& user );
 	virtual void SetHandicap( User& user, int handicap);
 
@@ -113,6 +148,8 @@ public:
 	virtual void SetInGame( bool ingame );
 
 	virtual void OnUnitsyncReloaded( wxEvent& data );
+	//! resends the sync state if the battle's map, game or an engine was added
+	virtual void OnContentAdded( wxEvent& data );
 
 
 	virtual void SetAutoUnspec(bool value);
@@ -137,6 +174,7 @@ private:
 
 	const int m_id;
 	wxTimer* m_timer;
+	unsigned int m_content_serial; //! see ContentRegistry::GetAddedSince
 
 	DECLARE_EVENT_TABLE()
 };
@@ -0,0 +1,202 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "contentregistry.h"
+
+#include <wx/log.h>
+#include <wx/stopwatch.h>
+#include <lslunitsync/unitsync.h>
+#include <lslutils/globalsmanager.h>
+
+#include "utils/globalevents.h"
+
+ContentRegistry::ContentRegistry():
+	m_serial(0)
+{
+}
+
+void ContentRegistry::Added( ContentType type, const std::string& name )
+{
+	wxMutexLocker lock( m_mutex );
+	Entry entry;
+	entry.type = type;
+	entry.name = name;
+	entry.serial = 0;
+	m_pending.push_back( entry );
+}
+
+bool ContentRegistry::HasPending()
+{
+	wxMutexLocker lock( m_mutex );
+	return !m_pending.empty();
+}
+
+size_t ContentRegistry::Flush()
+{
+	wxMutexLocker flushlock( m_flush_mutex );
+	std::vector<Entry> pending;
+	{
+		wxMutexLocker lock( m_mutex );
+		pending.swap( m_pending );
+	}
+	if ( pending.empty() ) return 0;
+
+	size_t archives = 0;
+	for ( size_t i = 0; i < pending.size(); i++ ) {
+		if ( pending[i].type != CT_ENGINE ) archives++;
+	}
+	// engines are already in the version list, only archives need a rescan
+	if ( archives > 0 ) {
+		wxStopWatch watch;
+		LSL::usync().ReloadUnitSyncLib();
+		// prefetch map data after a download as well
+		for ( size_t i = 0; i < pending.size(); i++ ) {
+			if ( pending[i].type == CT_MAP ) LSL::usync().PrefetchMap( pending[i].name ); //FIXME: do the same for games, too
+		}
+		wxLogMessage( _T("rescanned content for %u new archives in %ld ms"), (unsigned int)archives, watch.Time() );
+
+		const IndexPtr current = GetIndex();
+		if ( current ) {
+			// downloads only add archives, so the new ones are enough
+			std::shared_ptr<Index> index( new Index( *current ) );
+			for ( size_t i = 0; i < pending.size(); i++ ) {
+				if ( pending[i].type == CT_MAP ) {
+					if ( LSL::usync().MapExists( pending[i].name ) ) AddMap( *index, pending[i].name );
+				} else if ( pending[i].type == CT_GAME && LSL::usync().ModExists( pending[i].name ) ) {
+					AddGame( *index, pending[i].name );
+				}
+			}
+			SetIndex( index );
+		} else {
+			BuildIndex();
+		}
+	}
+
+	{
+		wxMutexLocker lock( m_mutex );
+		for ( size_t i = 0; i < pending.size(); i++ ) {
+			pending[i].serial = ++m_serial;
+			m_added.push_back( pending[i] );
+		}
+		// listeners that fall this far behind reload everything
+		if ( m_added.size() > MAX_ADDED ) {
+			m_added.erase( m_added.begin(), m_added.end() - MAX_ADDED );
+		}
+	}
+	GlobalEvent::Send( GlobalEvent::OnContentAdded );
+	return pending.size();
+}
+
+bool ContentRegistry::GetAddedSince( unsigned int& serial, std::vector<Entry>& entries )
+{
+	wxMutexLocker lock( m_mutex );
+	entries.clear();
+	for ( size_t i = 0; i < m_added.size(); i++ ) {
+		if ( m_added[i].serial > serial ) entries.push_back( m_added[i] );
+	}
+	const unsigned int oldest = m_added.empty() ? m_serial + 1 : m_added.front().serial;
+	const bool complete = serial + 1 >= oldest;
+	serial = m_serial;
+	return complete;
+}
+
+unsigned int ContentRegistry::GetSerial()
+{
+	wxMutexLocker lock( m_mutex );
+	return m_serial;
+}
+
+bool ContentRegistry::Contains( const std::vector<Entry>& entries, ContentType type, const std::string& name )
+{
+	for ( size_t i = 0; i < entries.size(); i++ ) {
+		if ( entries[i].type == type && entries[i].name == name ) return true;
+	}
+	return false;
+}
+
+void ContentRegistry::ReloadUnitsync()
+{
+	wxMutexLocker flushlock( m_flush_mutex );
+	LSL::usync().ReloadUnitSyncLib();
+	BuildIndex();
+}
+
+void ContentRegistry::Rebuild()
+{
+	wxMutexLocker flushlock( m_flush_mutex );
+	BuildIndex();
+}
+
+void ContentRegistry::BuildIndex()
+{
+	if ( !LSL::usync().IsLoaded() ) {
+		Invalidate();
+		return;
+	}
+	wxStopWatch watch;
+	std::shared_ptr<Index> index( new Index() );
+	const std::vector<std::string> maps = LSL::usync().GetMapList();
+	for ( size_t i = 0; i < maps.size(); i++ ) AddMap( *index, maps[i] );
+	const std::vector<std::string> games = LSL::usync().GetModList();
+	for ( size_t i = 0; i < games.size(); i++ ) AddGame( *index, games[i] );
+	SetIndex( index );
+	wxLogDebug( _T("indexed %u maps and %u games in %ld ms"), (unsigned int)maps.size(), (unsigned int)games.size(), watch.Time() );
+}
+
+void ContentRegistry::Invalidate()
+{
+	SetIndex( IndexPtr() );
+}
+
+bool ContentRegistry::MapExists( const std::string& name, const std::string& hash ) const
+{
+	const IndexPtr index = GetIndex();
+	if ( !index ) return LSL::usync().MapExists( name, hash );
+	if ( hash.empty() ) return index->maps.count( name ) > 0;
+	return index->map_hashes.count( Key( name, hash ) ) > 0;
+}
+
+bool ContentRegistry::GameExists( const std::string& name, const std::string& hash ) const
+{
+	const IndexPtr index = GetIndex();
+	if ( !index ) return LSL::usync().ModExists( name, hash );
+	if ( hash.empty() ) return index->games.count( name ) > 0;
+	return index->game_hashes.count( Key( name, hash ) ) > 0;
+}
+
+std::string ContentRegistry::Key( const std::string& name, const std::string& hash )
+{
+	// archive names never contain a NUL
+	std::string key( name );
+	key += '\0';
+	key += hash;
+	return key;
+}
+
+void ContentRegistry::AddMap( Index& index, const std::string& name )
+{
+	index.maps.insert( name );
+	index.map_hashes.insert( Key( name, LSL::usync().GetMap( name ).hash ) );
+}
+
+void ContentRegistry::AddGame( Index& index, const std::string& name )
+{
+	index.games.insert( name );
+	index.game_hashes.insert( Key( name, LSL::usync().GetMod( name ).hash ) );
+}
+
+ContentRegistry::IndexPtr ContentRegistry::GetIndex() const
+{
+	return std::atomic_load( &m_index );
+}
+
+void ContentRegistry::SetIndex( const IndexPtr& index )
+{
+	std::atomic_store( &m_index, index );
+}
+
+ContentRegistry& contentRegistry()
+{
+	static LSL::Util::LineInfo<ContentRegistry> m( AT );
+	static LSL::Util::GlobalObjectHolder<ContentRegistry, LSL::Util::LineInfo<ContentRegistry> > s_registry( m );
+	return s_registry;
+}
@@ -0,0 +1,111 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_HEADERGUARD_CONTENTREGISTRY_H
+#define SPRINGLOBBY_HEADERGUARD_CONTENTREGISTRY_H
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include <wx/thread.h>
+
+/** Keeps track of content (maps, games, engines) that was added while the lobby runs.
+ *
+ * Downloads register their archives here. Unitsync is rescanned once for all
+ * archives added since the last rescan, then GlobalEvent::OnContentAdded is sent.
+ * Engines are registered by version and need no rescan.
+ * Listeners fetch the new entries with GetAddedSince() and update only what is
+ * affected, instead of rebuilding everything as on OnUnitsyncReloaded.
+ *
+ * It also keeps an index of the installed maps and games, so MapExists() and
+ * GameExists() are hash lookups instead of unitsync calls. The index is rebuilt
+ * by ReloadUnitsync() and extended by Flush(); readers get an immutable snapshot
+ * and never wait for a rebuild. While no index was built they ask unitsync.
+ *
+ * This class is thread-safe.
+ */
+class ContentRegistry
+{
+public:
+	enum ContentType {
+		CT_MAP,
+		CT_GAME,
+		CT_ENGINE //! name is the engine version
+	};
+
+	struct Entry {
+		ContentType type;
+		std::string name;
+		unsigned int serial; //! increases with every added entry
+	};
+
+	ContentRegistry();
+
+	//! register a downloaded archive or extracted engine, it becomes visible after the next Flush()
+	void Added( ContentType type, const std::string& name );
+
+	//! true if archives were added since the last Flush()
+	bool HasPending();
+
+	/** Rescan unitsync once for all pending archives and notify listeners.
+	 * Must not be called from the main thread, the rescan takes a while.
+	 * @return number of archives that became available
+	 */
+	size_t Flush();
+
+	/** Get the entries added after @p serial into @p entries, @p serial is set to the newest one.
+	 * Only the last MAX_ADDED entries are kept. Returns false if some of the
+	 * requested ones were dropped already, the caller has to reload everything then.
+	 */
+	bool GetAddedSince( unsigned int& serial, std::vector<Entry>& entries );
+	//! serial of the newest entry, listeners start with it when they load their lists
+	unsigned int GetSerial();
+
+	//! true if @p entries contains content @p name of type @p type
+	static bool Contains( const std::vector<Entry>& entries, ContentType type, const std::string& name );
+
+	//! reload unitsync and rebuild the index, use instead of LSL::usync().ReloadUnitSyncLib()
+	void ReloadUnitsync();
+	//! rebuild the index from the currently loaded unitsync
+	void Rebuild();
+	//! drop the index after unitsync was unloaded or replaced, queries go to unitsync until the next Rebuild()
+	void Invalidate();
+
+	//! true if map @p name is installed, with checksum @p hash if it isn't empty. Callable from any thread.
+	bool MapExists( const std::string& name, const std::string& hash = "" ) const;
+	//! true if game @p name is installed, with checksum @p hash if it isn't empty. Callable from any thread.
+	bool GameExists( const std::string& name, const std::string& hash = "" ) const;
+
+private:
+	//! an immutable set of installed content, replaced as a whole
+	struct Index {
+		std::unordered_set<std::string> maps;
+		std::unordered_set<std::string> games;
+		//! name and checksum, see Key()
+		std::unordered_set<std::string> map_hashes;
+		std::unordered_set<std::string> game_hashes;
+	};
+	typedef std::shared_ptr<const Index> IndexPtr;
+
+	//! build the index from scratch, m_flush_mutex must be held
+	void BuildIndex();
+	static std::string Key( const std::string& name, const std::string& hash );
+	static void AddMap( Index& index, const std::string& name );
+	static void AddGame( Index& index, const std::string& name );
+	IndexPtr GetIndex() const;
+	void SetIndex( const IndexPtr& index );
+
+	IndexPtr m_index;
+
+	wxMutex m_mutex;
+	//! serializes rescans and index updates, held without m_mutex so readers are not blocked
+	wxMutex m_flush_mutex;
+	std::vector<Entry> m_pending;
+	static const size_t MAX_ADDED = 256;
+	std::vector<Entry> m_added; //! the last MAX_ADDED entries
+	unsigned int m_serial;
+};
+
+ContentRegistry& contentRegistry();
+
+#endif // SPRINGLOBBY_HEADERGUARD_CONTENTREGISTRY_H
@@ -25,7 +25,18 @@ ObserverDownloadInfo::ObserverDownloadInfo(IDownload* dl):
 	}
 }
 
-DownloadsObserver::DownloadsObserver()
+DownloadSourceStats::DownloadSourceStats():
+	searches(0),
+	search_time(0),
+	transfers(0),
+	transfer_bytes(0),
+	transfer_time(0)
+{
+}
+
+DownloadsObserver::DownloadsObserver():
+	m_queued_searches(0),
+	m_queued_transfers(0)
 {
 }
 
@@ -111,3 +122,40 @@ bool DownloadsObserver::IsEmpty()
 {
 	return m_dl_list.empty();
 }
+
+void DownloadsObserver::SetQueueDepth(int searches, int transfers)
+{
+    wxMutexLocker lock(mutex);
+    m_queued_searches=searches;
+    m_queued_transfers=transfers;
+}
+
+void DownloadsObserver::GetQueueDepth(int& searches, int& transfers)
+{
+    wxMutexLocker lock(mutex);
+    searches=m_queued_searches;
+    transfers=m_queued_transfers;
+}
+
+void DownloadsObserver::AddSearch(const std::string& source, long time)
+{
+    wxMutexLocker lock(mutex);
+    DownloadSourceStats& stats=m_source_stats[source];
+    stats.searches++;
+    stats.search_time+=time;
+}
+
+void DownloadsObserver::AddTransfer(const std::string& source, double bytes, long time)
+{
+    wxMutexLocker lock(mutex);
+    DownloadSourceStats& stats=m_source_stats[source];
+    stats.transfers++;
+    stats.transfer_bytes+=bytes;
+    stats.transfer_time+=time;
+}
+
+void DownloadsObserver::GetSourceStats(std::map<std::string, DownloadSourceStats>& stats)
+{
+    wxMutexLocker lock(mutex);
+    stats=m_source_stats;
+}
@@ -4,6 +4,7 @@
 #define DOWNLOADSOBSERVER_H
 #include <list>
 #include <map>
+#include <string>
 #include <wx/thread.h>
 #include <wx/string.h>
 #include "lib/src/Downloader/Download.h"
@@ -42,6 +43,25 @@ class ObserverDownloadInfo
     friend class DownloadsObserver;
 };
 
+//! Statistics of one download source (rapid, http, plasma)
+struct DownloadSourceStats
+{
+    DownloadSourceStats();
+
+    //! Finished searches and their summed latency in ms
+    unsigned long searches;
+    long search_time;
+
+    //! Finished transfers, their size in bytes and summed duration in ms
+    unsigned long transfers;
+    double transfer_bytes;
+    long transfer_time;
+
+    double GetAverageSearchLatency() const { return searches > 0 ? double(search_time) / searches : 0.0; }
+    //! Bytes per second
+    double GetThroughput() const { return transfer_time > 0 ? transfer_bytes * 1000.0 / transfer_time : 0.0; }
+};
+
 //! DownloadsObserver collect and control information about downloads
 //! This class is thread-safe
 class DownloadsObserver: public IDownloadsObserver
@@ -68,6 +88,17 @@ class DownloadsObserver: public IDownloadsObserver
         void ClearFinished();
 
 		bool IsEmpty();
+
+        //! Number of searches and transfers waiting or running in PrDownloader
+        void SetQueueDepth(int searches, int transfers);
+        void GetQueueDepth(int& searches, int& transfers);
+
+        //! Record a finished search / transfer of a source
+        void AddSearch(const std::string& source, long time);
+        void AddTransfer(const std::string& source, double bytes, long time);
+
+        //! Fill out map with statistics per source
+        void GetSourceStats(std::map<std::string, DownloadSourceStats>& stats);
     private:
 
         //! Creatre infromation about download
@@ -79,6 +110,10 @@ class DownloadsObserver: public IDownloadsObserver
         //! List with finished downloads
         std::list<ObserverDownloadInfo> m_finished_list;
 
+        int m_queued_searches;
+        int m_queued_transfers;
+        std::map<std::string, DownloadSourceStats> m_source_stats;
+
         //! Mutex fir functions Add, Remove, GetList, GetMap
         wxMutex mutex;
 };
@@ -12,9 +12,16 @@
 #include "utils/slpaths.h"
 #include "gui/mainwindow.h"
 #include "downloadsobserver.h"
+#include "contentregistry.h"
+#include <algorithm>
+#include <atomic>
+#include <ctime>
 #include <list>
+#include <memory>
 
 #include <wx/log.h>
+#include <wx/stopwatch.h>
+#include <lslutils/conversion.h>
 #include <lslunitsync/unitsync.h>
 #include <lslutils/thread.h>
 #include <settings.h>
@@ -23,6 +30,7 @@
 
 SLCONFIG("/Spring/PortableDownload", false, "true to download portable versions of spring, if false cache/settings/etc are shared (bogous!)");
 SLCONFIG("/Spring/RapidMasterUrl", "http://repos.springrts.com/repos.gz", "master url for rapid downloads");
+SLCONFIG("/Downloader/MaxTransfersPerHost", 2L, "downloads running at the same time against one host, over all sources");
 
 std::string PrDownloader::GetEngineCat()
 {
@@ -37,12 +45,73 @@ std::string PrDownloader::GetEngineCat()
 #endif
 }
 
+//! unitsync reloads and archive extraction must not run from several transfer threads at once
+static wxMutex s_finish_mutex;
+
+//! host part of @p url, the url itself if it has none
+static std::string GetHost(const std::string& url)
+{
+	const size_t scheme = url.find("://");
+	const size_t begin = (scheme == std::string::npos) ? 0 : scheme + 3;
+	const size_t end = url.find('/', begin);
+	return url.substr(begin, (end == std::string::npos) ? std::string::npos : end - begin);
+}
+
+//! limits the downloads running against one host, sources sharing mirrors count together
+class HostLimiter
+{
+public:
+	HostLimiter()
+		: m_cond(m_mutex)
+	{}
+
+	//! blocks until every host in @p hosts has a free slot and takes them all at once
+	void Acquire(const std::set<std::string>& hosts)
+	{
+		const long limit = std::max(1l, cfg().ReadLong(_T("/Downloader/MaxTransfersPerHost")));
+		wxMutexLocker lock(m_mutex);
+		while (!HasSlots(hosts, limit)) {
+			m_cond.Wait();
+		}
+		for (std::set<std::string>::const_iterator it = hosts.begin(); it != hosts.end(); ++it) {
+			m_running[*it]++;
+		}
+	}
+
+	void Release(const std::set<std::string>& hosts)
+	{
+		wxMutexLocker lock(m_mutex);
+		for (std::set<std::string>::const_iterator it = hosts.begin(); it != hosts.end(); ++it) {
+			if (--m_running[*it] <= 0) m_running.erase(*it);
+		}
+		m_cond.Broadcast();
+	}
+
+private:
+	bool HasSlots(const std::set<std::string>& hosts, long limit) const
+	{
+		for (std::set<std::string>::const_iterator it = hosts.begin(); it != hosts.end(); ++it) {
+			std::map<std::string, long>::const_iterator running = m_running.find(*it);
+			if (running != m_running.end() && running->second >= limit) return false;
+		}
+		return true;
+	}
+
+	wxMutex m_mutex;
+	wxCondition m_cond;
+	std::map<std::string, long> m_running;
+};
+
+static HostLimiter s_host_limiter;
+
 class DownloadItem : public LSL::WorkItem
 {
 public:
-	DownloadItem( std::list<IDownload*> item, IDownloader* loader)
+	DownloadItem( std::list<IDownload*> item, IDownloader* loader, int priority, const std::string& request = "")
 		: m_item(item)
 		, m_loader(loader)
+		, m_priority(priority)
+		, m_request(request)
 	{}
 
 	void Run() {
@@ -51,9 +120,29 @@ public:
 			//we create this in avance cause m_item gets freed
 			wxString d(_("Download complete: "));
 			d += TowxString(m_item.front()->name);
-			m_loader->download( m_item, sett().GetHTTPMaxParallelDownloads() );
+			double bytes = 0;
 			std::list<IDownload*>::iterator it;
-			bool reload = false;
+			for( it = m_item.begin(); it!=m_item.end(); ++it) {
+				if ((*it)->size > 0) bytes += (*it)->size;
+			}
+			// items without mirrors (rapid) fetch from the host of their source
+			std::set<std::string> hosts;
+			for( it = m_item.begin(); it!=m_item.end(); ++it) {
+				for (const std::string& url: (*it)->mirrors) {
+					hosts.insert(GetHost(url));
+				}
+			}
+			if (hosts.empty()) hosts.insert(prDownloader().GetSourceName(m_loader));
+			s_host_limiter.Acquire(hosts);
+			wxStopWatch watch;
+			{
+				wxMutexLocker loaderlock(prDownloader().GetLoaderMutex(m_loader));
+				m_loader->download( m_item, sett().GetHTTPMaxParallelDownloads() );
+			}
+			downloadsObserver().AddTransfer(prDownloader().GetSourceName(m_loader), bytes, watch.Time());
+			s_host_limiter.Release(hosts);
+
+			wxMutexLocker lock(s_finish_mutex);
 			bool lobbydl = false;
 			for( it = m_item.begin(); it!=m_item.end(); ++it) {
 				IDownload* dl = *it;
@@ -65,6 +154,7 @@ public:
 					fileSystem->extractEngine(dl->name, dl->version);
 					SlPaths::RefreshSpringVersionList(); //FIXME: maybe not thread-save!
 					SlPaths::SetUsedSpringIndex(dl->version);
+					contentRegistry().Added(ContentRegistry::CT_ENGINE, dl->version);
 					break;
 				}
 				case IDownload::CAT_LOBBYCLIENTS:
@@ -72,84 +162,163 @@ public:
 					fileSystem->extract(dl->name, SlPaths::GetUpdateDir(), true);
 					break;
 				case IDownload::CAT_MAPS:
+					contentRegistry().Added(ContentRegistry::CT_MAP, dl->name);
+					break;
 				case IDownload::CAT_GAMES:
-					reload = true;
+					contentRegistry().Added(ContentRegistry::CT_GAME, dl->name);
 					break;
 				default:
 					break;;
 				}
 			}
-			m_loader->freeResult( m_item );
-			UiEvents::ScopedStatusMessage msgcomplete(d, 0);
-			if (reload) {
-				LSL::usync().ReloadUnitSyncLib();
-				// prefetch map data after a download as well
-				for( it = m_item.begin(); it!=m_item.end(); ++it) {
-					IDownload* dl = *it;
-					switch(dl->cat) {
-						case IDownload::CAT_MAPS: {
-							LSL::usync().PrefetchMap(dl->name); //FIXME: do the same for games, too
-						}
-						default:
-							continue;
-					}
-				}
-
-				//notify about finished download
-				GlobalEvent::Send(GlobalEvent::OnUnitsyncReloaded);
+			{
+				wxMutexLocker loaderlock(prDownloader().GetLoaderMutex(m_loader));
+				m_loader->freeResult( m_item );
 			}
+			UiEvents::ScopedStatusMessage msgcomplete(d, 0);
 			if (lobbydl) {
 				GlobalEvent::Send(GlobalEvent::OnLobbyDownloaded);
 			}
 		}
+		prDownloader().UpdateQueueStats(-1, false);
+		// rescan once when the last queued search or download finished, battle content is needed right away
+		if (m_priority >= PrDownloader::PRIO_BATTLE || prDownloader().GetQueuedWork() == 0) {
+			contentRegistry().Flush();
+		}
+		prDownloader().FinishRequest(m_request);
 	}
 
 private:
 	std::list<IDownload*> m_item;
 	IDownloader* m_loader;
+	const int m_priority;
+	const std::string m_request;
+};
+
+//! state of one request which is searched on all of its sources at the same time
+class SearchRequest
+{
+public:
+	SearchRequest(const std::list<IDownloader*>& loaders, const std::string& request, int priority)
+		: m_loaders(loaders)
+		, m_request(request)
+		, m_priority(priority)
+		, m_dispatched(false)
+	{}
+
+	//! called from the search threads, the first source in list order that has results wins
+	void Finished(IDownloader* loader, std::list<IDownload*>& results)
+	{
+		wxMutexLocker lock(m_mutex);
+		m_done.insert(loader);
+		m_results[loader] = results;
+		if (!m_dispatched) {
+			for (std::list<IDownloader*>::const_iterator it = m_loaders.begin(); it != m_loaders.end(); ++it) {
+				if (m_done.count(*it) == 0) break; // a preferred source is still searching
+				if (!m_results[*it].empty()) {
+					prDownloader().QueueDownload(m_results[*it], *it, m_priority, m_request);
+					m_results.erase(*it);
+					m_dispatched = true;
+					break;
+				}
+			}
+		}
+		if (!m_dispatched && m_done.size() == m_loaders.size()) {
+			// nothing found
+			prDownloader().FinishRequest(m_request);
+			m_dispatched = true;
+		}
+		if (m_dispatched) {
+			for (std::map<IDownloader*, std::list<IDownload*> >::iterator it = m_results.begin(); it != m_results.end(); ++it) {
+				if (it->second.empty()) continue;
+				wxMutexLocker loaderlock(prDownloader().GetLoaderMutex(it->first));
+				it->first->freeResult(it->second);
+			}
+			m_results.clear();
+		}
+	}
+
+private:
+	const std::list<IDownloader*> m_loaders;
+	const std::string m_request;
+	const int m_priority;
+	wxMutex m_mutex;
+	std::set<IDownloader*> m_done;
+	std::map<IDownloader*, std::list<IDownload*> > m_results;
+	bool m_dispatched;
 };
 
 class SearchItem : public LSL::WorkItem
 {
 public:
-	SearchItem(std::list<IDownloader*> loaders, std::string name, IDownload::category cat);
+	SearchItem(std::shared_ptr<SearchRequest> request, IDownloader* loader, std::string name, IDownload::category cat);
 	void Run();
 
 private:
-	const std::list<IDownloader*> m_loaders;
+	std::shared_ptr<SearchRequest> m_request;
+	IDownloader* m_loader;
 	const std::string m_name;
 	const IDownload::category m_cat;
-	int m_result_size;
 };
 
-SearchItem::SearchItem(std::list<IDownloader*> loaders, const std::string name, IDownload::category cat)
-	: m_loaders(loaders)
+SearchItem::SearchItem(std::shared_ptr<SearchRequest> request, IDownloader* loader, const std::string name, IDownload::category cat)
+	: m_request(request)
+	, m_loader(loader)
 	, m_name(name)
 	, m_cat(cat)
-	, m_result_size(0)
 {}
 
-void SearchItem::Run()
+//! seconds after which the rapid repository list is downloaded again
+static const time_t RAPID_REPO_REFRESH = 10 * 60;
+//! time of the last forced rapid repository update, 0 to force one with the next search
+static std::atomic<time_t> s_rapid_repo_updated(0);
+//! master url set by UpdateSettings, handed to rapid on its search thread
+static wxMutex s_rapid_master_mutex;
+static std::string s_rapid_master_url;
+
+/** rapid's forceupdate only invalidates its cached repositories for the next search,
+ * so it is re-armed when the cache is older than RAPID_REPO_REFRESH.
+ * Must be called with the loader mutex of rapid held.
+ */
+static void RefreshRapidRepos()
 {
+	const time_t now = std::time(NULL);
+	if (now - s_rapid_repo_updated.load() < RAPID_REPO_REFRESH) {
+		return;
+	}
+	s_rapid_repo_updated = now;
+	{
+		wxMutexLocker lock(s_rapid_master_mutex);
+		rapidDownload->setOption("masterurl", s_rapid_master_url);
+	}
 	rapidDownload->setOption("forceupdate", "");
+}
+
+void SearchItem::Run()
+{
 	std::list<IDownload*> results;
-	std::list<IDownloader*>::const_iterator it = m_loaders.begin();
-	for( ; it != m_loaders.end(); ++it ) {
-		(*it)->search(results, m_name, m_cat);
-		if (!results.empty()) {
-			DownloadItem* dl_item = new DownloadItem(results, *it);
-			prDownloader().m_dl_thread->DoWork(dl_item);
-			m_result_size = results.size();
-			return;
+	wxStopWatch watch;
+	{
+		wxMutexLocker loaderlock(prDownloader().GetLoaderMutex(m_loader));
+		if (m_loader == rapidDownload) {
+			RefreshRapidRepos();
 		}
+		m_loader->search(results, m_name, m_cat);
+	}
+	downloadsObserver().AddSearch(prDownloader().GetSourceName(m_loader), watch.Time());
+	m_request->Finished(m_loader, results);
+	prDownloader().UpdateQueueStats(-1, true);
+	// downloads that finished while this search ran waited for it
+	if (prDownloader().GetQueuedWork() == 0) {
+		contentRegistry().Flush();
 	}
-	return;
 }
 
 
 PrDownloader::PrDownloader():
 	wxEvtHandler(),
-	m_dl_thread(new LSL::WorkerThread())
+	m_queued_searches(0),
+	m_queued_downloads(0)
 {
 	IDownloader::Initialize(&downloadsObserver());
 	UpdateSettings();
@@ -158,13 +327,33 @@ PrDownloader::PrDownloader():
 	m_game_loaders.push_back(plasmaDownload);
 	m_map_loaders.push_back(httpDownload);
 	m_map_loaders.push_back(plasmaDownload);
+	m_source_names[rapidDownload] = "rapid";
+	m_source_names[httpDownload] = "http";
+	m_source_names[plasmaDownload] = "plasma";
+	for (std::map<IDownloader*, std::string>::const_iterator it = m_source_names.begin(); it != m_source_names.end(); ++it) {
+		m_loader_mutex[it->first] = new wxMutex();
+		m_search_threads[it->first] = new LSL::WorkerThread();
+		m_dl_threads[it->first] = new LSL::WorkerThread();
+	}
 	ConnectGlobalEvent(this, GlobalEvent::OnSpringStarted, wxObjectEventFunction(&PrDownloader::OnSpringStarted));
 	ConnectGlobalEvent(this, GlobalEvent::OnSpringTerminated, wxObjectEventFunction(&PrDownloader::OnSpringTerminated));
 }
 
 PrDownloader::~PrDownloader()
 {
-	delete m_dl_thread;
+	// searches queue downloads, so stop them first
+	for (std::map<IDownloader*, LSL::WorkerThread*>::iterator it = m_search_threads.begin(); it != m_search_threads.end(); ++it) {
+		delete it->second;
+	}
+	m_search_threads.clear();
+	for (std::map<IDownloader*, LSL::WorkerThread*>::iterator it = m_dl_threads.begin(); it != m_dl_threads.end(); ++it) {
+		delete it->second;
+	}
+	m_dl_threads.clear();
+	for (std::map<IDownloader*, wxMutex*>::iterator it = m_loader_mutex.begin(); it != m_loader_mutex.end(); ++it) {
+		delete it->second;
+	}
+	m_loader_mutex.clear();
 	IDownloader::Shutdown();
 }
 
@@ -176,27 +365,32 @@ void PrDownloader::UpdateSettings()
 {
 	fileSystem->setWritePath(SlPaths::GetDownloadDir());
 	fileSystem->setEnginePortableDownload(cfg().ReadBool(_T("/Spring/PortableDownload")));
-	rapidDownload->setOption("masterurl", STD_STRING(cfg().ReadString(_T("/Spring/RapidMasterUrl"))));
+	{
+		wxMutexLocker lock(s_rapid_master_mutex);
+		s_rapid_master_url = STD_STRING(cfg().ReadString(_T("/Spring/RapidMasterUrl")));
+	}
+	// rapid is busy on its own threads, the master url is set and fetched with the next search
+	s_rapid_repo_updated = 0;
 }
 
 void PrDownloader::RemoveTorrentByName(const std::string &/*name*/)
 {
 }
 
-int PrDownloader::GetDownload(const std::string& category, const std::string &name)
+int PrDownloader::GetDownload(const std::string& category, const std::string &name, int priority)
 {
 	if (category == "map") {
-		return Get(m_map_loaders, name, IDownload::CAT_MAPS);
+		return Get(m_map_loaders, name, IDownload::CAT_MAPS, priority);
 	} else if (category == "game") {
-		return Get(m_game_loaders, name, IDownload::CAT_GAMES);
+		return Get(m_game_loaders, name, IDownload::CAT_GAMES, priority);
 	} else if (category == "engine_linux") {
-		return Get(m_map_loaders, name, IDownload::CAT_ENGINE_LINUX);
+		return Get(m_map_loaders, name, IDownload::CAT_ENGINE_LINUX, priority);
 	} else if (category == "engine_linux64") {
-		return Get(m_map_loaders, name, IDownload::CAT_ENGINE_LINUX64);
+		return Get(m_map_loaders, name, IDownload::CAT_ENGINE_LINUX64, priority);
 	} else if (category == "engine_windows") {
-		return Get(m_map_loaders, name, IDownload::CAT_ENGINE_WINDOWS);
+		return Get(m_map_loaders, name, IDownload::CAT_ENGINE_WINDOWS, priority);
 	} else if (category == "engine_macosx") {
-		return Get(m_map_loaders, name, IDownload::CAT_ENGINE_MACOSX);
+		return Get(m_map_loaders, name, IDownload::CAT_ENGINE_MACOSX, priority);
 	}
 	wxLogError(_T("Category %s not found"), category.c_str());
 	return -1;
@@ -213,8 +407,7 @@ bool PrDownloader::Download(const std::string& filename, const std::string& url)
 	dl->cat = IDownload::CAT_LOBBYCLIENTS;
 
 	results.push_back(dl);
-	DownloadItem* dl_item = new DownloadItem(results, httpDownload);
-	m_dl_thread->DoWork(dl_item);
+	QueueDownload(results, httpDownload, PRIO_NORMAL, "");
 	return true;
 }
 
@@ -229,13 +422,68 @@ void PrDownloader::OnSpringTerminated(wxCommandEvent& /*data*/)
 	//FIXME: resume downloads
 }
 
-int PrDownloader::Get(std::list<IDownloader*> loaders, const std::string &name, IDownload::category cat)
+int PrDownloader::Get(std::list<IDownloader*> loaders, const std::string &name, IDownload::category cat, int priority)
 {
-	SearchItem* searchItem = new SearchItem(loaders, name, cat);
-	m_dl_thread->DoWork(searchItem);
+	const std::string request = LSL::Util::ToString(int(cat)) + "/" + name;
+	{
+		wxMutexLocker lock(m_mutex);
+		if (!m_requests.insert(request).second) {
+			wxLogMessage(_T("%s is already being downloaded"), name.c_str());
+			return 1;
+		}
+	}
+	std::shared_ptr<SearchRequest> search(new SearchRequest(loaders, request, priority));
+	for (std::list<IDownloader*>::const_iterator it = loaders.begin(); it != loaders.end(); ++it) {
+		UpdateQueueStats(1, true);
+		m_search_threads[*it]->DoWork(new SearchItem(search, *it, name, cat), priority);
+	}
 	return 1;
 }
 
+void PrDownloader::QueueDownload(std::list<IDownload*> item, IDownloader* loader, int priority, const std::string& request)
+{
+	UpdateQueueStats(1, false);
+	m_dl_threads[loader]->DoWork(new DownloadItem(item, loader, priority, request), priority);
+}
+
+void PrDownloader::FinishRequest(const std::string& request)
+{
+	if (request.empty()) return;
+	wxMutexLocker lock(m_mutex);
+	m_requests.erase(request);
+}
+
+std::string PrDownloader::GetSourceName(IDownloader* loader) const
+{
+	std::map<IDownloader*, std::string>::const_iterator it = m_source_names.find(loader);
+	if (it == m_source_names.end()) return "unknown";
+	return it->second;
+}
+
+wxMutex& PrDownloader::GetLoaderMutex(IDownloader* loader)
+{
+	std::map<IDownloader*, wxMutex*>::const_iterator it = m_loader_mutex.find(loader);
+	assert(it != m_loader_mutex.end());
+	return *it->second;
+}
+
+int PrDownloader::GetQueuedWork()
+{
+	wxMutexLocker lock(m_mutex);
+	return m_queued_searches + m_queued_downloads;
+}
+
+void PrDownloader::UpdateQueueStats(int change, bool search)
+{
+	wxMutexLocker lock(m_mutex);
+	if (search) {
+		m_queued_searches += change;
+	} else {
+		m_queued_downloads += change;
+	}
+	downloadsObserver().SetQueueDepth(m_queued_searches, m_queued_downloads);
+}
+
 PrDownloader& prDownloader()
 {
 	static LSL::Util::LineInfo<PrDownloader> m( AT );
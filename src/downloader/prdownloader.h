@@ -6,6 +6,9 @@
 #include <string>
 #include <queue>
 #include <list>
+#include <map>
+#include <set>
+#include <wx/thread.h>
 
 #include "lib/src/Downloader/Download.h"
 #include "utils/globalevents.h"
@@ -43,14 +46,20 @@ struct DownloadInfo {
 class PrDownloader: public wxEvtHandler, public GlobalEvent
 {
 public:
+	//! higher priorities are searched and downloaded first
+	enum Priority {
+		PRIO_NORMAL = 0,
+		PRIO_BATTLE = 10 //! content needed to join or play a battle
+	};
+
 	PrDownloader();
 	~PrDownloader();
 
 	void ClearFinished();
 	void UpdateSettings();
 	void RemoveTorrentByName( const std::string& name );
-	//! returns true if name found and added to dl list
-	int GetDownload( const std::string& category, const std::string& name );
+	//! returns true if name found and added to dl list, requests already in progress are not queued again
+	int GetDownload( const std::string& category, const std::string& name, int priority = PRIO_NORMAL );
 	bool Download(const std::string& filename, const std::string& url);
 	void SetIngameStatus( bool ingame );
 	void OnSpringStarted(wxCommandEvent& data);
@@ -59,13 +68,35 @@ public:
 	static std::string GetEngineCat();
 
 private:
-	//! searches given loaders for filename and pushes fitting workitems into dl_thread
-	int Get(std::list<IDownloader*> loaders, const std::string& name, IDownload::category cat );
+	//! searches all given loaders in parallel and queues the result of the first one in list order that found something
+	int Get(std::list<IDownloader*> loaders, const std::string& name, IDownload::category cat, int priority );
+	//! queue a download on the transfer thread of its source
+	void QueueDownload( std::list<IDownload*> item, IDownloader* loader, int priority, const std::string& request );
+	//! forget a finished request so it can be downloaded again
+	void FinishRequest( const std::string& request );
+	std::string GetSourceName( IDownloader* loader ) const;
+	//! the loaders are not thread safe, every call into one has to hold its mutex
+	wxMutex& GetLoaderMutex( IDownloader* loader );
+	void UpdateQueueStats(int change, bool search);
+	//! searches and downloads waiting or running, a search can still queue a download
+	int GetQueuedWork();
+
 	std::list<IDownloader*> m_game_loaders;
 	std::list<IDownloader*> m_map_loaders;
-	LSL::WorkerThread* m_dl_thread;
+	//! one search and one transfer thread per source, so a slow source only delays its own queue
+	std::map<IDownloader*, LSL::WorkerThread*> m_search_threads;
+	std::map<IDownloader*, LSL::WorkerThread*> m_dl_threads;
+	std::map<IDownloader*, std::string> m_source_names;
+	std::map<IDownloader*, wxMutex*> m_loader_mutex; //! created in the constructor, never changed afterwards
+
+	wxMutex m_mutex;
+	std::set<std::string> m_requests; //! category + name of requests not finished yet
+	int m_queued_searches;
+	int m_queued_downloads;
 
 	friend class SearchItem;
+	friend class SearchRequest;
+	friend class DownloadItem;
 };
 
 PrDownloader& prDownloader();
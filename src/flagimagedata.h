@@ -742,3 +742,35 @@ ZW_xpm,
 0
 };
 
+// index in flag_str of each country code, see FlagHash() in flagimages.cpp
+static constexpr short flag_hash[26 * 26] = {
+-1,-1,-1,0,1,2,3,-1,4,-1,-1,5,6,7,8,-1,-1,9,10,11,12,-1,13,14,-1,15,
+16,17,-1,18,19,20,21,22,23,24,-1,-1,25,26,27,-1,-1,28,29,30,-1,31,32,-1,33,34,
+35,-1,36,37,-1,38,39,40,41,-1,42,43,44,45,46,-1,-1,47,48,-1,49,50,-1,51,52,53,
+-1,-1,-1,-1,54,-1,-1,-1,-1,55,56,-1,57,-1,58,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,59,
+-1,-1,60,-1,61,-1,62,63,-1,-1,-1,-1,-1,-1,-1,-1,-1,64,65,66,67,-1,-1,-1,-1,-1,
+-1,-1,-1,-1,-1,-1,-1,-1,69,70,71,-1,72,-1,73,-1,-1,74,-1,-1,-1,-1,-1,-1,-1,-1,
+75,76,-1,77,78,79,-1,80,81,-1,-1,82,83,84,-1,85,86,87,88,89,90,-1,91,-1,92,-1,
+-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,93,-1,94,95,-1,-1,-1,96,-1,97,98,-1,-1,-1,-1,-1,
+-1,-1,-1,99,100,-1,-1,-1,-1,-1,-1,101,102,103,104,-1,105,106,107,108,-1,-1,-1,-1,-1,-1,
+-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,109,-1,110,111,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+-1,-1,-1,-1,112,-1,113,114,115,-1,-1,-1,116,117,-1,118,-1,119,-1,-1,-1,-1,120,-1,121,122,
+123,124,125,-1,-1,-1,-1,-1,126,-1,127,-1,-1,-1,-1,-1,-1,128,129,130,131,132,-1,-1,133,-1,
+134,-1,135,136,137,-1,138,139,-1,-1,140,141,142,143,144,145,146,147,148,149,150,151,152,153,154,155,
+156,-1,157,-1,158,159,160,-1,161,-1,-1,162,-1,-1,163,164,-1,165,-1,-1,166,-1,-1,-1,-1,167,
+-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,168,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+169,-1,-1,-1,170,171,172,173,-1,-1,174,175,176,177,-1,-1,-1,178,179,180,-1,-1,181,-1,182,-1,
+183,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+-1,-1,-1,-1,184,-1,-1,-1,-1,-1,-1,-1,-1,-1,185,-1,-1,-1,186,-1,187,-1,188,-1,-1,-1,
+189,190,191,192,193,-1,194,195,196,197,198,199,200,201,202,-1,-1,203,-1,204,-1,205,-1,-1,206,207,
+-1,-1,208,209,-1,210,211,212,-1,213,214,215,216,217,218,-1,-1,219,-1,220,-1,221,222,-1,-1,223,
+224,-1,-1,-1,-1,-1,225,-1,-1,-1,-1,-1,226,-1,-1,-1,-1,-1,227,-1,-1,-1,-1,-1,228,229,
+230,-1,231,-1,232,-1,233,-1,234,-1,-1,-1,-1,235,-1,-1,-1,-1,-1,-1,236,-1,-1,-1,-1,-1,
+-1,-1,-1,-1,-1,237,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,238,-1,-1,-1,-1,-1,-1,-1,
+-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+-1,-1,-1,-1,239,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,240,-1,-1,-1,-1,-1,-1,
+241,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,242,-1,-1,-1,-1,-1,-1,-1,-1,-1,243,-1,-1,-1,
+};
+
+//! the only code with three letters
+static constexpr short flag_fam = 68;
@@ -4,39 +4,46 @@
 #include "flagimagedata.h"
 
 #include <wx/bitmap.h>
-#include <wx/imaglist.h>
-#include <wx/log.h>
 
-#include <map>
+static constexpr bool IsCodeChar( char c )
+{
+	return c >= 'A' && c <= 'Z';
+}
 
-typedef std::map<std::string, int> NameToPosMap;
-static NameToPosMap m_name_to_pos;
+//! perfect hash of two letter country codes
+static constexpr int FlagHash( char a, char b )
+{
+	return ( a - 'A' ) * 26 + ( b - 'A' );
+}
+
+static constexpr bool IsFam( const char* code )
+{
+	return code[0] == 'F' && code[1] == 'A' && code[2] == 'M' && code[3] == 0;
+}
+
+//! codes that aren't two capital letters (like "", "??", "A1" for anonymous proxies) have no flag, except "FAM"
+static constexpr int FlagIndex( const char* code )
+{
+	return ( IsCodeChar( code[0] ) && IsCodeChar( code[1] ) && code[2] == 0 ) ? flag_hash[FlagHash( code[0], code[1] )] :
+		IsFam( code ) ? flag_fam : FLAG_NONE;
+}
+
+static_assert( FlagIndex( "AD" ) == 0, "flag_hash doesn't match flag_str" );
+static_assert( FlagIndex( "XX" ) == FLAG_NONE, "XX must not have a flag" );
+static_assert( FlagIndex( "A1" ) == FLAG_NONE, "A1 must not have a flag" );
+static_assert( FlagIndex( "FAM" ) == flag_fam, "FAM must have a flag" );
 
 int GetFlagIndex( const std::string& flag )
 {
-	if (( flag.empty() ) ||
-	    (flag == "??") || // unknown
-	    (flag == "XX") || // not sure where this come from, very likely from incomplete bootstrap at login
-	    (flag == "A1") || // anonymous proxy
-	    (flag == "A2") || // satellite provider
-	    (flag == "O1"))  // other country
-		return FLAG_NONE;
-
-	NameToPosMap::const_iterator itor = m_name_to_pos.find( flag );
-	if ( itor != m_name_to_pos.end() ) return itor->second;
-
-	wxLogMessage( _T( "%s flag not found!" ), flag.c_str() );
-	return FLAG_NONE;
+	return FlagIndex( flag.c_str() );
 }
 
-int AddFlagImages( wxImageList& imgs )
+int GetFlagCount()
 {
-	int poszero = 0;
-	for ( int i = 0; flag_xpm[i]; ++i ) {
-		const int index = imgs.Add( wxBitmap( const_cast<const char**>( flag_xpm[i] ) ) );
-		if ( i == 0 ) poszero = index;
-		m_name_to_pos[flag_str[i]] = i;
-	}
-	return poszero;
+	return sizeof( flag_str ) / sizeof( flag_str[0] ) - 1;
 }
 
+wxBitmap GetFlagBitmap( int index )
+{
+	return wxBitmap( const_cast<const char**>( flag_xpm[index] ) );
+}
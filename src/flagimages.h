@@ -5,10 +5,14 @@
 
 #include <string>
 
-class wxImageList;
+class wxBitmap;
 
+//! index of the flag of a two letter country code (or "FAM"), FLAG_NONE if there is none
 int GetFlagIndex( const std::string& flag );
-int AddFlagImages( wxImageList& imgs );
+//! number of flags, indexes are 0 to GetFlagCount() - 1
+int GetFlagCount();
+//! decode the image of a flag
+wxBitmap GetFlagBitmap( int index );
 
 enum {
   FLAG_NONE = -1
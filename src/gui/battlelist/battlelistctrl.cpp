@@ -14,7 +14,6 @@
 #include "settings.h"
 #include "gui/customdialogs.h"
 #include "useractions.h"
-#include "utils/sortutil.h"
 #include "aui/auimanager.h"
 #include "utils/conversion.h"
 #include "utils/slpaths.h"
@@ -76,31 +75,59 @@ BattleListCtrl::~BattleListCtrl()
     delete m_popup;
 }
 
+BattleListCtrl::BattleRow& BattleListCtrl::GetRow( const IBattle& battle ) const
+{
+    BattleRowMap::iterator it = m_rows.find( &battle );
+    if ( it != m_rows.end() )
+        return it->second;
+
+    BattleRow& row = m_rows[&battle];
+    const BattleOptions& opts = battle.GetBattleOptions();
+    for ( int i = 0; i < COLUMN_COUNT; i++ )
+        row.image[i] = -1;
+
+    row.text[3] = TowxString(opts.description);
+    row.text[4] = TowxString(battle.GetHostMapName());
+    row.text[5] = TowxString(battle.GetHostModName());
+    row.text[6] = TowxString(opts.founder);
+    row.text[7] = wxFormat(_T("%d") ) % int(battle.GetSpectators());
+    row.text[8] = wxFormat(_T("%d") ) % (int(battle.GetNumUsers()) - int(battle.GetSpectators()));
+    row.text[9] = wxFormat(_T("%d") ) % int(battle.GetMaxPlayers());
+    row.running = -1; // formatted when painted, it changes without events
+    row.text[11] = TowxString(battle.GetEngineVersion());
+
+    row.image[0] = icons().GetBattleStatusIcon( battle );
+    try
+    {
+        row.image[1] = icons().GetFlagIcon(battle.GetFounder().GetCountry());
+    }catch(...){}
+    row.image[2] = icons().GetRankLimitIcon( battle.GetRankNeeded(), false );
+    row.image[4] = battle.MapExists("") ? icons().ICON_EXISTS : icons().ICON_NEXISTS;
+    row.image[5] = battle.ModExists("") ? icons().ICON_EXISTS : icons().ICON_NEXISTS;
+    row.image[11] = SlPaths::GetCompatibleVersion(battle.GetEngineVersion()).empty() ? icons().ICON_NEXISTS: icons().ICON_EXISTS;
+    return row;
+}
+
+void BattleListCtrl::InvalidateRow( const IBattle& battle )
+{
+    m_rows.erase( &battle );
+}
+
 wxString BattleListCtrl::GetItemText(long item, long column) const
 {
-    if ( m_data[item] == NULL )
+    if ( m_data[item] == NULL || column < 0 || column >= COLUMN_COUNT )
         return wxEmptyString;
 
     const IBattle& battle= *m_data[item];
-    const BattleOptions& opts = battle.GetBattleOptions();
-
-    switch ( column ) {
-        case 0:
-        case 1:
-        case 2:
-        default: return wxEmptyString;
-
-        case 3: return ( TowxString(opts.description)) ;
-		case 4: return ( TowxString(battle.GetHostMapName()));
-		case 5: return ( TowxString(battle.GetHostModName()));
-        case 6: return ( TowxString(opts.founder));
-		case 7: return wxFormat(_T("%d") ) % int(battle.GetSpectators());
-		case 8: return wxFormat(_T("%d") ) % (int(battle.GetNumUsers()) - int(battle.GetSpectators()));
-		case 9: return wxFormat(_T("%d") ) % int(battle.GetMaxPlayers());
-        case 10: return ( wxTimeSpan(0/*h*/,0/*m*/,
-                                     battle.GetBattleRunningTime()).Format(_T("%H:%M")) );
-		case 11: return TowxString(battle.GetEngineVersion());
+    BattleRow& row = GetRow( battle );
+    if ( column == 10 ) {
+        const long running = battle.GetBattleRunningTime();
+        if ( running / 60 != row.running ) {
+            row.running = running / 60;
+            row.text[10] = wxTimeSpan(0/*h*/,0/*m*/, running).Format(_T("%H:%M"));
+        }
     }
+    return row.text[column];
 }
 
 /*
@@ -115,29 +142,10 @@ int BattleListCtrl::GetItemImage(long item) const
 
 int BattleListCtrl::GetItemColumnImage(long item, long column) const
 {
-    if ( m_data[item] == NULL )
+    if ( m_data[item] == NULL || column < 0 || column >= COLUMN_COUNT )
         return -1;
 
-    const IBattle& battle= *m_data[item];
-
-    switch ( column ) {
-        default: return -1;
-
-        case 0: return icons().GetBattleStatusIcon( battle );
-        case 1:
-        {
-        	try
-        	{
-				return icons().GetFlagIcon(battle.GetFounder().GetCountry());
-        	}catch(...){}
-					break;
-        }
-		case 2: return icons().GetRankLimitIcon( battle.GetRankNeeded(), false );
-        case 4: return battle.MapExists("") ? icons().ICON_EXISTS : icons().ICON_NEXISTS;
-        case 5: return battle.ModExists("") ? icons().ICON_EXISTS : icons().ICON_NEXISTS;
-		case 11:return SlPaths::GetCompatibleVersion(battle.GetEngineVersion()).empty() ? icons().ICON_NEXISTS: icons().ICON_EXISTS;
-    }
-    return -1; // simply to avoid compiler warning
+    return GetRow( *m_data[item] ).image[column];
 }
 
 wxListItemAttr* BattleListCtrl::GetItemAttr(long item) const
@@ -168,6 +176,8 @@ wxListItemAttr* BattleListCtrl::GetItemAttr(long item) const
 
 void BattleListCtrl::AddBattle( IBattle& battle )
 {
+	// a new battle can reuse the address of a removed one
+	InvalidateRow( battle );
 	if (AddItem(&battle)) {
 		// change column width based on content
 		SetColumnWidth(3, wxLIST_AUTOSIZE);
@@ -182,6 +192,7 @@ void BattleListCtrl::AddBattle( IBattle& battle )
 
 void BattleListCtrl::RemoveBattle( IBattle& battle )
 {
+    InvalidateRow( battle );
     if ( RemoveItem( &battle ) )
         return;
 
@@ -192,10 +203,18 @@ void BattleListCtrl::UpdateBattle( IBattle& battle )
 {
     int index = GetIndexFromData( &battle );
 
+    InvalidateRow( battle );
+    InvalidateSortKeys( &battle );
     RefreshItem( index );
     MarkDirtySort();
 }
 
+void BattleListCtrl::Clear()
+{
+    m_rows.clear();
+    BaseType::Clear();
+}
+
 void BattleListCtrl::OnListRightClick( wxListEvent& event )
 {
     int idx = event.GetIndex();
@@ -252,91 +271,57 @@ void BattleListCtrl::Sort()
     if ( m_data.size() > 0 )
     {
         SaveSelection();
-        SLInsertionSort( m_data, m_comparator );
+        SortByKeys();
         RestoreSelection();
     }
 }
 
-int BattleListCtrl::CompareOneCrit( DataType u1, DataType u2, int col, int dir ) const
+void BattleListCtrl::BuildSortKeys( DataType battle, SortKeyVector& keys ) const
 {
-    switch ( col ) {
-        case 0: return dir * CompareStatus( u1, u2 );
-        case 1:
-        {
-					try
-					{
-					return dir * TowxString(u1->GetFounder().GetCountry()).CmpNoCase( TowxString(u2->GetFounder().GetCountry()) );
-        	 }catch(...){}
-					break;
-        }
-        case 2: return dir * compareSimple( u1->GetRankNeeded(), u2->GetRankNeeded() );
-        case 3: return dir * TowxString(u1->GetDescription()).CmpNoCase( TowxString(u2->GetDescription()) );
-		case 4: return dir * TowxString(u1->GetHostMapName()).CmpNoCase( TowxString(u2->GetHostMapName()) );
-		case 5: return dir * TowxString(u1->GetHostModName()).CmpNoCase( TowxString(u2->GetHostModName()) );
-        case 6:
-        {
-        	try
-					{
-					return dir * TowxString(u1->GetFounder().GetNick()).CmpNoCase(TowxString(u2->GetFounder().GetNick()));
-        	 }catch(...){}
-        	 break;
-        }
-        case 7: return dir * compareSimple( u1->GetSpectators(), u2->GetSpectators() );
-        case 8: return dir * ComparePlayer( u1, u2 );
-        case 9: return dir * compareSimple( u1->GetMaxPlayers(), u2->GetMaxPlayers() );
-        case 10: return dir * compareSimple( u1->GetBattleRunningTime(), u2->GetBattleRunningTime());
-		case 11: return dir * compareSimple( u1->GetEngineVersion(), u2->GetEngineVersion() );
-        default: return 0;
-    }
-    return 0; // simply to avoid compiler warning
+    keys.resize( COLUMN_COUNT );
+    keys[0].num = GetStatusRank( *battle );
+    try
+    {
+        keys[1].text = FoldSortKey( TowxString(battle->GetFounder().GetCountry()) );
+        keys[6].text = FoldSortKey( TowxString(battle->GetFounder().GetNick()) );
+    }catch(...){}
+    keys[2].num = battle->GetRankNeeded();
+    keys[3].text = FoldSortKey( TowxString(battle->GetDescription()) );
+    keys[4].text = FoldSortKey( TowxString(battle->GetHostMapName()) );
+    keys[5].text = FoldSortKey( TowxString(battle->GetHostModName()) );
+    keys[7].num = battle->GetSpectators();
+    keys[8].num = int(battle->GetNumUsers()) - int(battle->GetSpectators());
+    keys[9].num = battle->GetMaxPlayers();
+    // case sensitive
+    keys[11].text = battle->GetEngineVersion();
 }
 
-int BattleListCtrl::CompareStatus( DataType u1, DataType u2 )
+int BattleListCtrl::CompareOneCrit( DataType u1, DataType u2, int col, int dir ) const
 {
-  const IBattle& battle1 = *u1;
-  const IBattle& battle2 = *u2;
-
-  int b1 = 0, b2 = 0;
-
-  if ( battle1.GetNumActivePlayers() == 0 )
-  	b1 += 2000;
-  if ( battle2.GetNumActivePlayers() == 0 )
-  	b2 += 2000;
-  if ( battle1.GetInGame() )
-    b1 += 1000;
-  if ( battle2.GetInGame() )
-    b2 += 1000;
-  if ( battle1.IsLocked() )
-    b1 += 100;
-  if ( battle2.IsLocked() )
-    b2 += 100;
-  if ( battle1.IsPassworded() )
-    b1 += 50;
-  if ( battle2.IsPassworded() )
-    b2 += 50;
-  if ( battle1.IsFull() )
-    b1 += 25;
-  if ( battle2.IsFull() )
-    b2 += 25;
-
-  // inverse the order
-  if ( b1 < b2 )
-      return -1;
-  if ( b1 > b2 )
-      return 1;
-
-  return 0;
+    // changes without an event
+    if ( col == 10 )
+        return dir * compareSimple( u1->GetBattleRunningTime(), u2->GetBattleRunningTime());
+    if ( col < 0 || col >= COLUMN_COUNT )
+        return 0;
+    return dir * compareSortKey( GetSortKeys( u1 )[col], GetSortKeys( u2 )[col] );
 }
 
-
-int BattleListCtrl::ComparePlayer( DataType u1, DataType u2 )
+int BattleListCtrl::GetStatusRank( const IBattle& battle )
 {
-    const IBattle& battle1 = *u1;
-    const IBattle& battle2 = *u2;
-
-    int n1 = battle1.GetNumUsers() - battle1.GetSpectators();
-    int n2 = battle2.GetNumUsers() - battle2.GetSpectators();
-    return compareSimple( n1, n2 );
+  int rank = 0;
+
+  if ( battle.GetNumActivePlayers() == 0 )
+  	rank += 2000;
+  if ( battle.GetInGame() )
+    rank += 1000;
+  if ( battle.IsLocked() )
+    rank += 100;
+  if ( battle.IsPassworded() )
+    rank += 50;
+  if ( battle.IsFull() )
+    rank += 25;
+
+  return rank;
 }
 
 void BattleListCtrl::SetTipWindowText( const long item_hit, const wxPoint& position)
@@ -3,6 +3,8 @@
 #ifndef SPRINGLOBBY_HEADERGUARD_BATTLELISTCTRL_H
 #define SPRINGLOBBY_HEADERGUARD_BATTLELISTCTRL_H
 
+#include <map>
+
 #include "battlelistfilter.h"
 #include "battlelist.h"
 
@@ -25,6 +27,7 @@ class BattleListCtrl : public CustomVirtListCtrl< IBattle *, BattleListCtrl>
     void AddBattle( IBattle& battle );
     void RemoveBattle( IBattle& battle );
     void UpdateBattle( IBattle& battle );
+    virtual void Clear();
 
 
     void OnListRightClick( wxListEvent& event );
@@ -49,14 +52,33 @@ private:
     void OnDLMod( wxCommandEvent& event );
     void OnDLEngine( wxCommandEvent& event );
 
-    static int CompareStatus( DataType u1, DataType u2 );
-    static int ComparePlayer( DataType u1, DataType u2 );
+    friend class CustomVirtListCtrl< IBattle *, BattleListCtrl>;
+    static int GetStatusRank( const IBattle& battle );
+    void BuildSortKeys( DataType battle, SortKeyVector& keys ) const;
 
 	int CompareOneCrit( DataType u1, DataType u2, int col, int dir ) const;
     int GetIndexFromData( const DataType& data ) const;
 
     wxMenu* m_popup;
 
+    enum { COLUMN_COUNT = 12 };
+
+    //! What is painted for a battle: texts, icons and content availability.
+    //! Filled on first paint, dropped by AddBattle/UpdateBattle/RemoveBattle,
+    //! so painting doesn't ask unitsync or format anything.
+    struct BattleRow
+    {
+        wxString text[COLUMN_COUNT];
+        int image[COLUMN_COUNT];
+        long running; //! minutes column 10 was formatted for
+    };
+    typedef std::map<const IBattle*, BattleRow> BattleRowMap;
+
+    BattleRow& GetRow( const IBattle& battle ) const;
+    void InvalidateRow( const IBattle& battle );
+
+    mutable BattleRowMap m_rows;
+
     virtual void Sort();
 
     DECLARE_EVENT_TABLE()
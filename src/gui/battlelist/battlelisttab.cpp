@@ -26,6 +26,8 @@
 #include "gui/hosting/hostbattledialog_public.h"
 #include "gui/hosting/mainjoinbattletab.h"
 #include "iserver.h"
+#include "battlelist.h"
+#include "contentregistry.h"
 #include "serverselector.h"
 #include "gui/mapctrl.h"
 #include "gui/nicklistctrl.h"
@@ -35,6 +37,7 @@
 #include "useractions.h"
 #include "gui/customdialogs.h"
 #include "utils/slconfig.h"
+#include "utils/slpaths.h"
 #include "log.h"
 
 //const unsigned int BATTLELIST_COLUMNCOUNT = 10;
@@ -61,6 +64,7 @@ SLCONFIG("/BattleListTab/ShowExtendedInfos", true, "determines if panels with ba
 
 BattleListTab::BattleListTab( wxWindow* parent )
     : wxScrolledWindow( parent, -1 ),
+    m_content_serial( 0 ),
     m_sel_battle( 0 )
 {
 	GetAui().manager->AddPane( this, wxLEFT, _T( "battlelisttab" ) );
@@ -169,6 +173,7 @@ BattleListTab::BattleListTab( wxWindow* parent )
 	SelectBattle( 0 );
 	ShowExtendedInfos(cfg().ReadBool(_T("/BattleListTab/ShowExtendedInfos")));
 	ConnectGlobalEvent(this, GlobalEvent::OnUnitsyncReloaded, wxObjectEventFunction(&BattleListTab::OnUnitsyncReloaded));
+	ConnectGlobalEvent(this, GlobalEvent::OnContentAdded, wxObjectEventFunction(&BattleListTab::OnContentAdded));
 }
 
 
@@ -443,6 +448,39 @@ void BattleListTab::OnUnitsyncReloaded( wxCommandEvent& /*data*/ )
 	UpdateList();
 }
 
+void BattleListTab::OnContentAdded( wxCommandEvent& /*data*/ )
+{
+	assert(wxThread::IsMain());
+	std::vector<ContentRegistry::Entry> added;
+	const bool complete = contentRegistry().GetAddedSince(m_content_serial, added);
+	if ( added.empty() || ! serverSelector().IsServerAvailible() )
+		return;
+	if ( !complete ) {
+		UpdateList();
+		return;
+	}
+
+	bool engine_added = false;
+	for ( size_t i = 0; i < added.size(); i++ ) {
+		if ( added[i].type == ContentRegistry::CT_ENGINE ) engine_added = true;
+	}
+
+	// only battles using the new content change their availability
+	BattleList_Iter* battles = serverSelector().GetServer().battles_iter;
+	battles->IteratorBegin();
+	while ( ! battles->EOL() ) {
+		IBattle* b = battles->GetBattle();
+		if ( b == 0 )
+			continue;
+		// a new engine can be sync compatible to several versions, ask the version list
+		if ( ContentRegistry::Contains(added, ContentRegistry::CT_MAP, b->GetHostMapName()) ||
+		     ContentRegistry::Contains(added, ContentRegistry::CT_GAME, b->GetHostModName()) ||
+		     ( engine_added && !SlPaths::GetCompatibleVersion(b->GetEngineVersion()).empty() ) )
+			UpdateBattle( *b );
+	}
+	m_battle_list->RefreshVisibleItems();
+}
+
 void BattleListTab::UpdateHighlights()
 {
 	m_battle_list->RefreshVisibleItems();
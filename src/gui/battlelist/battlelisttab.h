@@ -62,12 +62,15 @@ class BattleListTab : public wxScrolledWindow, public GlobalEvent, public SL::No
 
     void OnSelect( wxListEvent& event );
     void OnUnitsyncReloaded( wxCommandEvent& data );
+    void OnContentAdded( wxCommandEvent& data );
 
     void UpdateHighlights();
 
     void SortBattleList();
 
 private:
+    //! newest ContentRegistry entry already handled
+    unsigned int m_content_serial;
     BattleListFilter* m_filter;
     BattleListCtrl* m_battle_list;
     MapCtrl* m_minimap;
@@ -526,10 +526,10 @@ void ChatPanel::Said( const wxString& who, const wxString& message )
 		m_active_users.insert(who);
 	}
 
-	wxString me = TowxString(GetMe().GetNick());
+	const wxString me = TowxString(GetMe().GetNick());
 	wxColour col;
 	bool req_user = false;
-	if ( who.Upper() == me.Upper() ) {
+	if ( who.IsSameAs( me, false ) ) {
 		col = sett().GetChatColorMine();
 	} else {
 		// change the image of the tab to show new events
@@ -8,13 +8,14 @@
 #include <wx/stattext.h>
 #include <wx/button.h>
 #include <wx/protocol/http.h>
-#include <wx/sstream.h>
 #include <wx/thread.h>
 #include "json/wx/jsonreader.h"
 #include "ui.h"
+#include "contentregistry.h"
 #include <lslunitsync/unitsync.h>
 
 #include <iostream>
+#include <vector>
 DECLARE_EVENT_TYPE(SEARCH_FINISHED, wxID_ANY);
 DEFINE_EVENT_TYPE(SEARCH_FINISHED);
 BEGIN_EVENT_TABLE( ContentDownloadDialog, wxDialog )
@@ -74,18 +75,22 @@ void* SearchThread::Entry()
 	get.Connect(_("api.springfiles.com"));
 	const wxString query = wxFormat(_("/json.php?nosensitive=on&logical=or&springname=%s&tag=%s"))  % searchescaped % searchescaped;
 	wxInputStream * httpStream = get.GetInputStream(query);
-	wxString res;
+	std::string res;
 	if ( get.GetError() == wxPROTO_NOERR ) {
-
-		wxStringOutputStream out_stream(&res);
-		httpStream->Read(out_stream);
-
-
+		// keep the raw utf-8 bytes, they're parsed in place
+		char buf[64 * 1024];
+		while ( !httpStream->Eof() ) {
+			httpStream->Read(buf, sizeof(buf));
+			const size_t read = httpStream->LastRead();
+			if ( read == 0 )
+				break;
+			res.append(buf, read);
+		}
 	}
 	wxDELETE(httpStream);
+	m_content_dialog->SetSearchResult(res);
 	wxCommandEvent notify(SEARCH_FINISHED,ContentDownloadDialog::ID_SEARCH_FINISHED);
 	notify.SetInt(0);
-	notify.SetString(res); //FIXME: wxWidgets strings in events are not threadsafe, this will crash, etc.etc
 	wxPostEvent(m_content_dialog,notify);
 //   std::cout << "Search finished" << std::endl;
 	return NULL;
@@ -159,24 +164,118 @@ void ContentDownloadDialog::OnSearch(wxCommandEvent& /*event*/)
 	m_search_thread->Create();
 	m_search_thread->Run();
 }
-void ContentDownloadDialog::OnSearchCompleted(wxCommandEvent& event)
+void ContentDownloadDialog::SetSearchResult(const std::string& json)
+{
+	wxMutexLocker lock(m_search_mutex);
+	m_search_result = json;
+}
+
+//! collects category, size and springname of each result, all other fields are skipped
+class SearchResultParser : public wxJSONSaxHandler
+{
+public:
+	struct Result
+	{
+		Result(): size(0) {}
+		std::string category;
+		std::string name;
+		long size;
+	};
+
+	SearchResultParser():
+		m_level(0),
+		m_is_array(false),
+		m_field(NULL),
+		m_size(false)
+	{
+	}
+
+	void StartObject() { Start(); }
+	void StartArray()
+	{
+		if (m_level == 0)
+			m_is_array = true;
+		Start();
+	}
+	void EndObject()
+	{
+		if (m_level == 2)
+			m_results.push_back(m_current);
+		m_level--;
+	}
+	void EndArray() { m_level--; }
+
+	bool Key(const char* key, size_t len)
+	{
+		m_field = NULL;
+		m_size = false;
+		if (m_level != 2)
+			return false;
+		const std::string name(key, len);
+		if (name == "category")
+			m_field = &m_current.category;
+		else if (name == "springname")
+			m_field = &m_current.name;
+		else if (name == "size")
+			m_size = true;
+		else
+			return false;
+		return true;
+	}
+	void String(const char* str, size_t len)
+	{
+		if (m_field != NULL)
+			m_field->assign(str, len);
+	}
+	void Int(wxInt64 i)
+	{
+		if (m_size)
+			m_current.size = i;
+	}
+
+	bool IsArray() const { return m_is_array; }
+	const std::vector<Result>& GetResults() const { return m_results; }
+
+private:
+	void Start()
+	{
+		m_level++;
+		if (m_level == 2)
+			m_current = Result();
+		m_field = NULL;
+		m_size = false;
+	}
+
+	int m_level;
+	bool m_is_array;
+	std::string* m_field;
+	bool m_size;
+	Result m_current;
+	std::vector<Result> m_results;
+};
+
+void ContentDownloadDialog::OnSearchCompleted(wxCommandEvent& /*event*/)
 {
 	assert(wxThread::IsMain());
 
-	wxString json = event.GetString(); //FIXME: strings are not threadsafe in events, this is a bug / leads to crashes / mem-corruption, etc.ect.!!!!
-//   std::cout << json.ToAscii().data() << std::endl;
+	std::string json;
+	{
+		wxMutexLocker lock(m_search_mutex);
+		json.swap(m_search_result);
+	}
 
 	wxJSONReader reader;
-	wxJSONValue root;
-	int errors = reader.Parse(json,&root);
+	SearchResultParser parser;
+	int errors = reader.Parse(json.data(), json.size(), parser);
 	m_search_thread = NULL;
 	m_searchbutton->Enable(true);
-	if ( errors ) {
-		wxMessageBox(wxFormat("Failed to parse search results:\n%s") % json.c_str() ,_("Error"));
+	if ( errors || !parser.IsArray() ) {
+		const wxString error = errors ? reader.GetErrors()[0] : _T("no result array");
+		wxMessageBox(wxFormat("Failed to parse search results:\n%s") % error ,_("Error"));
 		return;
 	}
-	const wxJSONInternalArray * a = root.AsArray();
-	if ((a->GetCount() == 0) && (!wildcardsearch)) { //no results returned, try wildcard search
+	const std::vector<SearchResultParser::Result>& a = parser.GetResults();
+	if ((a.empty()) && (!wildcardsearch)) { //no results returned, try wildcard search
 		wildcardsearch = true;
 		wxString search_query = _T("*")+m_searchbox->GetValue()+_T("*");//By default the user would expect that
 		m_searchbutton->Enable(false);
@@ -188,26 +287,16 @@ void ContentDownloadDialog::OnSearchCompleted(wxCommandEvent& event)
 	wildcardsearch = false;
 	m_search_res_w->Clear();
 
-	for ( unsigned i = 0; i < a->GetCount(); i++ ) {
-		wxJSONValue val = a->Item(i);
-		wxString category = val[_("category")].AsString();
-
-		long size = 0;
-		if (val[_("size")].IsInt()) {
-			size = val[_("size")].AsInt();
-		} else if (val[_("size")].IsLong()){
-			size = val[_("size")].AsLong();
-		}
-		wxString name = val[_("springname")].AsString();
-//     std::cout << category.ToAscii().data() << "," << name.ToAscii().data() << "," << size << std::endl;
+	for ( unsigned i = 0; i < a.size(); i++ ) {
+		const SearchResultParser::Result& val = a[i];
 		ContentSearchResult* res = new ContentSearchResult();
-		res->name = name;
-		res->filesize = size;
-		res->type = category;
-		if(category==_("map"))
-			res->is_downloaded=LSL::usync().MapExists(std::string(name.mb_str()));
-		else if(category==_("game"))
-			res->is_downloaded=LSL::usync().ModExists(std::string(name.mb_str()));
+		res->name = TowxString(val.name);
+		res->filesize = val.size;
+		res->type = TowxString(val.category);
+		if(val.category == "map")
+			res->is_downloaded=contentRegistry().MapExists(val.name);
+		else if(val.category == "game")
+			res->is_downloaded=contentRegistry().GameExists(val.name);
 		else
 			res->is_downloaded=0;
 
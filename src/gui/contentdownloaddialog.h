@@ -6,6 +6,8 @@
 #include "windowattributespickle.h"
 #include <wx/dialog.h>
 #include <wx/listbase.h>
+#include <wx/thread.h>
+#include <string>
 class wxBoxSizer;
 class wxStaticText;
 class wxButton;
@@ -26,6 +28,8 @@ public:
 	void OnDownloadButton( wxCommandEvent& event);
 	void OnCloseButton( wxCommandEvent& event);
 	void OnListDownload( wxListEvent& event );
+	//! called by the search thread with the raw response
+	void SetSearchResult( const std::string& json );
 private:
 	DECLARE_EVENT_TABLE()
 
@@ -39,6 +43,8 @@ private:
 
 	SearchThread* m_search_thread;
 	bool wildcardsearch;
+	wxMutex m_search_mutex;
+	std::string m_search_result; //! utf-8 json response of the last search
 public:
 	enum {
 		SEARCH_BUTTON = wxID_HIGHEST,
@@ -7,6 +7,8 @@
 #include "iconimagelist.h"
 #include "uiutils.h"
 #include "gui/sltipwin.h"
+#include "utils/conversion.h"
+#include "utils/sortutil.h"
 #include <algorithm>
 #include <lslutils/misc.h>
 
@@ -57,6 +59,7 @@ CustomVirtListCtrl<T,L>::CustomVirtListCtrl(wxWindow* parent, wxWindowID id, con
 	m_periodic_sort( periodic_sort ),
 	m_periodic_sort_interval( periodic_sort_interval )
 {
+	m_cmp_rows[0] = m_cmp_rows[1] = NULL;
 	//dummy init , will later be replaced with loading from settings
 	for ( unsigned int i = 0; i < m_columnCount; ++i) {
 		m_column_map[i] = i;
@@ -409,6 +412,7 @@ void CustomVirtListCtrl<T,L>::Clear()
 {
 	m_data.clear();
 	m_selected_data.clear();
+	m_sortkeys.clear();
 	SetItemCount( 0 );
 	ResetSelection();
 	RefreshVisibleItems();
@@ -525,6 +529,8 @@ bool CustomVirtListCtrl<T,L>::AddItem( const T& item )
 	if ( GetIndexFromData( item ) != -1 )
 		return false;
 
+	// the item can have the address of a removed one
+	InvalidateSortKeys( item );
 	m_data.push_back( item );
 	SetItemCount( m_data.size() );
 	RefreshItem( m_data.size() - 1 );
@@ -537,6 +543,7 @@ bool CustomVirtListCtrl<T,L>::RemoveItem( const T& item )
 {
 	int index = GetIndexFromData( item );
 	if ( (index >= 0) && (index<(long)m_data.size()) ) {
+		InvalidateSortKeys( item );
 		SaveSelection();
 		m_data.erase( m_data.begin() + index );
 		SetItemCount( m_data.size() );
@@ -553,6 +560,61 @@ bool CustomVirtListCtrl<T,L>::RemoveItem( const T& item )
 	return false;
 }
 
+template < class T, class L >
+const typename CustomVirtListCtrl<T,L>::SortKeyVector& CustomVirtListCtrl<T,L>::GetSortKeys( const T& item ) const
+{
+	if ( m_cmp_rows[0] != NULL ) {
+		if ( m_cmp_rows[0]->item == item )
+			return *m_cmp_rows[0]->keys;
+		if ( m_cmp_rows[1]->item == item )
+			return *m_cmp_rows[1]->keys;
+	}
+	typename SortKeyMap::iterator it = m_sortkeys.find( item );
+	if ( it != m_sortkeys.end() )
+		return it->second;
+
+	SortKeyVector& keys = m_sortkeys[item];
+	asImp().BuildSortKeys( item, keys );
+	return keys;
+}
+
+template < class T, class L >
+void CustomVirtListCtrl<T,L>::InvalidateSortKeys( const T& item )
+{
+	m_sortkeys.erase( item );
+}
+
+template < class T, class L >
+bool CustomVirtListCtrl<T,L>::SortRowComparator::operator () ( const SortRow& r1, const SortRow& r2 ) const
+{
+	m_listctrl->m_cmp_rows[0] = &r1;
+	m_listctrl->m_cmp_rows[1] = &r2;
+	const bool res = m_listctrl->m_comparator( r1.item, r2.item );
+	m_listctrl->m_cmp_rows[0] = m_listctrl->m_cmp_rows[1] = NULL;
+	return res;
+}
+
+template < class T, class L >
+void CustomVirtListCtrl<T,L>::SortByKeys()
+{
+	// map entries don't move, so the key pointers stay valid while the missing ones are built
+	std::vector<SortRow> rows( m_data.size() );
+	for ( size_t i = 0; i < m_data.size(); i++ ) {
+		rows[i].item = m_data[i];
+		rows[i].keys = &GetSortKeys( m_data[i] );
+	}
+	SLInsertionSort( rows, SortRowComparator( this ) );
+	for ( size_t i = 0; i < rows.size(); i++ )
+		m_data[i] = rows[i].item;
+}
+
+template < class T, class L >
+std::string CustomVirtListCtrl<T,L>::FoldSortKey( const wxString& s )
+{
+	// utf-8 keeps the order of the code points
+	return STD_STRING( s.Lower() );
+}
+
 template < class T, class L >
 wxString CustomVirtListCtrl<T,L>::OnGetItemText(long item, long column) const
 {
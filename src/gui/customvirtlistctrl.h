@@ -14,6 +14,7 @@
 #define IDD_SORT_TIMER 697
 
 #include <vector>
+#include <string>
 
 #include <utility>
 #include <map>
@@ -205,6 +206,37 @@ protected:
 		return 0;
 	}
 
+	/** @name sort keys
+	 * Comparators can compare precomputed keys instead of converting and case folding
+	 * strings in every comparison. The keys of a row are built by the derived class'
+	 * BuildSortKeys( DataType, SortKeyVector& ) const when they are first needed and kept
+	 * until the row is added, removed or InvalidateSortKeys is called for it.
+	 * @{
+	 */
+	struct SortKey {
+		std::string text; //! see FoldSortKey
+		long num;
+		SortKey(): num( 0 ) {}
+	};
+	typedef std::vector<SortKey> SortKeyVector;
+
+	const SortKeyVector& GetSortKeys( const DataImp& item ) const;
+	void InvalidateSortKeys( const DataImp& item );
+	//! same as SLInsertionSort( m_data, m_comparator ), but looks up the keys of every row only once
+	void SortByKeys();
+
+	//! compares like wxString::CmpNoCase when the results are compared bytewise
+	static std::string FoldSortKey( const wxString& s );
+
+	//! compares text, then num
+	static inline int compareSortKey( const SortKey& k1, const SortKey& k2 ) {
+		const int res = k1.text.compare( k2.text );
+		if ( res != 0 )
+			return res < 0 ? -1 : 1;
+		return compareSimple( k1.num, k2.num );
+	}
+	/** @} */
+
 	//! must be implemented in derived classes, should call the actual sorting on data and refreshitems
 	virtual void Sort( ) = 0;
 
@@ -350,6 +382,24 @@ public:
 	DECLARE_EVENT_TABLE()
 
 private:
+	typedef std::map< DataImp, SortKeyVector > SortKeyMap;
+	mutable SortKeyMap m_sortkeys;
+
+	//! a row and its keys, SortByKeys() sorts these instead of m_data
+	struct SortRow {
+		DataImp item;
+		const SortKeyVector* keys;
+	};
+	//! runs m_comparator on two packed rows, GetSortKeys() answers from them
+	struct SortRowComparator {
+		typedef SortRow ObjType;
+		const BaseType* m_listctrl;
+		explicit SortRowComparator( const BaseType* listctrl ): m_listctrl( listctrl ) {}
+		bool operator () ( const SortRow& r1, const SortRow& r2 ) const;
+	};
+	//! the rows being compared while SortByKeys() runs, NULL otherwise
+	mutable const SortRow* m_cmp_rows[2];
+
 	typedef BaseType ThisType;
 	ListCtrlImp& asImp() {
 		return static_cast<ListCtrlImp&>(*this);
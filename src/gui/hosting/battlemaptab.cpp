@@ -34,6 +34,7 @@
 #include "utils/conversion.h"
 #include "log.h"
 #include "gui/mapctrl.h"
+#include "contentregistry.h"
 
 #include <lslutils/conversion.h>
 
@@ -123,6 +124,8 @@ BattleMapTab::BattleMapTab( wxWindow* parent, IBattle* battle )
 	SetScrollRate( SCROLL_RATE, SCROLL_RATE );
 	Layout();
 	ConnectGlobalEvent(this, GlobalEvent::OnUnitsyncReloaded, wxObjectEventFunction(&BattleMapTab::OnUnitsyncReloaded));
+	m_content_serial = contentRegistry().GetSerial();
+	ConnectGlobalEvent(this, GlobalEvent::OnContentAdded, wxObjectEventFunction(&BattleMapTab::OnContentAdded));
 }
 
 
@@ -275,6 +278,24 @@ void BattleMapTab::OnUnitsyncReloaded( wxCommandEvent& /*data*/ )
     ReloadMaplist();
 }
 
+void BattleMapTab::OnContentAdded( wxCommandEvent& data )
+{
+	std::vector<ContentRegistry::Entry> added;
+	const bool complete = contentRegistry().GetAddedSince( m_content_serial, added );
+	if ( !m_battle ) return;
+	if ( !complete ) {
+		OnUnitsyncReloaded( data );
+		return;
+	}
+	for ( size_t i = 0; i < added.size(); i++ ) {
+		if ( added[i].type != ContentRegistry::CT_MAP ) continue;
+		const wxString mapname = TowxString( added[i].name );
+		if ( m_map_combo->FindString( mapname ) == wxNOT_FOUND ) m_map_combo->Append( mapname );
+	}
+	// the details of the battle's map are known now
+	if ( ContentRegistry::Contains( added, ContentRegistry::CT_MAP, m_battle->GetHostMapName() ) ) Update();
+}
+
 void BattleMapTab::SetBattle( IBattle* battle )
 {
 	m_battle = battle;
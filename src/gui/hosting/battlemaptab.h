@@ -47,6 +47,8 @@ private:
 	void OnMapBrowse( wxCommandEvent& event );
 	void OnStartTypeSelect( wxCommandEvent& event );
 	void OnUnitsyncReloaded( wxCommandEvent& /*data*/ );
+	//! appends new maps to the map list
+	void OnContentAdded( wxCommandEvent& data );
 
     IBattle* m_battle;
     //LSL::UnitsyncMap m_map;
@@ -57,6 +59,7 @@ private:
     wxRadioBox* m_start_radios;
     wxListCtrl* m_map_opts_list;
     wxStaticText* m_map_desc;
+    unsigned int m_content_serial; //! see ContentRegistry::GetAddedSince
 
     enum {
       BMAP_MAP_SEL = wxID_HIGHEST,
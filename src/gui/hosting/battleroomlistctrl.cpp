@@ -243,12 +243,6 @@ void BattleroomListCtrl::UpdateUser( User& user )
 {
     if ( !user.BattleStatus().spectator )
  		icons().SetColourIcon(user.BattleStatus().colour);
-	try {
-		wxArrayString sides = lslTowxArrayString(LSL::usync().GetSides(m_battle->GetHostModName()));
-		if  (user.BattleStatus().side < (long)sides.GetCount()) {
-			user.SetSideiconIndex( icons().GetSideIcon( m_battle->GetHostModName(), user.BattleStatus().side ) );
-		}
-	} catch (...) {}
     int index = GetIndexFromData( &user );
     UpdateUser( index );
 }
@@ -291,7 +285,14 @@ int BattleroomListCtrl::GetItemColumnImage(long item, long column) const
 	if ( column == m_colour_column_index ) return is_spec ? -1 : icons().GetColourIcon( user.BattleStatus().colour );
 	if ( column == m_country_column_index ) return is_bot ? -1 : icons().GetFlagIcon( user.GetCountry());
 	if ( column == m_rank_column_index ) return is_bot ? -1 : icons().GetRankIcon( user.GetStatus().rank );
-	if ( column == m_faction_column_index ) return is_spec ? -1 : user.GetSideiconIndex();
+	if ( column == m_faction_column_index ) {
+		if ( is_spec ) return -1;
+		// side icon slots are recycled, so never keep an index around
+		try {
+			return icons().GetSideIcon( m_battle->GetHostModName(), user.BattleStatus().side );
+		} catch (...) {}
+		return icons().ICON_NONE;
+	}
 	if ( column == m_nick_column_index ) return -1;
 	if ( column == m_team_column_index ) return -1;
 	if ( column == m_ally_column_index ) return -1;
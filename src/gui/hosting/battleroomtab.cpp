@@ -55,6 +55,7 @@
 #include "log.h"
 #include "utils/lslconversion.h"
 #include "autohostmanager.h"
+#include "contentregistry.h"
 
 BEGIN_EVENT_TABLE( BattleRoomTab, wxPanel )
 
@@ -355,6 +356,8 @@ BattleRoomTab::BattleRoomTab( wxWindow* parent, IBattle* battle )
 	Layout();
 
 	ConnectGlobalEvent(this, GlobalEvent::OnUnitsyncReloaded, wxObjectEventFunction(&BattleRoomTab::OnUnitsyncReloaded));
+	m_content_serial = contentRegistry().GetSerial();
+	ConnectGlobalEvent(this, GlobalEvent::OnContentAdded, wxObjectEventFunction(&BattleRoomTab::OnContentAdded));
 }
 
 
@@ -919,6 +922,29 @@ void BattleRoomTab::OnUnitsyncReloaded( wxCommandEvent& /*data*/ )
 	ui().DownloadArchives(*m_battle);
 }
 
+void BattleRoomTab::OnContentAdded( wxCommandEvent& data )
+{
+	std::vector<ContentRegistry::Entry> added;
+	const bool complete = contentRegistry().GetAddedSince( m_content_serial, added );
+	if ( !m_battle ) return;
+	bool engine_added = false;
+	for ( size_t i = 0; i < added.size(); i++ ) {
+		if ( added[i].type == ContentRegistry::CT_ENGINE ) engine_added = true;
+	}
+	// the battle's own map, game or engine change its options and sync state
+	if ( !complete || engine_added ||
+	     ContentRegistry::Contains( added, ContentRegistry::CT_MAP, m_battle->GetHostMapName() ) ||
+	     ContentRegistry::Contains( added, ContentRegistry::CT_GAME, m_battle->GetHostModName() ) ) {
+		OnUnitsyncReloaded( data );
+		return;
+	}
+	for ( size_t i = 0; i < added.size(); i++ ) {
+		if ( added[i].type != ContentRegistry::CT_MAP ) continue;
+		const wxString mapname = TowxString( added[i].name );
+		if ( m_map_combo->FindString( mapname ) == wxNOT_FOUND ) m_map_combo->Append( mapname );
+	}
+}
+
 long BattleRoomTab::AddMMOptionsToList( long pos, LSL::Enum::GameOption optFlag )
 {
 	if ( !m_battle ) return -1;
@@ -124,6 +124,8 @@ private:
         void OnAutohostNotify( wxCommandEvent& event );
 
 		void OnUnitsyncReloaded( wxCommandEvent& /*data*/ );
+		//! appends new maps to the map list, reloads everything only for the battle's own content
+		void OnContentAdded( wxCommandEvent& data );
 
 		long AddMMOptionsToList( long pos, LSL::Enum::GameOption optFlag );
 
@@ -198,6 +200,7 @@ private:
 		wxCheckBox* m_autolock_chk;
 
 		wxListCtrl* m_opts_list;
+		unsigned int m_content_serial; //! see ContentRegistry::GetAddedSince
 
 		EventReceiverFunc<BattleRoomTab, UiEvents::UiEventData, &BattleRoomTab::OnBattleActionEvent> m_BattleActionSink;
 
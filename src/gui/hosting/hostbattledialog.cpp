@@ -39,6 +39,7 @@
 #include "gui/ui.h"
 #include "iserver.h"
 #include "serverselector.h"
+#include "contentregistry.h"
 #include <lslunitsync/springbundle.h>
 #include <lslunitsync/unitsync.h>
 
@@ -438,7 +439,7 @@ void HostBattleDialog::OnUseRelay( wxCommandEvent&  )
 void HostBattleDialog::OnEngineSelect ( wxCommandEvent& /*event*/ )
 {
 	SlPaths::SetUsedSpringIndex(STD_STRING(m_engine_pic->GetString(m_engine_pic->GetSelection())));
-	LSL::usync().ReloadUnitSyncLib();
+	contentRegistry().ReloadUnitsync();
 	ReloadEngineList();
 }
 
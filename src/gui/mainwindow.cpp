@@ -63,6 +63,7 @@
 #include "gui/controls.h"
 #include "gui/ui.h"
 #include "log.h"
+#include "contentregistry.h"
 #include <lslunitsync/unitsync.h>
 
 #include "iconimagelist.h"
@@ -555,7 +556,7 @@ void MainWindow::OnMenuVersion( wxCommandEvent& /*unused*/ )
 
 void MainWindow::OnUnitSyncReload( wxCommandEvent& /*unused*/ )
 {
-	LSL::usync().ReloadUnitSyncLib();
+	contentRegistry().ReloadUnitsync();
 	GlobalEvent::Send(GlobalEvent::OnUnitsyncReloaded);
 }
 
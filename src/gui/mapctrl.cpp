@@ -6,10 +6,12 @@
 #include <wx/image.h>
 #include <wx/intl.h>
 #include <cmath>
+#include <cstring>
 #include <stdexcept>
 #include <wx/log.h>
 #include <wx/app.h>
 #include <wx/toplevel.h>
+#include <wx/stopwatch.h>
 
 #define HAVE_WX
 #include <lslutils/conversion.h>
@@ -90,6 +92,9 @@ END_EVENT_TABLE()
 const int boxsize = 8;
 const int minboxsize = 40;
 
+/* Upper bound of cached start rect overlays, dragging a rect creates a new size on every mouse move. */
+const size_t max_cached_overlays = 64;
+
 static inline void WriteInt24(unsigned char* p, int i)
 {
     p[0] = i & 0xFF;
@@ -134,6 +139,8 @@ MapCtrl::MapCtrl( wxWindow* parent, int size, IBattle* battle, bool readonly, bo
         m_dl_img(NULL),
         m_user_expanded(NULL),
         m_current_infomap(IM_Minimap),
+        m_paint_count(0),
+        m_paint_time_max(0),
         m_mutex()
 {
 	SetBackgroundStyle( wxBG_STYLE_CUSTOM );
@@ -486,6 +493,50 @@ void MapCtrl::FreeMinimap()
     delete m_heightmap;
     m_heightmap = 0;
     m_mapname = "";
+    FreeOverlayCache();
+}
+
+
+void MapCtrl::FreeOverlayCache()
+{
+    m_overlay_cache.clear();
+}
+
+
+const wxBitmap& MapCtrl::GetStartRectOverlay( int width, int height, const wxColour& col, int alphalevel )
+{
+    OverlayKey key;
+    key.width = width;
+    key.height = height;
+    key.rgb = col.GetRGB();
+    key.alpha = alphalevel;
+
+    OverlayCache::const_iterator it = m_overlay_cache.find( key );
+    if ( it != m_overlay_cache.end() ) return it->second;
+
+    if ( m_overlay_cache.size() >= max_cached_overlays ) FreeOverlayCache();
+
+    wxImage img( width, height, false );
+    const unsigned char red = std::min( col.Red() + 100, 200 );
+    const unsigned char green = std::min( col.Green() + 100, 200 );
+    const unsigned char blue = std::min( col.Blue() + 100, 200 );
+    unsigned char* rgb = img.GetData();
+    for ( int i = 0; i < width * height; i++ )
+    {
+        rgb[3*i] = red;
+        rgb[3*i+1] = green;
+        rgb[3*i+2] = blue;
+    }
+    img.InitAlpha();
+    // every third row is drawn more opaque, the pattern is constant along a row
+    const unsigned char strong = alphalevel;
+    const unsigned char weak = std::max( alphalevel - 40, 0 );
+    unsigned char* alpha = img.GetAlpha();
+    for ( int y = 0; y < height; y++ )
+    {
+        memset( alpha + y * width, ( y % 3 ) == 0 ? strong : weak, width );
+    }
+    return m_overlay_cache[key] = wxBitmap( img );
 }
 
 
@@ -559,24 +610,7 @@ void MapCtrl::DrawStartRect( wxDC& dc, int index, wxRect& sr, const wxColour& co
 
     dc.SetBrush( wxBrush( *wxLIGHT_GREY, wxTRANSPARENT ) );
 
-    wxImage img( sr.width, sr.height );
-    wxColour light;
-    light.Set( ( ( col.Red() + 100 ) > 200 ) ? 200 :  (col.Red() + 100 ), ( ( col.Green() + 100 ) > 200 ) ? 200 : ( col.Green() + 100 ), ( ( col.Blue() + 100 ) > 200 ) ? 200 : ( col.Blue() + 100 ) );
-    img.SetRGB( wxRect( 0, 0, sr.width, sr.height ), light.Red(), light.Green(), light.Blue() );
-    img.InitAlpha();
-    unsigned char *alpha = img.GetAlpha();
-    for ( int y = 0; y < sr.height; y++ )
-    {
-        int a;
-        if ( ( y % 3 ) == 0 ) a = alphalevel;
-        else a = ( ( alphalevel - 40 ) < 0 ) ? 0 : ( alphalevel - 40 );
-        for ( int x = 0; x < sr.width; x++ )
-        {
-            alpha[ ( y* sr.width )+ x ] = a;
-        }
-    }
-    wxBitmap bmpimg( img );
-    dc.DrawBitmap( bmpimg, sr.x, sr.y, false );
+    dc.DrawBitmap( GetStartRectOverlay( sr.width, sr.height, col, alphalevel ), sr.x, sr.y, false );
 
     /*  wxFont f( 12, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL|wxFONTFLAG_ANTIALIASED, wxFONTWEIGHT_LIGHT );
       dc.SetFont( f );*/
@@ -1019,9 +1053,21 @@ void MapCtrl::DrawUserPositions( wxDC& dc )
 
 void MapCtrl::OnPaint( wxPaintEvent& WXUNUSED(event) )
 {
-	slLogDebugFunc("");
     wxPaintDC dc( this );
+    wxStopWatch watch;
+
+    Paint( dc );
+
+    const long elapsed = watch.Time();
+    m_paint_count++;
+    m_paint_time_max = std::max( m_paint_time_max, elapsed );
+    slLogDebugFunc("frame %lu painted in %ld ms (max %ld ms, %lu cached overlays)",
+                   m_paint_count, elapsed, m_paint_time_max, (unsigned long)m_overlay_cache.size());
+}
+
 
+void MapCtrl::Paint( wxDC& dc )
+{
     DrawBackground( dc );
 
     if ( m_battle == 0 ) return;
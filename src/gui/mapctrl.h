@@ -11,6 +11,7 @@
 #include <lslunitsync/unitsync.h>
 
 #include <wx/thread.h>
+#include <map>
 
 class wxPanel;
 class wxBitmap;
@@ -163,6 +164,15 @@ private:
     void DrawStartPositions( wxDC& dc );
     void DrawStartRect( wxDC& dc, int index, wxRect& sr, const wxColour& col, bool mouseover, int alphalevel = 70, bool forceInsideMinimap = true );
 
+    /** Get the translucent striped fill drawn inside a start rect.
+     * Overlays are rendered once per (size, colour, alpha) and kept until
+     * the minimap changes, so repaints while dragging are plain blits.
+     */
+    const wxBitmap& GetStartRectOverlay( int width, int height, const wxColour& col, int alphalevel );
+    void FreeOverlayCache();
+
+    void Paint( wxDC& dc );
+
     void SetMouseOverRect( int index );
 
     void _SetCursor();
@@ -174,6 +184,23 @@ private:
     wxBitmap* m_heightmap;
     wxImage m_metalmap_cumulative;
 
+    struct OverlayKey
+    {
+        int width;
+        int height;
+        unsigned long rgb;
+        int alpha;
+        bool operator<( const OverlayKey& other ) const
+        {
+            if ( width != other.width ) return width < other.width;
+            if ( height != other.height ) return height < other.height;
+            if ( rgb != other.rgb ) return rgb < other.rgb;
+            return alpha < other.alpha;
+        }
+    };
+    typedef std::map<OverlayKey, wxBitmap> OverlayCache;
+    OverlayCache m_overlay_cache;
+
     IBattle* m_battle;
 
     std::string m_mapname;
@@ -223,6 +250,9 @@ private:
 	  IM_Count     // must be last one
     } m_current_infomap;
 
+    unsigned long m_paint_count;
+    long m_paint_time_max;
+
 	wxMutex m_mutex;
 
   DECLARE_EVENT_TABLE()
@@ -44,6 +44,7 @@ class MapGridCtrl : public wxPanel
 		void Sort( SortKey vertical, SortKey horizontal, bool vertical_direction = false, bool horizontal_direction = false );
 
 		/* ===== filtering ===== */
+		//! returns the number of maps in the grid
 		template< class Predicate > int Filter( Predicate pred )
 		{
 			std::vector< wxString > maps;
@@ -57,7 +58,7 @@ class MapGridCtrl : public wxPanel
 					AddMap( it->first );
 				}
 			}
-			return m_maps.size();
+			return m_grid.size();
 		}
 
 		LSL::UnitsyncMap* GetSelectedMap() const { return m_selected_map; }
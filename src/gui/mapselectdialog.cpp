@@ -15,6 +15,8 @@
 #include "gui/controls.h"
 #include "utils/conversion.h"
 #include "utils/lslconversion.h"
+#include "utils/fuzzymatcher.h"
+#include "contentregistry.h"
 #include "settings.h"
 #include "log.h"
 
@@ -57,7 +59,8 @@ END_EVENT_TABLE()
 MapSelectDialog::MapSelectDialog( wxWindow* parent )
 	: // WindowHintsPickle( m_dialog_name, this, wxSize( DEFSETT_MW_WIDTH, DEFSETT_MW_HEIGHT ) ),
 	m_horizontal_direction( sett().GetHorizontalSortorder() ),
-	m_vertical_direction( sett().GetVerticalSortorder() )
+	m_vertical_direction( sett().GetVerticalSortorder() ),
+	m_content_serial( 0 )
 {
 	//(*Initialize(MapSelectDialog)
 	wxStaticBoxSizer* StaticBoxSizer2;
@@ -169,6 +172,7 @@ MapSelectDialog::MapSelectDialog( wxWindow* parent )
 
     Layout();
 	ConnectGlobalEvent(this, GlobalEvent::OnUnitsyncReloaded, wxObjectEventFunction(&MapSelectDialog::OnUnitsyncReloaded));
+	ConnectGlobalEvent(this, GlobalEvent::OnContentAdded, wxObjectEventFunction(&MapSelectDialog::OnContentAdded));
 }
 
 MapSelectDialog::~MapSelectDialog()
@@ -204,6 +208,8 @@ void MapSelectDialog::OnInit( wxInitDialogEvent& /*unused*/ )
     m_horizontal_direction_button->SetLabel( m_horizontal_direction ? _T(">") : _T("<") );
     m_vertical_direction_button->SetLabel( m_vertical_direction ? _T("ᴠ") : _T("ᴧ") );
 
+    // content added while the lists are read is skipped by OnContentAdded if they have it already
+    m_content_serial = contentRegistry().GetSerial();
     m_maps = lslTowxArrayString(LSL::usync().GetMapList());
     //true meaning replays, false meaning savegames
     m_replays = lslTowxArrayString(LSL::usync().GetPlaybackList(true));
@@ -263,21 +269,28 @@ static MapGridCtrl::SortKey GetSelectedSortKey( wxChoice* choice )
 namespace {
 struct FilterPredicate
 {
-    FilterPredicate( const wxString& _searchText ) : searchText(STD_STRING(_searchText.Lower())) {}
+    FilterPredicate( const std::string& _searchText, unsigned int _maxErrors )
+        : searchText(_searchText)
+        , maxErrors(_maxErrors)
+    {}
 	bool operator () ( const LSL::UnitsyncMap& map ) const
 	{
-        return boost::to_lower_copy(map.name).find(searchText) != std::string::npos
-            || boost::to_lower_copy(map.info.description).find(searchText) != std::string::npos
-            || boost::to_lower_copy(map.info.author).find(searchText) != std::string::npos;
+        return FuzzyMatcher::Contains(FuzzyMatcher::Normalize(map.name), searchText, maxErrors)
+            || FuzzyMatcher::Normalize(map.info.description).find(searchText) != std::string::npos
+            || FuzzyMatcher::Normalize(map.info.author).find(searchText) != std::string::npos;
 	}
     const std::string searchText;
+    const unsigned int maxErrors;
 };
 }
 
 void MapSelectDialog::UpdateSortAndFilter()
 {
-	FilterPredicate predicate( m_filter_text->GetValue() );
-	m_mapgrid->Filter( predicate );
+	const std::string text = FuzzyMatcher::Normalize( STD_STRING( m_filter_text->GetValue() ) );
+	// a typo in longer map names is only tolerated when the plain filter finds nothing
+	if ( m_mapgrid->Filter( FilterPredicate( text, 0 ) ) == 0 && text.length() >= 5 ) {
+		m_mapgrid->Filter( FilterPredicate( text, text.length() / 5 ) );
+	}
 	m_mapgrid->Sort( GetSelectedSortKey( m_vertical_choice ), GetSelectedSortKey( m_horizontal_choice ), m_vertical_direction, m_horizontal_direction );
 	m_mapgrid->Refresh();
 }
@@ -430,6 +443,47 @@ void MapSelectDialog::OnUnitsyncReloaded( wxCommandEvent& /*data*/ )
 	AddPendingEvent( dummy );
 }
 
+void MapSelectDialog::OnContentAdded( wxCommandEvent& data )
+{
+	std::vector<ContentRegistry::Entry> added;
+	if ( !contentRegistry().GetAddedSince( m_content_serial, added ) ) {
+		OnUnitsyncReloaded( data );
+		return;
+	}
+
+	bool changed = false;
+	for ( size_t i = 0; i < added.size(); i++ ) {
+		if ( added[i].type != ContentRegistry::CT_MAP ) continue;
+		const wxString mapname = TowxString( added[i].name );
+		if ( m_maps.Index( mapname ) != wxNOT_FOUND ) continue;
+		m_maps.Add( mapname );
+
+		// the same checks as the Load* functions, for this map only
+		bool show = m_filter_all->GetValue();
+		if ( m_filter_popular->GetValue() ) {
+			try {
+				serverSelector().GetServer().battles_iter->IteratorBegin();
+				while ( !show && !serverSelector().GetServer().battles_iter->EOL() ) {
+					IBattle* b = serverSelector().GetServer().battles_iter->GetBattle();
+					if ( b != NULL && b->GetHostMapName() == added[i].name ) show = true;
+				}
+			}
+			catch (...) {} // ui().GetServer may throw when disconnected...
+		} else if ( m_filter_recent->GetValue() ) {
+			const wxString replayname = _T("_") + mapname.BeforeLast( '.' ) + _T("_");
+			for ( size_t replaynum = 0; !show && replaynum < m_replays.GetCount(); replaynum++ ) {
+				show = m_replays[replaynum].Find( replayname ) != wxNOT_FOUND;
+			}
+		}
+		if ( show ) {
+			m_mapgrid->AddMap( mapname );
+			changed = true;
+		}
+	}
+	if ( changed )
+		UpdateSortAndFilter();
+}
+
 wxString mapSelectDialog(bool hidden, wxWindow* parent){
 	wxString mapname = wxEmptyString;
 	assert( (hidden && parent!=NULL) || (!hidden && parent==NULL)); //at the first call, the window is created hidden
@@ -36,6 +36,8 @@ class MapSelectDialog: public wxDialog, public GlobalEvent /*,public WindowAttri
 		LSL::UnitsyncMap* GetSelectedMap() const;
 
 		void OnUnitsyncReloaded( wxCommandEvent& data );
+		//! adds only the new maps to the grid
+		void OnContentAdded( wxCommandEvent& data );
 
 private:
 
@@ -96,6 +98,7 @@ private:
 		bool m_vertical_direction;
 		wxArrayString m_maps;
 		wxArrayString m_replays;
+		unsigned int m_content_serial; //! see ContentRegistry::GetAddedSince
 
 		static const wxString m_dialog_name;
 		enum {
@@ -24,7 +24,6 @@
 #include "chatpanelmenu.h"
 #include "userlist.h"
 #include "usermenu.h"
-#include "utils/sortutil.h"
 #include "log.h"
 
 
@@ -92,6 +91,7 @@ void NickListCtrl::UserUpdated( const User& user )
 	int index = GetIndexFromData( &user );
 	if ( index != -1 ) {
 		m_data[index] = &user;
+		InvalidateSortKeys( &user );
 		MarkDirtySort();
 		RefreshItem( index );
 	}
@@ -238,7 +238,7 @@ void NickListCtrl::Sort()
 	if ( m_data.size() > 0 )
 	{
 		SaveSelection();
-		SLInsertionSort( m_data, m_comparator );
+		SortByKeys();
 		RestoreSelection();
 	}
 }
@@ -290,16 +290,22 @@ int NickListCtrl::CompareOneCrit( DataType u1, DataType u2, int col, int dir ) c
 		case 0:
 			return dir * CompareUserStatus( u1, u2 );
 		case 1:
-			return dir * TowxString(u2->GetCountry()).CmpNoCase(TowxString(u1->GetCountry()));
-		case 2:
-			return dir * compareSimple( TowxString(u2->GetStatus().rank), TowxString(u1->GetStatus().rank)) ;
 		case 3:
-			return dir * TowxString(u2->GetNick()).CmpNoCase( TowxString(u1->GetNick())) ;
+			return dir * compareSortKey( GetSortKeys( u2 )[col], GetSortKeys( u1 )[col] );
+		case 2:
+			return dir * compareSimple( u2->GetStatus().rank, u1->GetStatus().rank ) ;
 		default:
 			return 0;
 	}
 }
 
+void NickListCtrl::BuildSortKeys( DataType user, SortKeyVector& keys ) const
+{
+	keys.resize( 4 );
+	keys[1].text = FoldSortKey( TowxString(user->GetCountry()) );
+	keys[3].text = FoldSortKey( TowxString(user->GetNick()) );
+}
+
 int NickListCtrl::CompareUserStatus( DataType user1, DataType user2 )
 {
 
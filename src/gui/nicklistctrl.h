@@ -46,6 +46,8 @@ private:
 	int CompareOneCrit( DataType u1, DataType u2, int col, int dir ) const;
     //! utils func for comparing user status, so the CompareOneCrit doesn't get too crowded
     static int CompareUserStatus( DataType u1, DataType u2 );
+    friend class CustomVirtListCtrl< const User* ,NickListCtrl >;
+    void BuildSortKeys( DataType user, SortKeyVector& keys ) const;
     //! required per base clase
     virtual void Sort( );
 
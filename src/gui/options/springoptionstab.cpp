@@ -42,6 +42,7 @@
 #include "settings.h"
 #include "gui/mainwindow.h"
 #include "gui/customdialogs.h"
+#include "contentregistry.h"
 #include <lslunitsync/springbundle.h>
 #include <lslunitsync/unitsync.h>
 
@@ -298,6 +299,7 @@ void SpringOptionsTab::OnApply( wxCommandEvent& /*unused*/ )
 	const std::string index = STD_STRING(m_spring_list->GetStringSelection());
 	if (index.empty()) {
 		LSL::usync().FreeUnitSyncLib();
+		contentRegistry().Invalidate();
 		return;
 	}
 
@@ -387,6 +389,8 @@ void SpringOptionsTab::SwitchUnitsync(const std::string& newIndex, const std::st
 
 	UiEvents::ScopedStatusMessage( _("Reloading unitsync"), 0 );
 	SlPaths::SetUsedSpringIndex(newIndex);
+	// ask unitsync directly until the index of the new library is built
+	contentRegistry().Invalidate();
 	if (!LSL::usync().LoadUnitSyncLib(SlPaths::GetUnitSync(newIndex))) { //FIXME: make LoadUnitSyncLib() async (partly done)
 		wxLogWarning( _T( "Cannot load UnitSync" ) );
 		notifyBox->Show(false);
@@ -396,6 +400,8 @@ void SpringOptionsTab::SwitchUnitsync(const std::string& newIndex, const std::st
 						  _( "Spring error" ), wxOK );
 		SlPaths::SetUsedSpringIndex(oldIndex);
 		DoRestore();
+	} else {
+		contentRegistry().Rebuild();
 	}
 
 	notifyBox->Show(false);
@@ -95,6 +95,17 @@ void PlaybackListCtrl::RemovePlayback( const StoredGame& replay )
     wxLogError( _T("Didn't find the replay to remove.") );
 }
 
+bool PlaybackListCtrl::UpdatePlayback( const StoredGame& replay )
+{
+    const int index = GetIndexFromData( &replay );
+    if ( index == -1 )
+        return false;
+
+    InvalidateSortKeys( &replay );
+    RefreshItem( index );
+    return true;
+}
+
 void PlaybackListCtrl::OnDLMap( wxCommandEvent& /*unused*/ )
 {
     if (GetSelectedIndex() >= 0) {
@@ -115,7 +126,7 @@ void PlaybackListCtrl::Sort()
 {
     if ( m_data.size() > 0 ) {
         SaveSelection();
-        SLInsertionSort( m_data, m_comparator );
+        SortByKeys();
         RestoreSelection();
     }
 }
@@ -124,17 +135,26 @@ int PlaybackListCtrl::CompareOneCrit( DataType u1, DataType u2, int col, int dir
 {
     switch ( col ) {
         case 0: return dir * compareSimple( u1->date, u2->date );
-        case 1: return dir * TowxString(u1->battle.GetHostModName()).CmpNoCase( TowxString(u2->battle.GetHostModName()) );
-        case 2: return dir * TowxString(u1->battle.GetHostMapName()).CmpNoCase( TowxString(u2->battle.GetHostMapName()) );
+        case 1:
+        case 2:
+        case 5:
+        case 7: return dir * compareSortKey( GetSortKeys( u1 )[col], GetSortKeys( u2 )[col] );
         case 3: return dir * compareSimple( u1->battle.GetNumUsers() - u1->battle.GetSpectators(), u2->battle.GetNumUsers() - u2->battle.GetSpectators() );
         case 4: return dir * compareSimple( u1->duration,u2->duration );
-        case 5: return dir * TowxString(u1->SpringVersion).CmpNoCase( TowxString(u2->SpringVersion) ) ;
         case 6: return dir * compareSimple( u1->size, u2->size ) ;
-        case 7: return dir * TowxString(u1->Filename).AfterLast( wxFileName::GetPathSeparator() ).CmpNoCase( TowxString(u2->Filename).AfterLast( wxFileName::GetPathSeparator() ) );
         default: return 0;
     }
 }
 
+void PlaybackListCtrl::BuildSortKeys( DataType replay, SortKeyVector& keys ) const
+{
+    keys.resize( 8 );
+    keys[1].text = FoldSortKey( TowxString(replay->battle.GetHostModName()) );
+    keys[2].text = FoldSortKey( TowxString(replay->battle.GetHostMapName()) );
+    keys[5].text = FoldSortKey( TowxString(replay->SpringVersion) );
+    keys[7].text = FoldSortKey( TowxString(replay->Filename).AfterLast( wxFileName::GetPathSeparator() ) );
+}
+
 void PlaybackListCtrl::SetTipWindowText( const long item_hit, const wxPoint& position)
 {
     if ( item_hit < 0 || item_hit >= (long)m_data.size() )
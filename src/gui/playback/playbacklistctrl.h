@@ -18,6 +18,8 @@ public:
     void AddPlayback( const StoredGame& replay );
     void RemovePlayback( const StoredGame& replay );
     void RemovePlayback( const int index );
+    //! returns false if the replay isn't in the list
+    bool UpdatePlayback( const StoredGame& replay );
     void OnListRightClick( wxListEvent& event );
     void OnDLMap( wxCommandEvent& event );
     void OnDLMod( wxCommandEvent& event );
@@ -36,6 +38,8 @@ public:
 
 private:
 	int CompareOneCrit( DataType u1, DataType u2, int col, int dir ) const;
+	friend class CustomVirtListCtrl< const StoredGame*, PlaybackListCtrl >;
+	void BuildSortKeys( DataType replay, SortKeyVector& keys ) const;
 	void OnChar(wxKeyEvent & event);
     virtual void Sort();
 
@@ -27,6 +27,7 @@
 #include "iconimagelist.h"
 #include "storedgame.h"
 #include "utils/conversion.h"
+#include "contentregistry.h"
 
 #include "gui/customdialogs.h"
 #include "gui/hosting/battleroomlistctrl.h"
@@ -157,6 +158,8 @@ PlaybackTab::PlaybackTab( wxWindow* parent, bool replay):
 	SetScrollRate( SCROLL_RATE, SCROLL_RATE );
 	Layout();
 	ConnectGlobalEvent(this, GlobalEvent::OnUnitsyncReloaded, wxObjectEventFunction(&PlaybackTab::OnUnitsyncReloaded));
+	m_content_serial = contentRegistry().GetSerial();
+	ConnectGlobalEvent(this, GlobalEvent::OnContentAdded, wxObjectEventFunction(&PlaybackTab::OnContentAdded));
 	ConnectGlobalEvent(this, GlobalEvent::OnSpringTerminated, wxObjectEventFunction(&PlaybackTab::OnSpringTerminated));
 }
 
@@ -220,11 +223,7 @@ void PlaybackTab::UpdatePlayback( const StoredGame& replay )
 		return;
 	}
 
-	int index = m_replay_listctrl->GetIndexFromData( &replay );
-
-	if ( index != -1 )
-		m_replay_listctrl->RefreshItem( index );
-	else
+	if ( !m_replay_listctrl->UpdatePlayback( replay ) )
 		AddPlayback( replay );
 
 }
@@ -411,6 +410,24 @@ void PlaybackTab::OnUnitsyncReloaded( wxCommandEvent& /*data*/ )
 	ReloadList();
 }
 
+void PlaybackTab::OnContentAdded( wxCommandEvent& data )
+{
+	std::vector<ContentRegistry::Entry> added;
+	if ( !contentRegistry().GetAddedSince( m_content_serial, added ) ) {
+		OnUnitsyncReloaded( data );
+		return;
+	}
+	// the replay files didn't change, only the rows of the new content need an update
+	const auto& replays = replaylist().GetPlaybacksMap();
+	for ( auto i = replays.begin(); i != replays.end(); ++i ) {
+		const OfflineBattle& battle = i->second.battle;
+		if ( ContentRegistry::Contains( added, ContentRegistry::CT_MAP, battle.GetHostMapName() ) ||
+		     ContentRegistry::Contains( added, ContentRegistry::CT_GAME, battle.GetHostModName() ) )
+			UpdatePlayback( i->second );
+	}
+	m_replay_listctrl->RefreshVisibleItems();
+}
+
 void PlaybackTab::OnChar(wxKeyEvent & event)
 {
 	const int keyCode = event.GetKeyCode();
@@ -71,6 +71,8 @@ private:
 
     void OnSpringTerminated( wxCommandEvent& data );
 	void OnUnitsyncReloaded( wxCommandEvent& data );
+	//! updates only the replays of new maps and games
+	void OnContentAdded( wxCommandEvent& data );
 
 private:
 	void OnChar(wxKeyEvent & event);
@@ -94,6 +96,7 @@ private:
 
     wxCheckBox* m_filter_activ;
 	bool m_isreplay;
+	unsigned int m_content_serial; //! see ContentRegistry::GetAddedSince
 #if wxUSE_TOGGLEBTN
 		wxToggleButton* m_filter_show;
 #else
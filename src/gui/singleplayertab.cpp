@@ -26,6 +26,7 @@
 #include "hosting/addbotdialog.h"
 #include "iserver.h"
 #include "settings.h"
+#include "contentregistry.h"
 #include "gui/colorbutton.h"
 #include "aui/auimanager.h"
 #include "gui/customdialogs.h"
@@ -153,6 +154,8 @@ SinglePlayerTab::SinglePlayerTab(wxWindow* parent, MainSinglePlayerTab& msptab):
     ReloadMaplist();
     ReloadModlist();
 	ConnectGlobalEvent(this, GlobalEvent::OnUnitsyncReloaded, wxObjectEventFunction(&SinglePlayerTab::OnUnitsyncReloaded));
+	m_content_serial = contentRegistry().GetSerial();
+	ConnectGlobalEvent(this, GlobalEvent::OnContentAdded, wxObjectEventFunction(&SinglePlayerTab::OnContentAdded));
 }
 
 
@@ -353,6 +356,33 @@ void SinglePlayerTab::OnUnitsyncReloaded( wxCommandEvent& /*data*/ )
 }
 
 
+//! insert @p name before the "-- Select one --" entry at the end, keeping the selection
+static void AddToPick( wxChoice* pick, const wxString& name )
+{
+	if ( pick->FindString( name ) != wxNOT_FOUND ) return;
+	const wxString selected = pick->GetStringSelection();
+	pick->Insert( name, pick->GetCount() - 1 );
+	pick->SetStringSelection( selected );
+}
+
+void SinglePlayerTab::OnContentAdded( wxCommandEvent& data )
+{
+	std::vector<ContentRegistry::Entry> added;
+	if ( !contentRegistry().GetAddedSince( m_content_serial, added ) ) {
+		OnUnitsyncReloaded( data );
+		return;
+	}
+	for ( size_t i = 0; i < added.size(); i++ ) {
+		if ( added[i].type == ContentRegistry::CT_MAP ) {
+			AddToPick( m_map_pick, TowxString( added[i].name ) );
+		} else if ( added[i].type == ContentRegistry::CT_GAME ) {
+			AddToPick( m_mod_pick, TowxString( added[i].name ) );
+		}
+	}
+	if ( ContentRegistry::Contains( added, ContentRegistry::CT_MAP, m_battle.GetHostMapName() ) ) UpdateMinimap();
+}
+
+
 void SinglePlayerTab::OnStart( wxCommandEvent& /*unused*/ )
 {
     slLogDebugFunc("SP: ");
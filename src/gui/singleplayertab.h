@@ -50,6 +50,8 @@ class SinglePlayerTab: public wxScrolledWindow, public GlobalEvent
     void OnReset( wxCommandEvent& event );
 
     void OnUnitsyncReloaded( wxCommandEvent& /*data*/ );
+    //! adds new maps and games to the lists
+    void OnContentAdded( wxCommandEvent& data );
 	void ResetUsername();
 
     void SetMap( unsigned int index );
@@ -75,6 +77,7 @@ private:
 
     wxListCtrl* m_map_opts_list;
     wxStaticText* m_map_desc;
+    unsigned int m_content_serial; //! see ContentRegistry::GetAddedSince
 
     enum
     {
@@ -33,6 +33,7 @@
 #include "iserver.h"
 #include "serverselector.h"
 #include "spring.h"
+#include "springprocess.h"
 #include "channel.h"
 #include "gui/connectwindow.h"
 #include "gui/mainwindow.h"
@@ -55,6 +56,8 @@
 #include "updatehelper.h"
 #include "gui/customdialogs.h"
 #include "versionchecker.h"
+#include "startuploader.h"
+#include "contentregistry.h"
 #include "gui/textentrydialog.h"
 #include "log.h"
 #include "settings.h"
@@ -86,7 +89,8 @@ Ui::Ui() :
 	m_main_win(0),
 	m_con_win(0),
 	m_first_update_trigger(true),
-	m_battle_info_updatedSink( this, &BattleEvents::GetBattleEventSender( ( BattleEvents::BattleInfoUpdate ) ) )
+	m_battle_info_updatedSink( this, &BattleEvents::GetBattleEventSender( ( BattleEvents::BattleInfoUpdate ) ) ),
+	m_battle_tags_updatedSink( this, &BattleEvents::GetBattleTagsEventSender() )
 {
 	m_main_win = new MainWindow( );
 	CustomMessageBoxBase::setLobbypointer(m_main_win);
@@ -447,7 +451,7 @@ bool Ui::IsSpringCompatible(const std::string& engine, const std::string& versio
 		if ( SlPaths::GetCurrentUsedSpringIndex() != ver ) {
 			wxLogMessage(_T("server enforce usage of version: %s, switching to profile: %s"), TowxString(ver).c_str(), TowxString(ver).c_str());
 			SlPaths::SetUsedSpringIndex( ver );
-			LSL::usync().ReloadUnitSyncLib();
+			contentRegistry().ReloadUnitsync();
 		}
 		return true;
 	}
@@ -459,6 +463,12 @@ bool Ui::DownloadArchives(const IBattle& battle)
 	const std::string engineVersion = battle.GetBattleOptions().engineVersion;
 	const std::string engineName = battle.GetBattleOptions().engineName;
 
+	if ( !startupLoader().IsFinished() ) {
+		// installed engines and content aren't known yet, don't offer downloads for them
+		customMessageBoxNoModal( SL_MAIN_ICON, _("SpringLobby is still searching installed engines and content, please try again in a moment."), _("Please wait") );
+		return false;
+	}
+
 	if ( !IsSpringCompatible(engineName, engineVersion)) {
         wxLogWarning( _T( "trying to join battles with incompatible spring version" ) );
 
@@ -466,7 +476,7 @@ bool Ui::DownloadArchives(const IBattle& battle)
 						wxFormat(_("The selected preset requires the engine '%s' version '%s'. Should it be downloaded?")) % engineName % engineVersion,
 						_("Engine missing"),
 						wxYES_NO ) ) {
-			Download(PrDownloader::GetEngineCat(), engineVersion, "");
+			prDownloader().GetDownload(PrDownloader::GetEngineCat(), engineVersion, PrDownloader::PRIO_BATTLE);
 			return true;
 		}
 	}
@@ -492,10 +502,10 @@ bool Ui::DownloadArchives(const IBattle& battle)
 	if ( customMessageBox( SL_MAIN_ICON, wxFormat(_( "You need to download %s to be able to play.\n\n Shall I download it?" )) % prompt,
 						   _( "Content needed to be downloaded" ), wxYES_NO | wxICON_QUESTION ) == wxYES ) {
 		if (!battle.MapExists()) {
-			ui().Download("map", battle.GetHostMapName(), battle.GetHostMapHash());
+			prDownloader().GetDownload("map", battle.GetHostMapName(), PrDownloader::PRIO_BATTLE);
 		}
 		if (!battle.ModExists()) {
-			ui().Download("game", battle.GetHostModName(), battle.GetHostModHash());
+			prDownloader().GetDownload("game", battle.GetHostModName(), PrDownloader::PRIO_BATTLE);
 		}
 		return true;
 	}
@@ -736,8 +746,7 @@ void Ui::OnUserLeftBattle( IBattle& battle, User& user, bool isbot )
 {
 	assert(wxThread::IsMain());
 	if ( m_main_win == 0 ) return;
-	user.SetSideiconIndex( -1 ); //just making sure he's not running around with some icon still set
-	user.BattleStatus().side = 0; // and reset side, so after rejoin we don't potentially stick with a num higher than avail
+	user.BattleStatus().side = 0; // reset side, so after rejoin we don't potentially stick with a num higher than avail
 	mw().GetBattleListTab().UpdateBattle( battle );
 	try {
 		if ( mw().GetJoinTab().GetBattleRoomTab().GetBattle() == &battle ) {
@@ -772,6 +781,19 @@ void Ui::OnBattleInfoUpdated( BattleEvents::BattleEventData data )
 	}
 }
 
+void Ui::OnBattleTagsUpdated( BattleEvents::BattleTagsEventData data )
+{
+	IBattle& battle = *data.first;
+	if ( m_main_win == 0 ) return;
+	mw().GetBattleListTab().UpdateBattle( battle );
+	if ( mw().GetJoinTab().GetCurrentBattle() == &battle ) {
+		// only the changed rows, start positions already refreshed the tabs through OnUserBattleStatus
+		const std::vector<std::string>& tags = data.second;
+		for ( size_t i = 0; i < tags.size(); i++ )
+			mw().GetJoinTab().UpdateCurrentBattle( TowxString( tags[i] ) );
+	}
+}
+
 void Ui::OnJoinedBattle( IBattle& battle )
 {
 	if ( m_main_win == 0 ) return;
@@ -847,6 +869,9 @@ void Ui::OnSpringTerminated( wxCommandEvent& data  )
 
 	if (exit_code != 0) {
 		SpringDebugReport report;
+		const std::string output = GetSpringOutput();
+		if ( !output.empty() )
+			report.AddText( _T("engineoutput.txt"), TowxString( output ), _T("Engine output") );
 		if ( wxDebugReportPreviewStd().Show( report ) )
 			report.Process();
 	}
@@ -99,6 +99,7 @@ public:
 	void OnUserJoinedBattle( IBattle& battle, User& user );
 	void OnUserLeftBattle( IBattle& battle, User& user, bool isbot );
 	void OnBattleInfoUpdated( BattleEvents::BattleEventData data );
+	void OnBattleTagsUpdated( BattleEvents::BattleTagsEventData data );
 	void OnBattleStarted( IBattle& battle );
 
 	void OnJoinedBattle( IBattle& battle );
@@ -154,6 +155,8 @@ private:
 
 	EventReceiverFunc<Ui, BattleEvents::BattleEventData, &Ui::OnBattleInfoUpdated>
 	m_battle_info_updatedSink;
+	EventReceiverFunc<Ui, BattleEvents::BattleTagsEventData, &Ui::OnBattleTagsUpdated>
+	m_battle_tags_updatedSink;
 };
 
 Ui& ui();
@@ -27,6 +27,7 @@ lsl/battle/ibattle.cpp
 
 #include "lslutils/globalsmanager.h"
 #include "ibattle.h"
+#include "contentregistry.h"
 #include "utils/conversion.h"
 #include "gui/uiutils.h"
 #include "settings.h"
@@ -103,59 +104,36 @@ int IBattle::GetPlayerNum( const User& user ) const
 	return -1;
 }
 
-class DismissColor
+static ColourAllocator::RGB ToAllocatorColour( const LSL::lslColor& col )
 {
-private:
-	typedef std::vector<LSL::lslColor>
-	ColorVec;
-	const ColorVec& m_other;
-
-public:
-	DismissColor( const ColorVec& other )
-		: m_other( other )
-	{}
-
-	bool operator() ( LSL::lslColor to_check ) {
-		return std::find ( m_other.begin(), m_other.end(), to_check ) != m_other.end();
-	}
-};
+	return ColourAllocator::RGB( col.Red(), col.Green(), col.Blue() );
+}
 
-class AreColoursSimilarProxy
+static LSL::lslColor FromAllocatorColour( const ColourAllocator::RGB& col )
 {
-	int m_mindiff;
-
-public:
-	AreColoursSimilarProxy( int mindiff )
-		: m_mindiff ( mindiff )
-	{}
-
-	bool operator() ( LSL::lslColor a, LSL::lslColor b ) {
-		return AreColoursSimilar( a, b, m_mindiff );
-	}
-};
+	return LSL::lslColor( col.r, col.g, col.b );
+}
 
 LSL::lslColor IBattle::GetFreeColour( User * ) const
 {
-	typedef std::vector<LSL::lslColor>
-	ColorVec;
-
-	ColorVec current_used_colors;
+	std::vector<ColourAllocator::RGB> used;
+	used.reserve( GetNumUsers() );
 	for ( user_map_t::size_type i = 0; i < GetNumUsers(); ++i ) {
-		UserBattleStatus& bs = GetUser( i ).BattleStatus();
-		current_used_colors.push_back( bs.colour );
+		used.push_back( ToAllocatorColour( GetUser( i ).BattleStatus().colour ) );
 	}
+	return FromAllocatorColour( m_colour_allocator.GetFree( used ) );
+}
 
-	int inc = 1;
-	while ( true ) {
-		ColorVec fixcolourspalette = GetFixColoursPalette( m_teams_sizes.size() + inc++ );
-
-		ColorVec::iterator fixcolourspalette_new_end = std::unique( fixcolourspalette.begin(), fixcolourspalette.end(), AreColoursSimilarProxy( 20 ) );
-
-		fixcolourspalette_new_end = std::remove_if( fixcolourspalette.begin(), fixcolourspalette.end(), DismissColor( current_used_colors ) );
-
-		if ( fixcolourspalette_new_end != fixcolourspalette.begin() )
-			return (*fixcolourspalette.begin());
-	}
+std::vector<LSL::lslColor> IBattle::GetSeparatedColours( const LSL::lslColor& fixed, const std::vector<LSL::lslColor>& wanted ) const
+{
+	std::vector<ColourAllocator::RGB> in;
+	in.reserve( wanted.size() );
+	for ( size_t i = 0; i < wanted.size(); ++i ) in.push_back( ToAllocatorColour( wanted[i] ) );
+	const std::vector<ColourAllocator::RGB> res = m_colour_allocator.Assign( std::vector<ColourAllocator::RGB>( 1, ToAllocatorColour( fixed ) ), in );
+	std::vector<LSL::lslColor> out;
+	out.reserve( res.size() );
+	for ( size_t i = 0; i < res.size(); ++i ) out.push_back( FromAllocatorColour( res[i] ) );
+	return out;
 }
 
 LSL::lslColor IBattle::GetFreeColour( User &for_whom ) const
@@ -198,9 +176,6 @@ int IBattle::GetClosestFixColour(const LSL::lslColor &col, const std::vector<int
 {
 	std::vector<LSL::lslColor> palette = GetFixColoursPalette( m_teams_sizes.size() + 1 );
 	int result=0;
-	int t1=palette.size();
-	int t2=excludes.size();
-	wxLogMessage(_T("GetClosestFixColour %d %d"),t1,t2);
 	for (size_t i=0; i<palette.size(); ++i) {
 		if ((i>=excludes.size()) || (!excludes[i])) {
 			if (AreColoursSimilar( palette[i],col, difference )) {
@@ -765,17 +740,17 @@ std::string IBattle::GetHostModHash() const
 bool IBattle::MapExists(bool comparehash) const
 {
 	if (comparehash) {
-		return LSL::usync().MapExists( m_host_map.name, m_host_map.hash );
+		return contentRegistry().MapExists( m_host_map.name, m_host_map.hash );
 	}
-	return LSL::usync().MapExists( m_host_map.name, "");
+	return contentRegistry().MapExists( m_host_map.name );
 }
 
 
 bool IBattle::ModExists(bool comparehash) const
 {
 	if (comparehash)
-		return LSL::usync().ModExists( m_host_mod.name, m_host_mod.hash );
-	return LSL::usync().ModExists( m_host_mod.name, "");
+		return contentRegistry().GameExists( m_host_mod.name, m_host_mod.hash );
+	return contentRegistry().GameExists( m_host_mod.name );
 }
 
 void IBattle::RestrictUnit( const std::string& unitname, int count )
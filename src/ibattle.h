@@ -22,6 +22,7 @@ lsl/battle/ibattle.h
 #include "user.h"
 #include "userlist.h"
 #include "utils/mixins.h"
+#include "utils/colourallocator.h"
 #include <lslunitsync/optionswrapper.h>
 
 const unsigned int DEFAULT_SERVER_PORT = 8452;
@@ -289,6 +290,8 @@ public:
 	virtual LSL::lslColor GetFreeColour( User &for_whom ) const;
 	virtual LSL::lslColor GetFreeColour( User *for_whom = NULL ) const;
 	virtual LSL::lslColor GetNewColour() const;
+	//! perceptually separated colours for @p wanted team colours, @p fixed never changes
+	std::vector<LSL::lslColor> GetSeparatedColours( const LSL::lslColor& fixed, const std::vector<LSL::lslColor>& wanted ) const;
 	virtual int ColourDifference(const LSL::lslColor &a, const LSL::lslColor &b)  const;
 
 	virtual User& GetFounder() const;
@@ -565,6 +568,7 @@ protected:
 	std::map<std::string, time_t> m_ready_up_map; // player name -> time counting from join/unspect
 	std::string m_previous_local_mod_name;
 	LSL::UnitsyncMod m_local_mod;
+	ColourAllocator m_colour_allocator;
 
 private:
 	void LoadScriptMMOpts( const std::string& sectionname, const LSL::TDF::PDataList& node );
@@ -10,10 +10,13 @@
 #include <wx/settings.h>
 #include <wx/dc.h>
 #include <wx/icon.h>
+#include <wx/log.h>
 
 #include "iconimagelist.h"
 #include "user.h"
 #include "battle.h"
+#include "contentregistry.h"
+#include "utils/globalevents.h"
 #define HAVE_WX
 #include <lslunitsync/image.h>
 #include <lslunitsync/unitsync.h>
@@ -90,7 +93,37 @@
 #include "utils/conversion.h"
 #include "utils/lslconversion.h"
 
-IconImageList::IconImageList() : wxImageList(16,16,true)
+//! number of ranks, ICON_RANK1 to ICON_RANK8
+static const int RANK_COUNT = 8;
+
+//! side and colour icons kept in the image list, older ones are replaced
+static const size_t MAX_SIDE_ICONS = 64;
+static const size_t MAX_COLOUR_ICONS = 64;
+
+//! wxImageList is no event handler, this one forwards OnContentAdded to it
+class IconContentListener : public wxEvtHandler, public GlobalEvent
+{
+public:
+	explicit IconContentListener( IconImageList& icons ):
+		m_icons( icons )
+	{
+		ConnectGlobalEvent(this, GlobalEvent::OnContentAdded, wxObjectEventFunction(&IconContentListener::OnContentAdded));
+	}
+
+	void OnContentAdded( wxCommandEvent& /*data*/ )
+	{
+		m_icons.OnContentAdded();
+	}
+
+private:
+	IconImageList& m_icons;
+};
+
+IconImageList::IconImageList() : wxImageList(16,16,true),
+	m_side_icons( MAX_SIDE_ICONS ),
+	m_content_listener( new IconContentListener( *this ) ),
+	m_content_serial( 0 ),
+	m_colour_icons( MAX_COLOUR_ICONS )
 {
     ICON_ADMIN = Add( charArr2wxBitmap( admin_png, sizeof(admin_png) ) );
     ICON_ADMIN_AWAY = Add( charArr2wxBitmap( admin_away_png, sizeof(admin_away_png) ) );
@@ -125,24 +158,12 @@ IconImageList::IconImageList() : wxImageList(16,16,true)
 	ICON_RANK8 = Add( wxBitmap(rank7_xpm) );
 	ICON_SPRINGLOBBY = Add(wxBitmap(springlobby_xpm));
 
-	m_rank_requirements.push_back(ICON_RANK1);
-	m_rank_requirements.push_back(ICON_RANK2);
-	m_rank_requirements.push_back(ICON_RANK3);
-	m_rank_requirements.push_back(ICON_RANK4);
-	m_rank_requirements.push_back(ICON_RANK5);
-	m_rank_requirements.push_back(ICON_RANK6);
-	m_rank_requirements.push_back(ICON_RANK7);
-	m_rank_requirements.push_back(ICON_RANK8);
-
-	wxBitmap major_bitmap(major_xpm);
-	wxBitmap minor_bitmap(minor_xpm);
-	m_minimum_rank_requirement_border = m_rank_requirements.size();
-	for ( int i = 0; i < m_minimum_rank_requirement_border; i++)
-	{
-		wxBitmap to_blend= GetBitmap(m_rank_requirements[i]);
-		m_rank_requirements[i] = Add( BlendBitmaps( to_blend, major_bitmap ) ); // replace old with blended with major
-		m_rank_requirements.push_back( Add( BlendBitmaps( to_blend, minor_bitmap ) ) ); // add new blended with minor
-	}
+	const wxBitmap empty(empty_xpm);
+
+	// ranks blended with major for rank limits, then blended with minor for maximum ranks
+	m_minimum_rank_requirement_border = RANK_COUNT;
+	for ( int i = 0; i < 2 * RANK_COUNT; i++ )
+		m_rank_requirements.push_back( AddLazy( empty, &IconImageList::DecodeRankLimit, i ) );
 
     ICON_READY = ICON_OPEN_GAME = Add( charArr2wxBitmap(open_game_png, sizeof(open_game_png) ) );
     ICON_OPEN_PW_GAME = Add( charArr2wxBitmap(open_pw_game_png, sizeof(open_pw_game_png) ) );
@@ -183,9 +204,11 @@ IconImageList::IconImageList() : wxImageList(16,16,true)
 
     ICON_UNK_FLAG = Add( wxBitmap(unknown_flag_xpm) );
 
-    ICON_FLAGS_BASE = AddFlagImages( *this );
+    ICON_FLAGS_BASE = GetImageCount();
+    for ( int i = 0; i < GetFlagCount(); i++ )
+        AddLazy( empty, &IconImageList::DecodeFlag, i );
 
-    ICON_EMPTY = Add( wxBitmap(empty_xpm) );
+    ICON_EMPTY = Add( empty );
 
     ICON_NONE = ICON_NOSTATE = ICON_RANK_NONE = ICON_GAME_UNKNOWN = ICON_EMPTY;
 
@@ -194,6 +217,59 @@ IconImageList::IconImageList() : wxImageList(16,16,true)
 }
 
 
+int IconImageList::AddLazy( const wxBitmap& placeholder, Decoder decode, int arg )
+{
+	const int index = Add( placeholder );
+	if ( index >= (int)m_lazy_icons.size() )
+		m_lazy_icons.resize( index + 1 );
+	m_lazy_icons[index].decode = decode;
+	m_lazy_icons[index].arg = arg;
+	return index;
+}
+
+int IconImageList::Load( int index )
+{
+	if ( index < 0 || index >= (int)m_lazy_icons.size() ) return index;
+	LazyIcon& icon = m_lazy_icons[index];
+	if ( icon.decode == NULL ) return index;
+	Replace( index, (this->*icon.decode)( icon.arg ) );
+	icon.decode = NULL;
+	return index;
+}
+
+wxBitmap IconImageList::DecodeFlag( int flag ) const
+{
+	return GetFlagBitmap( flag );
+}
+
+wxBitmap IconImageList::DecodeRankLimit( int limit ) const
+{
+	const int ranks[RANK_COUNT] = { ICON_RANK1, ICON_RANK2, ICON_RANK3, ICON_RANK4, ICON_RANK5, ICON_RANK6, ICON_RANK7, ICON_RANK8 };
+	const wxBitmap overlay( ( limit < RANK_COUNT ) ? major_xpm : minor_xpm );
+	return BlendBitmaps( GetBitmap( ranks[limit % RANK_COUNT] ), overlay );
+}
+
+IconImageList::~IconImageList()
+{
+	delete m_content_listener;
+}
+
+void IconImageList::OnContentAdded()
+{
+	std::vector<ContentRegistry::Entry> added;
+	if ( !contentRegistry().GetAddedSince( m_content_serial, added ) ) {
+		m_side_icons.Erase( 0, UINT64_MAX );
+		return;
+	}
+	for ( size_t i = 0; i < added.size(); i++ ) {
+		if ( added[i].type != ContentRegistry::CT_GAME ) continue;
+		std::map<std::string, unsigned int>::const_iterator it = m_mod_ids.find( added[i].name );
+		if ( it == m_mod_ids.end() ) continue;
+		const uint64_t first = uint64_t( it->second ) << 32;
+		m_side_icons.Erase( first, first | 0xffffffff );
+	}
+}
+
 IconImageList& icons()
 {
     static IconImageList m_icons;
@@ -267,7 +343,7 @@ int IconImageList::GetRankIcon( const unsigned int& rank, const bool& showlowest
 	}
 }
 
-int IconImageList::GetRankLimitIcon( int rank,  bool showlowest )const
+int IconImageList::GetRankLimitIcon( int rank,  bool showlowest )
 {
     if ( !showlowest && rank == UserStatus::RANK_1 )
         return ICON_RANK_NONE;
@@ -276,15 +352,17 @@ int IconImageList::GetRankLimitIcon( int rank,  bool showlowest )const
 	{
 		rank = -rank -1 + m_minimum_rank_requirement_border;
 	}
-	if ( rank > int(m_rank_requirements.size()) ) return ICON_RANK_UNKNOWN;
+	if ( rank < 0 || rank >= int(m_rank_requirements.size()) ) return ICON_RANK_UNKNOWN;
 
-	return m_rank_requirements[rank];
+	return Load( m_rank_requirements[rank] );
 }
 
 
-int IconImageList::GetFlagIcon( const std::string& flagname )const
+int IconImageList::GetFlagIcon( const std::string& flagname )
 {
-    return ICON_FLAGS_BASE + GetFlagIndex(flagname);
+    const int flag = GetFlagIndex(flagname);
+    if ( flag == FLAG_NONE ) return ICON_UNK_FLAG;
+    return Load( ICON_FLAGS_BASE + flag );
 }
 
 
@@ -338,17 +416,33 @@ wxString IconImageList::GetBattleStatus( const IBattle& battle ) const
     // return _T("Game has unknown status");
 }
 
-wxString getColourIconKey( const wxColour& colour  )
+int IconImageList::AddCached( IconCache& cache, uint64_t key, const wxBitmap& bitmap )
 {
-	return colour.GetAsString(wxC2S_HTML_SYNTAX).AfterFirst('#');
+	cache.Evict();
+	int slot = cache.TakeFreeSlot();
+	if ( slot < 0 ) {
+		slot = Add( bitmap );
+	} else {
+		Replace( slot, bitmap );
+	}
+	cache.Insert( key, slot );
+	return slot;
+}
+
+void IconImageList::LogCacheStats( const wxChar* name, const IconCache& cache ) const
+{
+	const IconCache::Stats& stats = cache.GetStats();
+	wxLogDebug( _T("%s icon cache: %lu hits, %lu misses, %lu evictions"), name, stats.hits, stats.misses, stats.evictions );
 }
 
-int IconImageList::GetColourIcon( const LSL::lslColor& colour )  const
+int IconImageList::GetColourIcon( const LSL::lslColor& colour )
 {
-	const wxString key = getColourIconKey(lslTowxColour(colour));
-	PlayerColourMap::const_iterator it = m_player_colour_icons.find( key );
-	if ( it != m_player_colour_icons.end() && it->second != 0 ) return it->second;
-    else return -1;
+	const wxColour wxcolour = lslTowxColour(colour);
+	const uint64_t key = ( wxcolour.Red() << 16 ) | ( wxcolour.Green() << 8 ) | wxcolour.Blue();
+	const int slot = m_colour_icons.Find( key );
+	if ( slot >= 0 ) return slot;
+	if ( m_colour_icons.Size() == m_colour_icons.Capacity() ) LogCacheStats( _T("colour"), m_colour_icons );
+	return AddCached( m_colour_icons, key, getColourIcon( wxcolour ) );
 }
 
 
@@ -360,36 +454,34 @@ int IconImageList::GetHostIcon( const bool& spectator ) const
 
 void IconImageList::SetColourIcon( const LSL::lslColor& colour )
 {
-	const wxString key = getColourIconKey(lslTowxColour(colour));
-	if ( m_player_colour_icons.find( key ) == m_player_colour_icons.end() )
-		m_player_colour_icons[key] = Add(getColourIcon(lslTowxColour(colour)));
+	GetColourIcon( colour );
 }
 
 
 int IconImageList::GetSideIcon( const std::string& modname, int side )
 {
+	std::map<std::string, unsigned int>::const_iterator it = m_mod_ids.find( modname );
+	if ( it == m_mod_ids.end() )
+		it = m_mod_ids.insert( std::make_pair( modname, (unsigned int)m_mod_ids.size() ) ).first;
+	const uint64_t key = ( uint64_t( it->second ) << 32 ) | (unsigned int)side;
+	const int slot = m_side_icons.Find( key );
+	if ( slot >= 0 ) return slot;
+	if ( m_side_icons.Size() == m_side_icons.Capacity() ) LogCacheStats( _T("side"), m_side_icons );
+
 	const auto sides = LSL::usync().GetSides(modname);
 	std::string sidename;
-	if( side < (int)sides.size() ) {
+	if( side >= 0 && side < (int)sides.size() ) {
 		sidename = sides[side];
 	}
-	const std::string cachestring = modname + "_" + sidename;
-	if ( m_cached_side_icons.find(cachestring) != m_cached_side_icons.end()){ //already cached
-		return m_cached_side_icons[cachestring];
-	}
-
 	try {
 		const LSL::UnitsyncImage img = LSL::usync().GetSidePicture(modname, sidename);
-		int IconPosition = Add(wxBitmap( img.wxbitmap() ), wxNullBitmap);
-		m_cached_side_icons[cachestring] = IconPosition;
-		return IconPosition;
+		return AddCached( m_side_icons, key, wxBitmap( img.wxbitmap() ) );
 	} catch (...) {}
-	if ( side == 0 ) { //failed to load, store dummies in cache
-		m_cached_side_icons[cachestring] = ICON_SIDEPIC_0;
-	} else {
-		m_cached_side_icons[cachestring] = ICON_SIDEPIC_1;
-	}
-	return m_cached_side_icons[cachestring];
+	//failed to load, store dummies in cache
+	const int dummy = ( side == 0 ) ? ICON_SIDEPIC_0 : ICON_SIDEPIC_1;
+	m_side_icons.Evict();
+	m_side_icons.Insert( key, dummy, false );
+	return dummy;
 }
 
 int IconImageList::GetReadyIcon( const bool& spectator,const bool& ready, const unsigned int& sync, const bool& bot )
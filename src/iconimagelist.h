@@ -7,8 +7,10 @@
 #include <wx/imaglist.h>
 #include <map>
 #include <vector>
+#include "utils/iconcache.h"
 
 class IBattle;
+class IconContentListener;
 namespace LSL {
 	class lslColor;
 }
@@ -19,17 +21,18 @@ class IconImageList : public wxImageList
 {
   public:
     IconImageList();
+    ~IconImageList();
 
 	int GetUserListStateIcon( const UserStatus& us, bool chanop, bool inbroom ) const;
 	int GetUserBattleStateIcon( const UserStatus& us ) const;
 
-	int GetRankLimitIcon(  int rank, bool showlowest = true ) const;
+	int GetRankLimitIcon(  int rank, bool showlowest = true );
 	int GetRankIcon( const unsigned int& rank, const bool& showlowest = true ) const;
-	int GetFlagIcon( const std::string& flagname ) const;
+	int GetFlagIcon( const std::string& flagname );
     int GetBattleStatusIcon( const IBattle& battle ) const;
     wxString GetBattleStatus(const IBattle& battle) const;
 	int GetHostIcon( const bool& spectator = false ) const;
-	int GetColourIcon( const LSL::lslColor& colour ) const;
+	int GetColourIcon( const LSL::lslColor& colour );
 	void SetColourIcon( const LSL::lslColor& colour );
     int GetSideIcon( const std::string& modname, int side );
 	int GetReadyIcon( const bool& spectator, const bool& ready, const unsigned int& sync, const bool& bot );
@@ -113,11 +116,37 @@ class IconImageList : public wxImageList
 	int ICON_SPRINGLOBBY;
 
 private:
-    std::map<std::string, int> m_cached_side_icons;
-    // why map? because i already included and didn't want to include more stuff, it's not time-critical code anyway
-	typedef std::map<wxString, unsigned int>
-		PlayerColourMap;
-	PlayerColourMap m_player_colour_icons;
+	/** Icons that are rarely shown (flags, rank limits) get a placeholder slot
+	 * in the list and are decoded when their index is first requested.
+	 */
+	typedef wxBitmap (IconImageList::*Decoder)( int arg ) const;
+	struct LazyIcon
+	{
+		LazyIcon(): decode(NULL), arg(0) {}
+		Decoder decode; //! NULL once loaded
+		int arg;
+	};
+	int AddLazy( const wxBitmap& placeholder, Decoder decode, int arg );
+	//! decode the icon at index if it wasn't yet, returns index
+	int Load( int index );
+	wxBitmap DecodeFlag( int flag ) const;
+	wxBitmap DecodeRankLimit( int limit ) const;
+
+	std::vector<LazyIcon> m_lazy_icons; //! indexed by icon index
+
+	//! add or reuse a slot evicted from @p cache
+	int AddCached( IconCache& cache, uint64_t key, const wxBitmap& bitmap );
+	void LogCacheStats( const wxChar* name, const IconCache& cache ) const;
+
+	IconCache m_side_icons; //! key: mod id << 32 | side index
+	std::map<std::string, unsigned int> m_mod_ids;
+	//! drop the side icons of downloaded games, they were cached as dummies
+	void OnContentAdded();
+	friend class IconContentListener;
+	IconContentListener* m_content_listener;
+	//! newest ContentRegistry entry already handled
+	unsigned int m_content_serial;
+	IconCache m_colour_icons; //! key: packed rgb
 
 	std::vector<int> m_rank_requirements;
 	int m_minimum_rank_requirement_border;
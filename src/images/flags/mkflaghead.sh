@@ -1,6 +1,6 @@
 #!/usr/bin/env bash
 
-# This script autogenerates a flagimagedata.cpp file
+# This script autogenerates a flagimagedata.h file
 
 echo '/* This file is part of the Springlobby (GPL v2 or later), see COPYING */'
 echo ''
@@ -29,3 +29,25 @@ done
 echo '0'
 echo '};'
 echo
+echo '// index in flag_str of each country code, see FlagHash() in flagimages.cpp'
+echo 'static constexpr short flag_hash[26 * 26] = {'
+
+declare -A index
+i=0
+for img in *.xpm ; do
+  index[${img%%.xpm}]=$i
+  i=$((i + 1))
+done
+
+for a in {A..Z} ; do
+  line=''
+  for b in {A..Z} ; do
+    line="$line${index[$a$b]:--1},"
+  done
+  echo "$line"
+done
+
+echo '};'
+echo
+echo '//! the only code with three letters'
+echo "static constexpr short flag_fam = ${index[FAM]};"
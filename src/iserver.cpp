@@ -18,6 +18,7 @@
 
 IServer::IServer():
 battles_iter(new BattleList_Iter(&m_battles)),
+m_me(NULL),
 m_pass_hash(false)
 {
 	m_sock = new Socket( *this);
@@ -32,6 +33,17 @@ IServer::~IServer()
 }
 
 
+void IServer::BeginSendBatch()
+{
+	if ( m_sock ) m_sock->BeginBatch();
+}
+
+void IServer::EndSendBatch()
+{
+	if ( m_sock ) m_sock->EndBatch();
+}
+
+
 User& IServer::GetUser( const wxString& nickname ) const
 {
 	ASSERT_EXCEPTION(!nickname.empty(), _T("GetUser with empty nickname called"));
@@ -39,6 +51,27 @@ User& IServer::GetUser( const wxString& nickname ) const
 }
 
 
+const User& IServer::GetMe() const
+{
+	if ( m_me == NULL ) m_me = &GetUser( m_user );
+	return *m_me;
+}
+
+
+User& IServer::GetMe()
+{
+	if ( m_me == NULL ) m_me = &GetUser( m_user );
+	return *m_me;
+}
+
+
+bool IServer::IsMe( const std::string& nick ) const
+{
+	if ( m_me != NULL ) return m_me->GetNick() == nick;
+	return !m_user.empty() && STD_STRING(m_user) == nick;
+}
+
+
 bool IServer::UserExists( const wxString& nickname ) const
 {
   return m_users.UserExists(STD_STRING(nickname));
@@ -98,6 +131,7 @@ void IServer::_RemoveUser( const wxString& nickname )
   try{
     User* u = &m_users.GetUser(STD_STRING(nickname));
     m_users.RemoveUser(STD_STRING(nickname));
+    if ( u == m_me ) m_me = NULL;
     int numchannels = m_channels.GetNumChannels();
     for ( int i = 0; i < numchannels; i++ )
     {
@@ -150,6 +184,7 @@ void IServer::_RemoveBattle( const int& id )
 
 void IServer::OnDisconnected()
 {
+  m_me = NULL;
   while ( m_users.GetNumUsers() > 0 )
   {
     try
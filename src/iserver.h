@@ -133,9 +133,13 @@ class IServer : public iNetClass, public SL::NonCopyable
     virtual void RequestChannels() {};
 
     virtual void SendMyBattleStatus( UserBattleStatus& /*bs*/ ) {};
+
+    //! commands sent until the matching EndSendBatch() are written to the socket at once
+    void BeginSendBatch();
+    void EndSendBatch();
     virtual void SendMyUserStatus(const UserStatus& /*us*/) {};
 
-    virtual void SetUsername( const wxString& username ) { m_user = username; }
+    virtual void SetUsername( const wxString& username ) { m_user = username; m_me = NULL; }
 	virtual const wxString& GetUserName() const {return m_user; }
     virtual void SetPassword( const wxString& password ) { m_pass = password; }
 	virtual const wxString& GetPassword() const {return m_pass; }
@@ -154,8 +158,11 @@ class IServer : public iNetClass, public SL::NonCopyable
 
     BattleList_Iter* const battles_iter;
 
-    virtual const User& GetMe() const {return GetUser(m_user);};
-    virtual User& GetMe() {return GetUser(m_user);};
+    //! the local user, looked up once after login and kept until it is removed or the name changes
+    virtual const User& GetMe() const;
+    virtual User& GetMe();
+    //! compares against the cached local user, no user lookup
+    bool IsMe( const std::string& nick ) const;
     User& GetUser( const wxString& nickname ) const;
     bool UserExists( const wxString& nickname ) const;
 
@@ -168,6 +175,8 @@ class IServer : public iNetClass, public SL::NonCopyable
     bool BattleExists( const int& /*battleid*/ ) const;
 
     virtual int TestOpenPort( unsigned int /*port*/ ) const { return 0;};
+    //! free the nat traversal source port before the engine binds it
+    virtual void CloseUdpSocket() {};
 
     virtual void SendScriptToProxy( const wxString& /*script*/ ) {};
 
@@ -193,6 +202,7 @@ protected:
 
 private:
     wxString m_user;
+    mutable User* m_me;
     wxString m_pass;
 
     bool m_pass_hash;
@@ -0,0 +1,646 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        jsondocument.cpp
+// Purpose:     the wxJSONDocument class: a compact read-only JSON tree
+// Licence:     wxWidgets licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include <wx/jsondocument.h>
+#include <wx/jsonreader.h>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <climits>
+
+
+//! The key of values which are not members of an object
+static const wxUint32 wxJSONDOC_NO_KEY = 0xFFFFFFFF;
+
+
+/*******************************************************************
+
+            class wxJSONDocBuilder
+
+*******************************************************************/
+
+//! Builds a wxJSONDocument from the events of the SAX parser
+/*!
+ Completed values are kept on a stack. When an array or object is closed its
+ children are on top of the stack: they are moved to the document's arena in
+ one piece and replaced by the container's node.
+*/
+class wxJSONDocBuilder : public wxJSONSaxHandler
+{
+public:
+    wxJSONDocBuilder( wxJSONDocument& doc )
+        : m_doc( doc ), m_key( wxJSONDOC_NO_KEY )
+    {
+    }
+
+    void StartObject() { Open( wxJSONTYPE_OBJECT ); }
+    void EndObject()   { Close(); }
+    void StartArray()  { Open( wxJSONTYPE_ARRAY ); }
+    void EndArray()    { Close(); }
+
+    bool Key( const char* key, size_t len )
+    {
+        m_key = Intern( key, len );
+        return true;
+    }
+
+    void String( const char* str, size_t len )
+    {
+        wxJSONDocument::Node node = Make( wxJSONTYPE_STRING );
+        node.val.range.begin = Store( str, len );
+        node.val.range.size  = len;
+        m_stack.push_back( node );
+    }
+
+    void Int( wxInt64 i )
+    {
+        wxJSONDocument::Node node = Make( wxJSONTYPE_INT );
+        node.val.i = i;
+        m_stack.push_back( node );
+    }
+
+    void Double( double d )
+    {
+        wxJSONDocument::Node node = Make( wxJSONTYPE_DOUBLE );
+        node.val.d = d;
+        m_stack.push_back( node );
+    }
+
+    void Bool( bool b )
+    {
+        wxJSONDocument::Node node = Make( wxJSONTYPE_BOOL );
+        node.val.b = b;
+        m_stack.push_back( node );
+    }
+
+    void Null()
+    {
+        m_stack.push_back( Make( wxJSONTYPE_NULL ));
+    }
+
+    void Finish();
+
+private:
+    //! An array or object which is being read
+    struct Frame
+    {
+        wxUint8  type;
+        wxUint32 key;
+        size_t   start;    // the index of its first child on the stack
+    };
+
+    wxJSONDocument::Node Make( wxUint8 type );
+    void     Open( wxUint8 type );
+    void     Close();
+    wxUint32 Store( const char* str, size_t len );
+    wxUint32 Intern( const char* key, size_t len );
+
+    wxJSONDocument& m_doc;
+
+    //! The name of the next member, wxJSONDOC_NO_KEY in arrays
+    wxUint32 m_key;
+
+    std::vector<wxJSONDocument::Node> m_stack;
+    std::vector<Frame> m_frames;
+
+    //! The interned member names
+    std::map<std::string, wxUint32> m_interned;
+    std::string m_name;
+};
+
+wxJSONDocument::Node
+wxJSONDocBuilder::Make( wxUint8 type )
+{
+    wxJSONDocument::Node node;
+    node.type  = type;
+    node.key   = m_key;
+    node.val.i = 0;
+    m_key = wxJSONDOC_NO_KEY;
+    return node;
+}
+
+void
+wxJSONDocBuilder::Open( wxUint8 type )
+{
+    Frame frame;
+    frame.type  = type;
+    frame.key   = m_key;
+    frame.start = m_stack.size();
+    m_frames.push_back( frame );
+    m_key = wxJSONDOC_NO_KEY;
+}
+
+void
+wxJSONDocBuilder::Close()
+{
+    const Frame frame = m_frames.back();
+    m_frames.pop_back();
+
+    std::vector<wxJSONDocument::Node>::iterator first = m_stack.begin() + frame.start;
+    if ( frame.type == wxJSONTYPE_OBJECT )  {
+        // sort the members, if a name appears twice only the last value is kept
+        std::stable_sort( first, m_stack.end(), wxJSONDocument::ByKey );
+        std::vector<wxJSONDocument::Node>::iterator out = first;
+        for ( std::vector<wxJSONDocument::Node>::iterator it = first; it != m_stack.end(); ++it )  {
+            if ( it + 1 != m_stack.end() && ( it + 1 )->key == it->key )  {
+                continue;
+            }
+            *out++ = *it;
+        }
+        m_stack.erase( out, m_stack.end() );
+        first = m_stack.begin() + frame.start;
+    }
+
+    wxJSONDocument::Node node;
+    node.type = frame.type;
+    node.key  = frame.key;
+    node.val.range.begin = m_doc.m_nodes.size();
+    node.val.range.size  = m_stack.size() - frame.start;
+    m_doc.m_nodes.insert( m_doc.m_nodes.end(), first, m_stack.end() );
+    m_stack.resize( frame.start );
+    m_stack.push_back( node );
+}
+
+wxUint32
+wxJSONDocBuilder::Store( const char* str, size_t len )
+{
+    wxUint32 begin = m_doc.m_strings.size();
+    m_doc.m_strings.append( str, len );
+    m_doc.m_strings += '\0';
+    return begin;
+}
+
+wxUint32
+wxJSONDocBuilder::Intern( const char* key, size_t len )
+{
+    m_name.assign( key, len );
+    std::map<std::string, wxUint32>::const_iterator it = m_interned.find( m_name );
+    if ( it != m_interned.end() )  {
+        return it->second;
+    }
+    wxJSONDocument::Key k;
+    k.begin = Store( key, len );
+    k.size  = len;
+    wxUint32 id = m_doc.m_keys.size();
+    m_doc.m_keys.push_back( k );
+    m_interned.insert( std::make_pair( m_name, id ));
+    return id;
+}
+
+//! Stores the root and releases the unused memory
+void
+wxJSONDocBuilder::Finish()
+{
+    m_doc.m_nodes.insert( m_doc.m_nodes.end(), m_stack.begin(), m_stack.end() );
+
+    // the interned names are already sorted by the map
+    m_doc.m_sortedKeys.reserve( m_interned.size() );
+    for ( std::map<std::string, wxUint32>::const_iterator it = m_interned.begin(); it != m_interned.end(); ++it )  {
+        m_doc.m_sortedKeys.push_back( it->second );
+    }
+
+    std::vector<wxJSONDocument::Node>( m_doc.m_nodes ).swap( m_doc.m_nodes );
+    std::string( m_doc.m_strings ).swap( m_doc.m_strings );
+    std::vector<wxJSONDocument::Key>( m_doc.m_keys ).swap( m_doc.m_keys );
+}
+
+
+/*******************************************************************
+
+            class wxJSONDocument
+
+*******************************************************************/
+
+wxJSONDocument::wxJSONDocument()
+{
+}
+
+//! Parses a UTF-8 buffer and replaces the content of the document
+/*!
+ The text is parsed by the SAX mode of wxJSONReader, so it has to be
+ strict JSON.
+ If there are errors the document is empty.
+
+ @return the number of errors, see GetErrors()
+*/
+int
+wxJSONDocument::Parse( const char* utf8, size_t len )
+{
+    Clear();
+    wxJSONReader reader;
+    wxJSONDocBuilder builder( *this );
+    int errors = reader.Parse( utf8, len, builder );
+    if ( errors )  {
+        Clear();
+        m_errors = reader.GetErrors();
+        return errors;
+    }
+    builder.Finish();
+    return 0;
+}
+
+//! \overload Parse( const char*, size_t )
+int
+wxJSONDocument::Parse( const wxString& doc )
+{
+    wxCharBuffer utf8 = doc.ToUTF8();
+    return Parse( utf8.data(), strlen( utf8.data() ));
+}
+
+//! Removes all values
+void
+wxJSONDocument::Clear()
+{
+    std::vector<Node>().swap( m_nodes );
+    std::string().swap( m_strings );
+    std::vector<Key>().swap( m_keys );
+    std::vector<wxUint32>().swap( m_sortedKeys );
+    m_errors.Clear();
+}
+
+//! The top-level array or object, invalid if the document is empty
+wxJSONNode
+wxJSONDocument::GetRoot() const
+{
+    if ( m_nodes.empty() )  {
+        return wxJSONNode();
+    }
+    return wxJSONNode( this, m_nodes.size() - 1 );
+}
+
+const wxArrayString&
+wxJSONDocument::GetErrors() const
+{
+    return m_errors;
+}
+
+size_t
+wxJSONDocument::GetMemoryUsage() const
+{
+    return sizeof( *this )
+        + m_nodes.capacity() * sizeof( Node )
+        + m_strings.capacity()
+        + m_keys.capacity() * sizeof( Key )
+        + m_sortedKeys.capacity() * sizeof( wxUint32 );
+}
+
+//! Orders the members of an object by the number of their name
+bool
+wxJSONDocument::ByKey( const Node& a, const Node& b )
+{
+    return a.key < b.key;
+}
+
+//! Compares an interned name with a string, like memcmp()
+int
+wxJSONDocument::CompareKey( wxUint32 key, const char* str, size_t len ) const
+{
+    const Key& k = m_keys[key];
+    int res = memcmp( m_strings.data() + k.begin, str, std::min<size_t>( k.size, len ));
+    if ( res != 0 )  {
+        return res;
+    }
+    return ( k.size < len ) ? -1 : ( k.size > len ) ? 1 : 0;
+}
+
+//! Returns the number of a member name, -1 if no object has a member with this name
+int
+wxJSONDocument::FindKey( const char* key, size_t len ) const
+{
+    size_t lo = 0, hi = m_sortedKeys.size();
+    while ( lo < hi )  {
+        size_t mid = ( lo + hi ) / 2;
+        int res = CompareKey( m_sortedKeys[mid], key, len );
+        if ( res == 0 )  {
+            return m_sortedKeys[mid];
+        }
+        if ( res < 0 )  {
+            lo = mid + 1;
+        }
+        else  {
+            hi = mid;
+        }
+    }
+    return -1;
+}
+
+//! Returns the index of a member of an object node, -1 if it has no such member
+int
+wxJSONDocument::FindMember( wxUint32 index, const char* key, size_t len ) const
+{
+    const Node& node = m_nodes[index];
+    if ( node.type != wxJSONTYPE_OBJECT )  {
+        return -1;
+    }
+    int id = FindKey( key, len );
+    if ( id < 0 )  {
+        return -1;
+    }
+    const Node* first = &m_nodes[0] + node.val.range.begin;
+    const Node* last  = first + node.val.range.size;
+    Node search;
+    search.key = id;
+    const Node* it = std::lower_bound( first, last, search, ByKey );
+    if ( it == last || it->key != (wxUint32) id )  {
+        return -1;
+    }
+    return it - &m_nodes[0];
+}
+
+
+/*******************************************************************
+
+            class wxJSONNode
+
+*******************************************************************/
+
+//! Constructs an invalid node
+wxJSONNode::wxJSONNode()
+    : m_doc( 0 ), m_index( 0 )
+{
+}
+
+wxJSONNode::wxJSONNode( const wxJSONDocument* doc, wxUint32 index )
+    : m_doc( doc ), m_index( index )
+{
+}
+
+wxJSONType
+wxJSONNode::GetType() const
+{
+    if ( !m_doc )  {
+        return wxJSONTYPE_INVALID;
+    }
+    return (wxJSONType) m_doc->m_nodes[m_index].type;
+}
+
+bool
+wxJSONNode::IsValid() const
+{
+    return m_doc != 0;
+}
+
+bool
+wxJSONNode::IsNull() const
+{
+    return GetType() == wxJSONTYPE_NULL;
+}
+
+//! TRUE if the value is an integer that fits into an \b int
+bool
+wxJSONNode::IsInt() const
+{
+    if ( GetType() != wxJSONTYPE_INT )  {
+        return false;
+    }
+    wxInt64 i = m_doc->m_nodes[m_index].val.i;
+    return i >= INT_MIN && i <= INT_MAX;
+}
+
+//! TRUE if the value is an integer that fits into a \b long
+bool
+wxJSONNode::IsLong() const
+{
+    if ( GetType() != wxJSONTYPE_INT )  {
+        return false;
+    }
+    wxInt64 i = m_doc->m_nodes[m_index].val.i;
+    return i >= LONG_MIN && i <= LONG_MAX;
+}
+
+bool
+wxJSONNode::IsInt64() const
+{
+    return GetType() == wxJSONTYPE_INT;
+}
+
+bool
+wxJSONNode::IsDouble() const
+{
+    return GetType() == wxJSONTYPE_DOUBLE;
+}
+
+bool
+wxJSONNode::IsString() const
+{
+    return GetType() == wxJSONTYPE_STRING;
+}
+
+bool
+wxJSONNode::IsBool() const
+{
+    return GetType() == wxJSONTYPE_BOOL;
+}
+
+bool
+wxJSONNode::IsArray() const
+{
+    return GetType() == wxJSONTYPE_ARRAY;
+}
+
+bool
+wxJSONNode::IsObject() const
+{
+    return GetType() == wxJSONTYPE_OBJECT;
+}
+
+int
+wxJSONNode::AsInt() const
+{
+    return (int) AsInt64();
+}
+
+long int
+wxJSONNode::AsLong() const
+{
+    return (long int) AsInt64();
+}
+
+//! Returns the value of a number, ZERO for other types
+wxInt64
+wxJSONNode::AsInt64() const
+{
+    switch ( GetType() )  {
+        case wxJSONTYPE_INT :
+            return m_doc->m_nodes[m_index].val.i;
+        case wxJSONTYPE_DOUBLE :
+            return (wxInt64) m_doc->m_nodes[m_index].val.d;
+        default :
+            return 0;
+    }
+}
+
+//! Returns the value of a number, ZERO for other types
+double
+wxJSONNode::AsDouble() const
+{
+    switch ( GetType() )  {
+        case wxJSONTYPE_INT :
+            return (double) m_doc->m_nodes[m_index].val.i;
+        case wxJSONTYPE_DOUBLE :
+            return m_doc->m_nodes[m_index].val.d;
+        default :
+            return 0;
+    }
+}
+
+bool
+wxJSONNode::AsBool() const
+{
+    return GetType() == wxJSONTYPE_BOOL && m_doc->m_nodes[m_index].val.b;
+}
+
+//! Returns the value as a string
+/*!
+ As in wxJSONValue::AsString() numbers, booleans and null are converted to
+ their text; arrays and objects return an empty string.
+*/
+wxString
+wxJSONNode::AsString() const
+{
+    wxString s;
+    switch ( GetType() )  {
+        case wxJSONTYPE_STRING :
+            {
+                size_t len;
+                const char* str = AsUTF8( &len );
+                s = wxString::FromUTF8( str, len );
+            }
+            break;
+        case wxJSONTYPE_INT :
+            s.Printf( _T("%") wxLongLongFmtSpec _T("i"), m_doc->m_nodes[m_index].val.i );
+            break;
+        case wxJSONTYPE_DOUBLE :
+            s.Printf( _T("%.10g"), m_doc->m_nodes[m_index].val.d );
+            break;
+        case wxJSONTYPE_BOOL :
+            s.assign( m_doc->m_nodes[m_index].val.b ? _T("true") : _T("false") );
+            break;
+        case wxJSONTYPE_NULL :
+            s.assign( _T("null") );
+            break;
+        default :
+            break;
+    }
+    return s;
+}
+
+//! Returns the UTF-8 text of a string without copying it
+/*!
+ The text is NUL terminated. Other types than strings return an empty string.
+ @param len    if not NULL, set to the length of the text in bytes
+*/
+const char*
+wxJSONNode::AsUTF8( size_t* len ) const
+{
+    if ( GetType() != wxJSONTYPE_STRING )  {
+        if ( len )  *len = 0;
+        return "";
+    }
+    const wxJSONDocument::Node& node = m_doc->m_nodes[m_index];
+    if ( len )  *len = node.val.range.size;
+    return m_doc->m_strings.data() + node.val.range.begin;
+}
+
+//! The number of elements or members, -1 for other types
+int
+wxJSONNode::Size() const
+{
+    wxJSONType type = GetType();
+    if ( type != wxJSONTYPE_ARRAY && type != wxJSONTYPE_OBJECT )  {
+        return -1;
+    }
+    return m_doc->m_nodes[m_index].val.range.size;
+}
+
+bool
+wxJSONNode::HasMember( const char* key ) const
+{
+    return Item( key ).IsValid();
+}
+
+bool
+wxJSONNode::HasMember( const wxString& key ) const
+{
+    return Item( key ).IsValid();
+}
+
+//! The name of the member at \c index, see Item( unsigned )
+wxString
+wxJSONNode::GetMemberName( unsigned index ) const
+{
+    wxJSONNode member = Item( index );
+    if ( !member.IsValid() || !IsObject() )  {
+        return wxString();
+    }
+    const wxJSONDocument::Key& k = m_doc->m_keys[m_doc->m_nodes[member.m_index].key];
+    return wxString::FromUTF8( m_doc->m_strings.data() + k.begin, k.size );
+}
+
+//! The element of an array or member of an object at \c index
+/*!
+ Members of objects are ordered by the number of their name, which is only
+ useful to iterate over all of them.
+*/
+wxJSONNode
+wxJSONNode::Item( unsigned index ) const
+{
+    if ( index >= (unsigned) std::max( Size(), 0 ))  {
+        return wxJSONNode();
+    }
+    return wxJSONNode( m_doc, m_doc->m_nodes[m_index].val.range.begin + index );
+}
+
+//! The member \c key of an object, an invalid node if there is none
+wxJSONNode
+wxJSONNode::Item( const char* key ) const
+{
+    if ( !m_doc )  {
+        return wxJSONNode();
+    }
+    int index = m_doc->FindMember( m_index, key, strlen( key ));
+    if ( index < 0 )  {
+        return wxJSONNode();
+    }
+    return wxJSONNode( m_doc, index );
+}
+
+//! \overload Item( const char* )
+wxJSONNode
+wxJSONNode::Item( const wxString& key ) const
+{
+    wxCharBuffer utf8 = key.ToUTF8();
+    return Item( utf8.data() );
+}
+
+wxJSONNode
+wxJSONNode::operator [] ( unsigned index ) const
+{
+    return Item( index );
+}
+
+//! \overload operator [] ( unsigned )
+wxJSONNode
+wxJSONNode::operator [] ( int index ) const
+{
+    if ( index < 0 )  {
+        return wxJSONNode();
+    }
+    return Item( (unsigned) index );
+}
+
+wxJSONNode
+wxJSONNode::operator [] ( const char* key ) const
+{
+    return Item( key );
+}
+
+wxJSONNode
+wxJSONNode::operator [] ( const wxString& key ) const
+{
+    return Item( key );
+}
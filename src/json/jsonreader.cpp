@@ -19,6 +19,12 @@
 #include <wx/debug.h>
 #include <wx/log.h>
 
+#include <cerrno>
+#include <clocale>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
 
 
 /*! \class wxJSONReader
@@ -386,6 +392,491 @@ wxJSONReader::Parse( wxInputStream& is, wxJSONValue* val )
     return m_errors.size();
 }
 
+//! The state of the SAX parser, see Parse( const char*, size_t, wxJSONSaxHandler& )
+class wxJSONSaxParser
+{
+public:
+    wxJSONSaxParser( const char* utf8, size_t len, wxJSONSaxHandler& handler )
+        : m_pos( utf8 ), m_end( utf8 + len ), m_handler( &handler ),
+          m_level( 0 ), m_error( 0 )
+    {
+    }
+
+    bool Document();
+
+    //! The current position, on errors the position of the error
+    const char* m_pos;
+    const char* m_end;
+
+    //! The handler, NULL while a value is skipped
+    wxJSONSaxHandler* m_handler;
+
+    //! Strings containing escapes are unescaped here
+    std::string m_buff;
+
+    //! The current level of object/array annidation
+    int m_level;
+
+    //! The error message, NULL if there was no error
+    const char* m_error;
+
+private:
+    bool Value();
+    bool Object();
+    bool Array();
+    bool String( bool isKey, bool* wanted );
+    bool Number();
+    bool Literal( const char* word );
+    bool Unescape( const char* start );
+    bool ReadHex( unsigned int* code );
+    void SkipWhiteSpace();
+    bool Fail( const char* msg ) { m_error = msg; return false; }
+};
+
+//! Objects and arrays can't nest deeper than this
+static const int wxJSONSAX_MAX_LEVEL = 512;
+
+void
+wxJSONSaxParser::SkipWhiteSpace()
+{
+    while ( m_pos < m_end &&
+            ( *m_pos == ' ' || *m_pos == '\n' || *m_pos == '\r' || *m_pos == '\t' ))  {
+        ++m_pos;
+    }
+}
+
+bool
+wxJSONSaxParser::Document()
+{
+    // skip the UTF-8 BOM
+    if ( m_end - m_pos >= 3 && memcmp( m_pos, "\xEF\xBB\xBF", 3 ) == 0 )  {
+        m_pos += 3;
+    }
+    SkipWhiteSpace();
+    if ( m_pos >= m_end || ( *m_pos != '{' && *m_pos != '[' ))  {
+        return Fail( "Cannot find a start object/array character" );
+    }
+    if ( !Value() )  {
+        return false;
+    }
+    SkipWhiteSpace();
+    if ( m_pos != m_end )  {
+        return Fail( "Unexpected characters after the end of the document" );
+    }
+    return true;
+}
+
+bool
+wxJSONSaxParser::Value()
+{
+    if ( m_pos >= m_end )  {
+        return Fail( "Unexpected end of the document, a value is missing" );
+    }
+    switch ( *m_pos )  {
+        case '{' :
+            return Object();
+        case '[' :
+            return Array();
+        case '\"' :
+            return String( false, 0 );
+        case 't' :
+            if ( !Literal( "true" ))  return false;
+            if ( m_handler )  m_handler->Bool( true );
+            return true;
+        case 'f' :
+            if ( !Literal( "false" ))  return false;
+            if ( m_handler )  m_handler->Bool( false );
+            return true;
+        case 'n' :
+            if ( !Literal( "null" ))  return false;
+            if ( m_handler )  m_handler->Null();
+            return true;
+        default :
+            return Number();
+    }
+}
+
+bool
+wxJSONSaxParser::Object()
+{
+    if ( ++m_level > wxJSONSAX_MAX_LEVEL )  {
+        return Fail( "Objects and arrays are nested too deep" );
+    }
+    ++m_pos;
+    if ( m_handler )  m_handler->StartObject();
+    SkipWhiteSpace();
+    if ( m_pos < m_end && *m_pos == '}' )  {
+        ++m_pos;
+    }
+    else  {
+        for ( ;; )  {
+            if ( m_pos >= m_end || *m_pos != '\"' )  {
+                return Fail( "A \'name\' string is missing" );
+            }
+            bool wanted = true;
+            if ( !String( true, &wanted ))  return false;
+            SkipWhiteSpace();
+            if ( m_pos >= m_end || *m_pos != ':' )  {
+                return Fail( "\':\' is missing after the \'name\'" );
+            }
+            ++m_pos;
+            SkipWhiteSpace();
+
+            // field selection: an unwanted value is only validated
+            wxJSONSaxHandler* handler = m_handler;
+            if ( !wanted )  m_handler = 0;
+            bool ok = Value();
+            m_handler = handler;
+            if ( !ok )  return false;
+
+            SkipWhiteSpace();
+            if ( m_pos < m_end && *m_pos == ',' )  {
+                ++m_pos;
+                SkipWhiteSpace();
+                continue;
+            }
+            if ( m_pos < m_end && *m_pos == '}' )  {
+                ++m_pos;
+                break;
+            }
+            return Fail( "\'}\' or \',\' is missing in object" );
+        }
+    }
+    if ( m_handler )  m_handler->EndObject();
+    --m_level;
+    return true;
+}
+
+bool
+wxJSONSaxParser::Array()
+{
+    if ( ++m_level > wxJSONSAX_MAX_LEVEL )  {
+        return Fail( "Objects and arrays are nested too deep" );
+    }
+    ++m_pos;
+    if ( m_handler )  m_handler->StartArray();
+    SkipWhiteSpace();
+    if ( m_pos < m_end && *m_pos == ']' )  {
+        ++m_pos;
+    }
+    else  {
+        for ( ;; )  {
+            if ( !Value() )  return false;
+            SkipWhiteSpace();
+            if ( m_pos < m_end && *m_pos == ',' )  {
+                ++m_pos;
+                SkipWhiteSpace();
+                continue;
+            }
+            if ( m_pos < m_end && *m_pos == ']' )  {
+                ++m_pos;
+                break;
+            }
+            return Fail( "\']\' or \',\' is missing in array" );
+        }
+    }
+    if ( m_handler )  m_handler->EndArray();
+    --m_level;
+    return true;
+}
+
+//! Reads a string, the current character is the opening quote
+/*!
+ Strings without escape sequences are passed to the handler directly from
+ the input buffer, the others are unescaped into \c m_buff first.
+ If \c isKey is TRUE the string is passed to wxJSONSaxHandler::Key() and its
+ return value is stored in \c wanted.
+*/
+bool
+wxJSONSaxParser::String( bool isKey, bool* wanted )
+{
+    const char* start = ++m_pos;
+    while ( m_pos < m_end && *m_pos != '\"' && *m_pos != '\\' && (unsigned char) *m_pos >= 0x20 )  {
+        ++m_pos;
+    }
+    const char* str = start;
+    size_t len = m_pos - start;
+    if ( m_pos < m_end && *m_pos == '\\' )  {
+        if ( !Unescape( start ))  return false;
+        str = m_buff.data();
+        len = m_buff.size();
+    }
+    if ( m_pos >= m_end )  {
+        return Fail( "Unexpected end of the document in a string" );
+    }
+    if ( *m_pos != '\"' )  {
+        return Fail( "Control characters are not allowed in strings" );
+    }
+    ++m_pos;
+
+    if ( m_handler )  {
+        if ( isKey )  {
+            *wanted = m_handler->Key( str, len );
+        }
+        else  {
+            m_handler->String( str, len );
+        }
+    }
+    return true;
+}
+
+//! Unescapes the rest of a string, stops at the closing quote
+bool
+wxJSONSaxParser::Unescape( const char* start )
+{
+    // a skipped value is only validated
+    const bool store = ( m_handler != 0 );
+    if ( store )  {
+        m_buff.assign( start, m_pos );
+    }
+    while ( m_pos < m_end && *m_pos != '\"' )  {
+        char ch = *m_pos;
+        if ( (unsigned char) ch < 0x20 )  {
+            return true;    // reported by the caller
+        }
+        ++m_pos;
+        if ( ch != '\\' )  {
+            if ( store )  m_buff += ch;
+            continue;
+        }
+        if ( m_pos >= m_end )  {
+            return true;
+        }
+        ch = *m_pos++;
+        switch ( ch )  {
+            case '\"' :
+            case '\\' :
+            case '/' :
+                break;
+            case 'b' :
+                ch = '\b';
+                break;
+            case 'f' :
+                ch = '\f';
+                break;
+            case 'n' :
+                ch = '\n';
+                break;
+            case 'r' :
+                ch = '\r';
+                break;
+            case 't' :
+                ch = '\t';
+                break;
+            case 'u' :
+                {
+                    unsigned int code;
+                    if ( !ReadHex( &code ))  return false;
+                    if ( code >= 0xDC00 && code <= 0xDFFF )  {
+                        return Fail( "Invalid surrogate pair in \\u escape sequence" );
+                    }
+                    if ( code >= 0xD800 && code <= 0xDBFF )  {
+                        unsigned int low;
+                        if ( m_end - m_pos < 2 || m_pos[0] != '\\' || m_pos[1] != 'u' )  {
+                            return Fail( "Invalid surrogate pair in \\u escape sequence" );
+                        }
+                        m_pos += 2;
+                        if ( !ReadHex( &low ))  return false;
+                        if ( low < 0xDC00 || low > 0xDFFF )  {
+                            return Fail( "Invalid surrogate pair in \\u escape sequence" );
+                        }
+                        code = 0x10000 + (( code - 0xD800 ) << 10 ) + ( low - 0xDC00 );
+                    }
+                    if ( !store )  continue;
+                    if ( code < 0x80 )  {
+                        m_buff += (char) code;
+                    }
+                    else if ( code < 0x800 )  {
+                        m_buff += (char) ( 0xC0 | ( code >> 6 ));
+                        m_buff += (char) ( 0x80 | ( code & 0x3F ));
+                    }
+                    else if ( code < 0x10000 )  {
+                        m_buff += (char) ( 0xE0 | ( code >> 12 ));
+                        m_buff += (char) ( 0x80 | (( code >> 6 ) & 0x3F ));
+                        m_buff += (char) ( 0x80 | ( code & 0x3F ));
+                    }
+                    else  {
+                        m_buff += (char) ( 0xF0 | ( code >> 18 ));
+                        m_buff += (char) ( 0x80 | (( code >> 12 ) & 0x3F ));
+                        m_buff += (char) ( 0x80 | (( code >> 6 ) & 0x3F ));
+                        m_buff += (char) ( 0x80 | ( code & 0x3F ));
+                    }
+                    continue;
+                }
+            default :
+                --m_pos;
+                return Fail( "Invalid escape sequence in string" );
+        }
+        if ( store )  m_buff += ch;
+    }
+    return true;
+}
+
+//! Reads the four hex digits of a \\u escape sequence
+bool
+wxJSONSaxParser::ReadHex( unsigned int* code )
+{
+    if ( m_end - m_pos < 4 )  {
+        return Fail( "Invalid \\u escape sequence" );
+    }
+    *code = 0;
+    for ( int i = 0; i < 4; i++ )  {
+        char ch = *m_pos;
+        unsigned int digit;
+        if ( ch >= '0' && ch <= '9' )  {
+            digit = ch - '0';
+        }
+        else if ( ch >= 'a' && ch <= 'f' )  {
+            digit = ch - 'a' + 10;
+        }
+        else if ( ch >= 'A' && ch <= 'F' )  {
+            digit = ch - 'A' + 10;
+        }
+        else  {
+            return Fail( "Invalid \\u escape sequence" );
+        }
+        *code = ( *code << 4 ) | digit;
+        ++m_pos;
+    }
+    return true;
+}
+
+bool
+wxJSONSaxParser::Literal( const char* word )
+{
+    size_t len = strlen( word );
+    if ( (size_t) ( m_end - m_pos ) < len || memcmp( m_pos, word, len ) != 0 )  {
+        return Fail( "Invalid literal, expected true, false or null" );
+    }
+    m_pos += len;
+    return true;
+}
+
+//! Reads a number as defined by RFC 4627
+/*!
+ Integers that fit into 64 bits are passed to wxJSONSaxHandler::Int(), all
+ other numbers to wxJSONSaxHandler::Double().
+*/
+bool
+wxJSONSaxParser::Number()
+{
+    const char* start = m_pos;
+    bool isInt = true;
+    if ( m_pos < m_end && *m_pos == '-' )  {
+        ++m_pos;
+    }
+    if ( m_pos >= m_end || *m_pos < '0' || *m_pos > '9' )  {
+        m_pos = start;
+        return Fail( "Invalid value" );
+    }
+    if ( *m_pos == '0' )  {
+        ++m_pos;
+    }
+    else  {
+        while ( m_pos < m_end && *m_pos >= '0' && *m_pos <= '9' )  ++m_pos;
+    }
+    if ( m_pos < m_end && *m_pos == '.' )  {
+        isInt = false;
+        ++m_pos;
+        if ( m_pos >= m_end || *m_pos < '0' || *m_pos > '9' )  {
+            return Fail( "Digits are missing after the decimal point" );
+        }
+        while ( m_pos < m_end && *m_pos >= '0' && *m_pos <= '9' )  ++m_pos;
+    }
+    if ( m_pos < m_end && ( *m_pos == 'e' || *m_pos == 'E' ))  {
+        isInt = false;
+        ++m_pos;
+        if ( m_pos < m_end && ( *m_pos == '+' || *m_pos == '-' ))  ++m_pos;
+        if ( m_pos >= m_end || *m_pos < '0' || *m_pos > '9' )  {
+            return Fail( "Digits are missing in the exponent" );
+        }
+        while ( m_pos < m_end && *m_pos >= '0' && *m_pos <= '9' )  ++m_pos;
+    }
+    if ( !m_handler )  {
+        return true;
+    }
+
+    // the input buffer is not NUL terminated, copy the token for strtoll/strtod
+    char buff[64];
+    std::string longNum;
+    char* num = buff;
+    size_t len = m_pos - start;
+    if ( len < sizeof( buff ))  {
+        memcpy( buff, start, len );
+        buff[len] = 0;
+    }
+    else  {
+        longNum.assign( start, len );
+        num = &longNum[0];
+    }
+
+    if ( isInt )  {
+        errno = 0;
+        char* numEnd;
+        wxInt64 i64 = strtoll( num, &numEnd, 10 );
+        if ( errno == 0 )  {
+            m_handler->Int( i64 );
+            return true;
+        }
+    }
+    // strtod() uses the decimal point of the current locale
+    char point = *localeconv()->decimal_point;
+    if ( point != '.' )  {
+        char* dot = strchr( num, '.' );
+        if ( dot )  *dot = point;
+    }
+    m_handler->Double( strtod( num, 0 ));
+    return true;
+}
+
+//! Parses a UTF-8 buffer and reports its contents to a handler
+/*!
+ This is the SAX mode of the parser: instead of building a wxJSONValue tree,
+ every value is passed to the \c handler as soon as it is read.
+ The buffer is read in place; strings that do not contain escape sequences
+ are passed to the handler without being copied.
+ If wxJSONSaxHandler::Key() returns FALSE, the value of that member is
+ validated but not reported, so a handler can select the fields it needs.
+
+ Unlike the other Parse() functions the input must be strict JSON: the
+ \c flags of the parser are ignored, comments are not allowed and the
+ document must start with an object or array.
+ The parsing stops at the first error; its line and column are computed
+ only when it occurs.
+
+ @param utf8    the JSON text, does not need to be NUL terminated
+ @param len    the length of the text in bytes
+ @param handler    the handler which receives the values
+ @return the total number of errors encontered (zero or one)
+*/
+int
+wxJSONReader::Parse( const char* utf8, size_t len, wxJSONSaxHandler& handler )
+{
+    m_level    = 0;
+    m_depth    = 0;
+    m_lineNo   = 1;
+    m_colNo    = 1;
+    m_errors.clear();
+    m_warnings.clear();
+
+    wxJSONSaxParser parser( utf8, len, handler );
+    if ( !parser.Document() )  {
+        for ( const char* p = utf8; p < parser.m_pos; ++p )  {
+            if ( *p == '\n' )  {
+                ++m_lineNo;
+                m_colNo = 1;
+            }
+            // count characters, not UTF-8 continuation bytes
+            else if (( *p & 0xC0 ) != 0x80 )  {
+                ++m_colNo;
+            }
+        }
+        AddError( wxString::FromAscii( parser.m_error ));
+    }
+    return m_errors.size();
+}
+
+
 
 //! Returns the start of the document
 /*!
@@ -0,0 +1,176 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        jsondocument.h
+// Purpose:     the wxJSONDocument class: a compact read-only JSON tree
+// Licence:     wxWidgets licence
+/////////////////////////////////////////////////////////////////////////////
+
+#if !defined( _WX_JSONDOCUMENT_H )
+#define _WX_JSONDOCUMENT_H
+
+#include "wx/wxprec.h"
+
+#ifndef WX_PRECOMP
+    #include <wx/string.h>
+    #include <wx/arrstr.h>
+#endif
+
+#include <string>
+#include <vector>
+
+#include "json_defs.h"
+#include "jsonval.h"
+
+class WXDLLIMPEXP_JSON wxJSONDocument;
+
+//! A value in a wxJSONDocument
+/*!
+ This is a small handle which refers to a value of the document; it is only
+ valid as long as the document it was obtained from.
+ The accessors have the same names as the ones of wxJSONValue so that code
+ reading a wxJSONValue tree can easily be switched to a wxJSONDocument.
+ Accessing a missing member or an index out of range returns an invalid
+ node, so lookups can be chained:
+
+ \code
+   long size = doc.GetRoot()[0]["size"].AsLong();
+ \endcode
+*/
+class WXDLLIMPEXP_JSON wxJSONNode
+{
+public:
+    wxJSONNode();
+
+    wxJSONType  GetType() const;
+    bool IsValid() const;
+    bool IsNull() const;
+    bool IsInt() const;
+    bool IsLong() const;
+    bool IsInt64() const;
+    bool IsDouble() const;
+    bool IsString() const;
+    bool IsBool() const;
+    bool IsArray() const;
+    bool IsObject() const;
+
+    int         AsInt() const;
+    long int    AsLong() const;
+    wxInt64     AsInt64() const;
+    double      AsDouble() const;
+    bool        AsBool() const;
+    wxString    AsString() const;
+    const char* AsUTF8( size_t* len = 0 ) const;
+
+    int         Size() const;
+    bool        HasMember( const char* key ) const;
+    bool        HasMember( const wxString& key ) const;
+    wxString    GetMemberName( unsigned index ) const;
+
+    wxJSONNode  Item( unsigned index ) const;
+    wxJSONNode  Item( const char* key ) const;
+    wxJSONNode  Item( const wxString& key ) const;
+    wxJSONNode  operator [] ( unsigned index ) const;
+    wxJSONNode  operator [] ( int index ) const;
+    wxJSONNode  operator [] ( const char* key ) const;
+    wxJSONNode  operator [] ( const wxString& key ) const;
+
+private:
+    friend class wxJSONDocument;
+    wxJSONNode( const wxJSONDocument* doc, wxUint32 index );
+
+    //! The document, NULL for invalid nodes
+    const wxJSONDocument* m_doc;
+
+    //! The index of the node in the document's arena
+    wxUint32 m_index;
+};
+
+//! A read-only JSON tree stored in a few contiguous arrays
+/*!
+ wxJSONValue allocates every value separately and stores strings as
+ wxString, objects in hash maps and arrays in object arrays. A large document
+ therefore needs many times the memory of its text.
+
+ A wxJSONDocument is built once by the SAX mode of wxJSONReader and cannot be
+ modified. All values are fixed size nodes in a single array; the elements of
+ an array and the members of an object are stored next to each other, so a
+ container only holds the index of its first child and the number of children.
+ Strings are stored UTF-8 encoded in a single buffer. Member names are interned:
+ every distinct name is stored once and the members of an object refer to it
+ by number and are sorted by it, so looking up a member is two binary searches.
+
+ Note that the members of an object are not kept in document order; as in
+ wxJSONValue, a member that appears twice keeps the last value.
+*/
+class WXDLLIMPEXP_JSON wxJSONDocument
+{
+public:
+    wxJSONDocument();
+
+    int  Parse( const char* utf8, size_t len );
+    int  Parse( const wxString& doc );
+    void Clear();
+
+    wxJSONNode GetRoot() const;
+    const wxArrayString& GetErrors() const;
+
+    //! The number of bytes allocated by the document
+    size_t GetMemoryUsage() const;
+
+private:
+    friend class wxJSONNode;
+    friend class wxJSONDocBuilder;
+
+    //! A value, 16 bytes
+    struct Node
+    {
+        //! The wxJSONType of the value
+        wxUint8  type;
+
+        //! The member name if the value is a member of an object
+        wxUint32 key;
+
+        union
+        {
+            wxInt64 i;
+            double  d;
+            bool    b;
+
+            //! strings: offset in m_strings and length,
+            //! arrays/objects: index of the first child and number of children
+            struct
+            {
+                wxUint32 begin;
+                wxUint32 size;
+            } range;
+        } val;
+    };
+
+    //! An interned member name, offset in m_strings and length
+    struct Key
+    {
+        wxUint32 begin;
+        wxUint32 size;
+    };
+
+    static bool ByKey( const Node& a, const Node& b );
+    int  FindKey( const char* key, size_t len ) const;
+    int  FindMember( wxUint32 index, const char* key, size_t len ) const;
+    int  CompareKey( wxUint32 key, const char* str, size_t len ) const;
+
+    //! All values, the children of a container come before the container
+    std::vector<Node> m_nodes;
+
+    //! The text of all strings and member names, each one NUL terminated
+    std::string m_strings;
+
+    //! The member names, indexed by their number
+    std::vector<Key> m_keys;
+
+    //! The numbers of the member names sorted by name
+    std::vector<wxUint32> m_sortedKeys;
+
+    //! The errors of the last Parse()
+    wxArrayString m_errors;
+};
+
+#endif            // not defined _WX_JSONDOCUMENT_H
@@ -52,6 +52,32 @@ enum {
 };
 
 
+//! Callbacks of the SAX parsing mode
+/*!
+ See wxJSONReader::Parse( const char*, size_t, wxJSONSaxHandler& ).
+ Strings are UTF-8 and not NUL terminated, they are only valid during the call.
+*/
+class WXDLLIMPEXP_JSON wxJSONSaxHandler
+{
+public:
+    virtual ~wxJSONSaxHandler() {}
+
+    virtual void StartObject() {}
+    virtual void EndObject() {}
+    virtual void StartArray() {}
+    virtual void EndArray() {}
+
+    //! an object member; return false to skip its value without further callbacks
+    virtual bool Key( const char* /*key*/, size_t /*len*/ ) { return true; }
+
+    virtual void String( const char* /*str*/, size_t /*len*/ ) {}
+    //! numbers without fraction or exponent that fit into 64 bits
+    virtual void Int( wxInt64 /*i*/ ) {}
+    virtual void Double( double /*d*/ ) {}
+    virtual void Bool( bool /*b*/ ) {}
+    virtual void Null() {}
+};
+
 class WXDLLIMPEXP_JSON  wxJSONReader
 {
 public:
@@ -60,6 +86,7 @@ public:
 
     int Parse( const wxString& doc, wxJSONValue* val );
     int Parse( wxInputStream& doc, wxJSONValue* val );
+    int Parse( const char* utf8, size_t len, wxJSONSaxHandler& handler );
 
     int   GetDepth() const;
     int   GetErrorCount() const;
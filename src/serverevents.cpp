@@ -25,6 +25,7 @@
 #include "settings.h"
 #include "gui/customdialogs.h"
 #include "utils/tasutil.h"
+#include "utils/scripttag.h"
 #include "utils/uievents.h"
 #include "log.h"
 #include "utils/conversion.h"
@@ -165,7 +166,7 @@ void ServerEvents::OnUserStatus( const std::string& nick, UserStatus status )
             IBattle& battle = *user.GetBattle();
             try
             {
-            if ( battle.GetFounder().GetNick() == user.GetNick() )
+            if ( &battle.GetFounder() == &user )
             {
                 if ( status.in_game != battle.GetInGame() )
                 {
@@ -432,68 +433,47 @@ void ServerEvents::OnSetBattleInfo( int battleid, const std::string& param, cons
     {
         IBattle& battle = m_serv.GetBattle( battleid );
 		battle.m_script_tags[param] = value;
-        wxString key = TowxString(param);
-        if ( key.Left( 5 ) == _T("game/") )
-        {
-            key = key.AfterFirst( '/' );
-            if ( key.Left( 11 ) == _T( "mapoptions/" ) )
-            {
-                key = key.AfterFirst( '/' );
-                battle.CustomBattleOptions().setSingleOption(STD_STRING(key), value, LSL::Enum::MapOption );
-                battle.Update(STD_STRING(wxString::Format(_T("%d_%s"), LSL::Enum::MapOption, key.c_str() )));
-            }
-            else if ( key.Left( 11 ) == _T( "modoptions/" ) )
-            {
-                key = key.AfterFirst( '/' );
-                battle.CustomBattleOptions().setSingleOption(STD_STRING(key), value, LSL::Enum::ModOption );
-                battle.Update(STD_STRING(wxString::Format(_T("%d_%s"), LSL::Enum::ModOption,  key.c_str() )));
-            }
-            else if ( key.Left( 8 ) == _T( "restrict" ) )
-            {
-				OnBattleDisableUnit( battleid, STD_STRING(key.AfterFirst(_T('/'))), s2l(TowxString(value)) );
-            }
-            else if ( key.Left( 4 ) == _T( "team" ) && key.Find( _T("startpos") ) != wxNOT_FOUND )
-            {
-            	 int team = s2l( key.BeforeFirst(_T('/')).Mid( 4 ) );
-							 if ( key.Find( _T("startposx") ) != wxNOT_FOUND )
-							 {
-							 	 int numusers = battle.GetNumUsers();
-							 	 for ( int i = 0; i < numusers; i++ )
-							 	 {
-							 	 	 User& usr = battle.GetUser( i );
-							 	 	 UserBattleStatus& status = usr.BattleStatus();
-							 	 	 if ( status.team == team )
-							 	 	 {
-							 	 	 	 status.pos.x = s2l(TowxString(value));
-										 battle.OnUserBattleStatusUpdated( usr, status );
-							 	 	 }
-							 	 }
-							 }
-							 else if ( key.Find( _T("startposy") ) != wxNOT_FOUND )
-							 {
-							 	 int numusers = battle.GetNumUsers();
-							 	 for ( int i = 0; i < numusers; i++ )
-							 	 {
-							 	 	 User& usr = battle.GetUser( i );
-							 	 	 UserBattleStatus& status = usr.BattleStatus();
-							 	 	 if ( status.team == team )
-							 	 	 {
-							 	 	 	 status.pos.y = s2l(TowxString(value));
-							 	 	 	 battle.OnUserBattleStatusUpdated( usr, status );
-							 	 	 }
-							 	 }
-							 }
-		} else if (key.Left(8) == _T("hosttype")) {
-			battle.m_autohost_manager->RecognizeAutohost(value);
-		} else {
-			battle.CustomBattleOptions().setSingleOption( STD_STRING(key), value, LSL::Enum::EngineOption );
-			battle.Update(STD_STRING(wxString::Format(_T("%d_%s"), LSL::Enum::EngineOption, key.c_str() )));
+		const ScriptTag tag = ScriptTag::Parse( param );
+		switch ( tag.kind ) {
+			case ScriptTag::TAG_MAPOPTION:
+				battle.CustomBattleOptions().setSingleOption( tag.name, value, LSL::Enum::MapOption );
+				AddPendingTag( stdprintf( "%d_%s", LSL::Enum::MapOption, tag.name.c_str() ) );
+				break;
+			case ScriptTag::TAG_MODOPTION:
+				battle.CustomBattleOptions().setSingleOption( tag.name, value, LSL::Enum::ModOption );
+				AddPendingTag( stdprintf( "%d_%s", LSL::Enum::ModOption, tag.name.c_str() ) );
+				break;
+			case ScriptTag::TAG_ENGINEOPTION:
+				battle.CustomBattleOptions().setSingleOption( tag.name, value, LSL::Enum::EngineOption );
+				AddPendingTag( stdprintf( "%d_%s", LSL::Enum::EngineOption, tag.name.c_str() ) );
+				break;
+			case ScriptTag::TAG_RESTRICT:
+				battle.RestrictUnit( tag.name, s2l( TowxString( value ) ) );
+				AddPendingTag( stdprintf( "%d_restrictions", LSL::Enum::PrivateOptions ) );
+				break;
+			case ScriptTag::TAG_STARTPOSX:
+				m_pending_tags.startposx[tag.team] = s2l( TowxString( value ) );
+				break;
+			case ScriptTag::TAG_STARTPOSY:
+				m_pending_tags.startposy[tag.team] = s2l( TowxString( value ) );
+				break;
+			case ScriptTag::TAG_HOSTTYPE:
+				battle.m_autohost_manager->RecognizeAutohost( value );
+				break;
+			case ScriptTag::TAG_STARTPOS:
+			case ScriptTag::TAG_NONE:
+				break;
 		}
-        }
     }
     catch (assert_exception) {}
 }
 
+void ServerEvents::AddPendingTag( const std::string& tag )
+{
+	if ( m_pending_tags.seen.insert( tag ).second )
+		m_pending_tags.tags.push_back( tag );
+}
+
 void ServerEvents::OnUnsetBattleInfo( int /*battleid*/, const std::string& /*param*/)
 {
 	//FIXME: implement this
@@ -503,10 +483,31 @@ void ServerEvents::OnUnsetBattleInfo( int /*battleid*/, const std::string& /*par
 void ServerEvents::OnBattleInfoUpdated( int battleid )
 {
     slLogDebugFunc("");
+    PendingTags pending;
+    std::swap( pending, m_pending_tags );
     try
     {
         IBattle& battle = m_serv.GetBattle( battleid );
-		BattleEvents::GetBattleEventSender( BattleEvents::BattleInfoUpdate ).SendEvent( std::make_pair(&battle,"") );
+        if ( !pending.startposx.empty() || !pending.startposy.empty() )
+        {
+            // one status update per user, even if both coordinates changed
+            const int numusers = battle.GetNumUsers();
+            for ( int i = 0; i < numusers; i++ )
+            {
+                User& usr = battle.GetUser( i );
+                UserBattleStatus& status = usr.BattleStatus();
+                std::map<int,int>::const_iterator x = pending.startposx.find( status.team );
+                std::map<int,int>::const_iterator y = pending.startposy.find( status.team );
+                if ( x == pending.startposx.end() && y == pending.startposy.end() ) continue;
+                if ( x != pending.startposx.end() ) status.pos.x = x->second;
+                if ( y != pending.startposy.end() ) status.pos.y = y->second;
+                battle.OnUserBattleStatusUpdated( usr, status );
+            }
+        }
+        if ( pending.tags.empty() )
+            BattleEvents::GetBattleEventSender( BattleEvents::BattleInfoUpdate ).SendEvent( std::make_pair(&battle,"") );
+        else
+            BattleEvents::GetBattleTagsEventSender().SendEvent( std::make_pair( &battle, pending.tags ) );
     }
     catch ( assert_exception ) {}
 }
@@ -588,7 +589,7 @@ void ServerEvents::OnChannelSaid( const std::string& channel, const std::string&
 	slLogDebugFunc("");
     try
     {
-        if ( ( m_serv.GetMe().GetNick() ==  who ) || !useractions().DoActionOnUser( UserActions::ActIgnoreChat, TowxString(who)) )
+        if ( m_serv.IsMe( who ) || !useractions().DoActionOnUser( UserActions::ActIgnoreChat, TowxString(who)) )
             m_serv.GetChannel(TowxString(channel)).Said( m_serv.GetUser(TowxString(who)), message);
     }
     catch (std::runtime_error &except)
@@ -641,7 +642,7 @@ void ServerEvents::OnChannelAction( const std::string& channel, const std::strin
 	slLogDebugFunc("");
     try
     {
-		if ( ( m_serv.GetMe().GetNick() ==  who ) || !useractions().DoActionOnUser( UserActions::ActIgnoreChat, TowxString(who) ) )
+		if ( m_serv.IsMe( who ) || !useractions().DoActionOnUser( UserActions::ActIgnoreChat, TowxString(who) ) )
 			m_serv.GetChannel(TowxString(channel)).DidAction( m_serv.GetUser(TowxString(who)), action);
     }
     catch (std::runtime_error &except)
@@ -713,7 +714,7 @@ void ServerEvents::OnSaidBattle( int battleid, const std::string& nick, const st
     try
     {
         IBattle& battle = m_serv.GetBattle( battleid );
-		if ( ( m_serv.GetMe().GetNick() ==  nick) || !useractions().DoActionOnUser( UserActions::ActIgnoreChat, TowxString(nick)) )
+		if ( m_serv.IsMe( nick ) || !useractions().DoActionOnUser( UserActions::ActIgnoreChat, TowxString(nick)) )
 		{
 			ui().OnSaidBattle( battle, TowxString(nick), TowxString(msg));
 		}
@@ -5,6 +5,10 @@
 
 #include "iserverevents.h"
 #include <wx/longlong.h>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
 
 class Ui;
 struct UserStatus;
@@ -119,8 +123,20 @@ class ServerEvents : public IServerEvents
 	void RegistrationDenied(const std::string& reason);
 	void OnLoginDenied(const std::string& reason);
 private:
+    void AddPendingTag( const std::string& tag );
+
     IServer& m_serv;
     std::map<std::string,MessageSpamCheck> m_spam_check;
+
+    //! changes of the SETSCRIPTTAGS line being read, applied by OnBattleInfoUpdated( battleid )
+    struct PendingTags
+    {
+        std::vector<std::string> tags; //! changed option tags, in order
+        std::set<std::string> seen;
+        std::map<int,int> startposx; //! team -> start position
+        std::map<int,int> startposy;
+    };
+    PendingTags m_pending_tags;
     std::string m_savepath;
 };
 
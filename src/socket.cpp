@@ -27,6 +27,7 @@ lsl/networking/socket.cpp
 
 #include <stdexcept>
 #include <algorithm>
+#include <cstring>
 
 #include "socket.h"
 #include "iserver.h"
@@ -168,9 +169,8 @@ Socket::Socket( iNetClass& netclass):
     m_handle( _GetHandle() ),
     m_connecting( false ),
     m_net_class(netclass),
-	m_udp_private_port(0),
-    m_rate(-1),
-    m_sent(0)
+    m_batch( 0 ),
+	m_udp_private_port(0)
 {
 }
 
@@ -207,7 +207,7 @@ void Socket::Connect( const wxString& addr, const int port )
 
 	wxIPV4address wxaddr;
 	m_connecting = true;
-	m_buffer = "";
+	m_queue.Clear();
 
 	if (!wxaddr.Hostname( addr )) {
 		m_net_class.OnError(_T("Invalid Hostname"));
@@ -234,7 +234,11 @@ void Socket::SetTimeout( const int seconds )
 void Socket::Disconnect( )
 {
   if ( m_sock ) m_sock->SetTimeout( 0 );
-  m_buffer = "";
+  {
+    LOCK_SOCKET;
+    _LogSendStats();
+    m_queue.Clear();
+  }
 
   if ( m_sock )
   {
@@ -245,41 +249,66 @@ void Socket::Disconnect( )
 }
 
 
-//! @brief Send data over connection.
-bool Socket::Send( const wxString& data )
+//! @brief Queue data and send as much as the rate limit allows.
+bool Socket::Send( const wxString& data, SendQueue::Priority prio )
 {
   LOCK_SOCKET;
-  return _Send( data );
-}
-
-
-//! @brief Internal send function.
-//! @note Does not lock the criticalsection.
-bool Socket::_Send( const wxString& data )
-{
   if ( !m_sock )
   {
     m_net_class.OnError( _T("Socket NULL") );
     return false;
   }
+  const wxCharBuffer utf8 = data.mb_str( wxConvUTF8 );
+  m_queue.Push( utf8.data(), strlen( utf8.data() ), prio, m_clock.Time() );
+  if ( m_batch > 0 ) return true;
+  return _Flush();
+}
 
-	m_buffer += (const char*)data.mb_str(wxConvUTF8);
-	int crop = m_buffer.length();
-  if ( m_rate > 0 )
-  {
-  	 int max = m_rate - m_sent;
-  	 if ( crop > 0 ) crop = max;
+
+void Socket::BeginBatch()
+{
+  LOCK_SOCKET;
+  m_batch++;
+}
+
+
+void Socket::EndBatch()
+{
+  LOCK_SOCKET;
+  if ( m_batch == 0 ) return;
+  m_batch--;
+  if ( m_batch == 0 && !m_queue.Empty() ) _Flush();
+}
+
+
+//! @brief Write queued data that the rate limit lets through.
+//! @note Does not lock the criticalsection.
+bool Socket::_Flush()
+{
+  if ( !m_sock ) return false;
+  const size_t len = m_queue.Gather( m_spans );
+  if ( len == 0 ) return true;
+
+  // wxSocket has no gather write, the spans are joined in a buffer that is kept between calls
+  m_scratch.clear();
+  m_scratch.reserve( len );
+  for ( size_t i = 0; i < m_spans.size(); i++ ) m_scratch.append( m_spans[i].data, m_spans[i].len );
+  m_sock->Write( m_scratch.data(), m_scratch.length() );
+  if ( m_sock->Error() && m_sock->LastError() != wxSOCKET_WOULDBLOCK ) return false;
+  m_queue.Consume( m_sock->LastCount(), m_clock.Time() );
+  return true;
+}
+
+
+void Socket::_LogSendStats()
+{
+  static const wxChar* names[SendQueue::PRIO_COUNT] = { _T("control"), _T("battle"), _T("chat"), _T("bulk") };
+  for ( int prio = 0; prio < SendQueue::PRIO_COUNT; prio++ ) {
+    const SendQueue::Stats& stats = m_queue.GetStats( SendQueue::Priority( prio ) );
+    if ( stats.lines == 0 ) continue;
+    wxLogMessage( _T("send queue %s: %lu lines, %lu bytes, latency avg %.1f ms max %ld ms"), names[prio],
+      stats.lines, stats.bytes, stats.total_ms / stats.lines, stats.max_ms );
   }
-	std::string send = m_buffer.substr( 0, crop );
-	//wxLogMessage( _T("send: %d  sent: %d  max: %d   :  buff: %d"), send.length() , m_sent, max, m_buffer.length() );
-	m_sock->Write( send.c_str(), send.length() );
-	if ( !m_sock->Error() )
-	{
-		wxUint32 sentdata = m_sock->LastCount();
-		m_buffer.erase( 0, sentdata );
-		m_sent += sentdata;
-	}
-  return !m_sock->Error();
 }
 
 
@@ -387,9 +416,10 @@ wxString Socket::GetLocalAddress() const
 
 
 //! @brief Set the maximum upload ratio.
-void Socket::SetSendRateLimit( int Bps )
+void Socket::SetSendRateLimit( int Bps, int burst )
 {
-  m_rate = Bps;
+  LOCK_SOCKET;
+  m_queue.SetRate( Bps, burst );
 }
 
 
@@ -397,12 +427,7 @@ void Socket::OnTimer( int mselapsed )
 {
   LOCK_SOCKET;
 
-  if ( m_rate > 0 ) {
-    m_sent -= int( ( mselapsed / 1000.0 ) * m_rate );
-    if ( m_sent < 0 ) m_sent = 0;
-    if ( m_buffer.length() > 0 ) _Send(wxEmptyString);
-  } else {
-    m_sent = 0;
-  }
+  m_queue.Refill( mselapsed );
+  if ( !m_queue.Empty() ) _Flush();
 }
 
@@ -20,6 +20,10 @@ lsl/networking/socket.h
 #include <wx/string.h>
 #include <wx/event.h>
 #include <string>
+#include <vector>
+#include <wx/stopwatch.h>
+
+#include "utils/sendqueue.h"
 
 class iNetClass;
 class wxCriticalSection;
@@ -60,7 +64,10 @@ class Socket
     void Connect( const wxString& addr, const int port );
     void Disconnect( );
 
-    bool Send( const wxString& data );
+    bool Send( const wxString& data, SendQueue::Priority prio = SendQueue::PRIO_CHAT );
+    //! data sent until the matching EndBatch() is queued and written at once, batches nest
+    void BeginBatch();
+    void EndBatch();
     wxString Receive();
     //! used in plasmaservice, otherwise getting garbeld responses
     wxString ReceiveSpecial();
@@ -71,8 +78,10 @@ class Socket
     SockState State( );
     SockError Error( ) const;
 
-    void SetSendRateLimit( int Bps = -1 );
-    int GetSendRateLimit() {return m_rate;}
+    //! @p burst bytes may be sent at once, default is one second worth of @p Bps
+    void SetSendRateLimit( int Bps = -1, int burst = -1 );
+    int GetSendRateLimit() {return m_queue.GetRate();}
+    const SendQueue::Stats& GetSendStats( SendQueue::Priority prio ) const { return m_queue.GetStats( prio ); }
     void OnTimer( int mselapsed );
 
     void SetTimeout( const int seconds );
@@ -91,15 +100,18 @@ private:
 
     bool m_connecting;
     iNetClass& m_net_class;
+    int m_batch; //! nesting depth of BeginBatch()
 
     unsigned int m_udp_private_port;
-    int m_rate;
-    int m_sent;
-    std::string m_buffer;
+    SendQueue m_queue;
+    wxStopWatch m_clock; //! timestamps for m_queue
+    std::vector<SendQueue::Span> m_spans;
+    std::string m_scratch;
 
     wxSocketClient* _CreateSocket();
 
-    bool _Send( const wxString& data );
+    bool _Flush();
+    void _LogSendStats();
 };
 
 class SocketEvents: public wxEvtHandler
@@ -28,12 +28,14 @@ lsl/spring/spring.cpp
 #include <wx/filename.h>
 #include <wx/log.h>
 
+#include <algorithm>
+#include <map>
+#include <set>
 #include <stdexcept>
 #include <vector>
 #include <clocale>
 #include <fstream>
 
-#include <lsl/battle/tdfcontainer.h>
 #include <lslutils/globalsmanager.h>
 #include <lslutils/conversion.h>
 #include <lslunitsync/unitsync.h>
@@ -46,6 +48,7 @@ lsl/spring/spring.cpp
 #include "utils/conversion.h"
 #include "utils/slpaths.h"
 #include "utils/slconfig.h"
+#include "utils/scripttxt.h"
 #include "settings.h"
 #include "ibattle.h"
 #include "log.h"
@@ -61,6 +64,9 @@ END_EVENT_TABLE()
 
 #define FIRST_UDP_SOURCEPORT 8300
 
+static ScriptTxt::Script GetScript( IBattle& battle );
+static std::string GetScriptTxt( IBattle& battle );
+
 Spring& spring()
 {
 	static LSL::Util::LineInfo<Spring> m( AT );
@@ -108,11 +114,16 @@ bool Spring::Run( IBattle& battle )
 
 	const wxString scripttxt = TowxString(SlPaths::GetLobbyWriteDir()) + _T("script.txt");
 	try {
-
-		wxFile f( scripttxt, wxFile::write );
 		battle.DisableHostStatusInProxyMode( true );
-		f.Write( WriteScriptTxt(battle) );
+		const std::string script = GetScriptTxt( battle );
 		battle.DisableHostStatusInProxyMode( false );
+
+		// one write of the whole buffer
+		wxFile f( scripttxt, wxFile::write );
+		if ( !f.IsOpened() || ( f.Write( script.data(), script.size() ) != script.size() ) ) {
+			wxLogError( wxString::Format( _T("Couldn't write %s"), scripttxt.c_str()));
+			return false;
+		}
 		f.Close();
 	} catch ( std::exception& e ) {
 		wxLogError( wxString::Format( _T("Couldn't write %s, exception caught:\n %s"), scripttxt.c_str(), TowxString( e.what() ).c_str() ) );
@@ -164,91 +175,78 @@ void Spring::OnTerminated( wxCommandEvent& event )
 	GlobalEvent::Send(event);
 }
 
-wxString Spring::WriteScriptTxt( IBattle& battle ) const
+//! snapshot of everything script.txt needs, the battle isn't touched while writing
+static ScriptTxt::Script GetScript( IBattle& battle )
 {
-	wxLogMessage(_T("0 WriteScriptTxt called "));
-
-	std::stringstream ret;
-
-	LSL::TDF::TDFWriter tdf(ret);
-
-	// Start generating the script.
-	tdf.EnterSection("GAME");
-
-	if ( battle.IsFounderMe() ) {
-		tdf.Append("HostIP", ""); //Listen on all addresses for connections when hosting
-		if ( battle.GetNatType() == NAT_Hole_punching ) tdf.Append("HostPort", battle.GetMyInternalUdpSourcePort() );
-		else tdf.Append("HostPort", battle.GetHostPort() );
+	ScriptTxt::Script script;
+
+	const bool founder = battle.IsFounderMe();
+	script.is_host = founder;
+	if ( founder ) {
+		//Listen on all addresses for connections when hosting, HostIP stays empty
+		if ( battle.GetNatType() == NAT_Hole_punching ) script.host_port = battle.GetMyInternalUdpSourcePort();
+		else script.host_port = battle.GetHostPort();
 	} else {
-		tdf.Append("HostIP", battle.GetHostIp() );
-		tdf.Append("HostPort", battle.GetHostPort() );
+		script.host_ip = battle.GetHostIp();
+		script.host_port = battle.GetHostPort();
 		if ( battle.GetNatType() == NAT_Hole_punching ) {
-			tdf.Append("SourcePort", battle.GetMyInternalUdpSourcePort() );
-		} else if ( sett().GetClientPort() != 0) {
-			tdf.Append("SourcePort", sett().GetClientPort() ); /// this allows to play with broken router by setting SourcePort to some forwarded port.
+			script.has_source_port = true;
+			script.source_port = battle.GetMyInternalUdpSourcePort();
+		} else {
+			const int clientport = sett().GetClientPort();
+			if ( clientport != 0 ) { /// this allows to play with broken router by setting SourcePort to some forwarded port.
+				script.has_source_port = true;
+				script.source_port = clientport;
+			}
 		}
 	}
-	tdf.Append("IsHost", battle.IsFounderMe() );
 
 	User& me = battle.GetMe();
-	tdf.Append("MyPlayerName", me.GetNick());
-
-	if ( !me.BattleStatus().scriptPassword.empty() ) {
-		tdf.Append("MyPasswd", me.BattleStatus().scriptPassword);
-	}
+	script.my_name = me.GetNick();
+	script.my_password = me.BattleStatus().scriptPassword;
 
-	if ( !battle.IsFounderMe() ) {
-		tdf.LeaveSection();
-		return TowxString(ret.str());
-	}
+	if ( !founder ) return script;
 
 	/**********************************************************************************
 																Host-only section
 	**********************************************************************************/
 
-	tdf.AppendLineBreak();
-
-	tdf.Append("ModHash", battle.LoadMod().hash);
-	tdf.Append("MapHash", battle.LoadMap().hash);
-
-	tdf.Append("Mapname", battle.GetHostMapName());
-	tdf.Append("GameType", battle.GetHostModName());
-
-	tdf.AppendLineBreak();
+	script.mod_hash = battle.LoadMod().hash;
+	script.map_hash = battle.LoadMap().hash;
+	script.map_name = battle.GetHostMapName();
+	script.game_type = battle.GetHostModName();
 
 	switch ( battle.GetBattleType() ) {
 	case BT_Played:
 		break;
-	case BT_Replay: {
-		wxString path = TowxString(battle.GetPlayBackFilePath());
-		if ( path.Find(_T("/")) != wxNOT_FOUND ) path.BeforeLast(_T('/'));
-		tdf.Append("DemoFile", STD_STRING(path));
-		tdf.AppendLineBreak();
+	case BT_Replay:
+		script.playback_key = "DemoFile";
+		script.playback_path = battle.GetPlayBackFilePath();
 		break;
-	}
-	case BT_Savegame: {
-		wxString path = TowxString(battle.GetPlayBackFilePath());
-		if ( path.Find(_T("/")) != wxNOT_FOUND ) path.BeforeLast(_T('/'));
-		tdf.Append("Savefile", STD_STRING(path));
-		tdf.AppendLineBreak();
+	case BT_Savegame:
+		script.playback_key = "Savefile";
+		script.playback_path = battle.GetPlayBackFilePath();
 		break;
-	}
 	default:
 		slLogDebugFunc("");
 		break;
 	}
 
+	const unsigned int NumUsers = battle.GetNumUsers();
+	std::vector<User*> users( NumUsers );
+	for ( unsigned int i = 0; i < NumUsers; i++ ) {
+		users[i] = &battle.GetUser( i );
+	}
+
 	const long startpostype = LSL::Util::FromString<long>(
 					  battle.CustomBattleOptions().getSingleValue("startpostype", LSL::Enum::EngineOption ));
 
 	std::vector<LSL::StartPos> remap_positions;
 	if ( battle.IsProxy() && ( startpostype != IBattle::ST_Pick ) && ( startpostype != IBattle::ST_Choose ) ) {
 		std::set<int> parsedteams;
-		unsigned int NumUsers = battle.GetNumUsers();
 		unsigned int NumTeams = 0;
 		for ( unsigned int i = 0; i < NumUsers; i++ ) {
-			User& usr = battle.GetUser( i );
-			UserBattleStatus& status = usr.BattleStatus();
+			UserBattleStatus& status = users[i]->BattleStatus();
 			if ( status.spectator ) continue;
 			if ( parsedteams.find( status.team ) != parsedteams.end() ) continue; // skip duplicates
 			parsedteams.insert( status.team );
@@ -265,51 +263,32 @@ wxString Spring::WriteScriptTxt( IBattle& battle ) const
 		}
 
 	}
-	if ( battle.IsProxy() ) {
-		if ( ( startpostype == IBattle::ST_Random ) || ( startpostype == IBattle::ST_Fixed ) ) {
-			tdf.Append("startpostype", IBattle::ST_Pick );
-		} else tdf.Append("startpostype", startpostype );
-	} else tdf.Append("startpostype", startpostype );
+	if ( battle.IsProxy() && ( ( startpostype == IBattle::ST_Random ) || ( startpostype == IBattle::ST_Fixed ) ) ) {
+		script.startpostype = IBattle::ST_Pick;
+	} else {
+		script.startpostype = startpostype;
+	}
+	script.relay_startpostype = startpostype; // also save the original wanted setting
 
-	tdf.EnterSection("mapoptions");
 	for (const auto& it : battle.CustomBattleOptions().getOptions( LSL::Enum::MapOption )) {
-		tdf.Append(it.first, it.second.second);
+		script.map_options.push_back( std::make_pair( it.first, it.second.second ) );
 	}
-	tdf.LeaveSection();
-
-
-	tdf.EnterSection("modoptions");
-	tdf.Append("relayhoststartpostype", startpostype ); // also save the original wanted setting
 	for (const auto& it : battle.CustomBattleOptions().getOptions( LSL::Enum::ModOption )) {
-		tdf.Append(it.first, it.second.second);
+		script.mod_options.push_back( std::make_pair( it.first, it.second.second ) );
 	}
-	tdf.LeaveSection();
-
-	std::map<std::string,int> units = battle.RestrictedUnits();
-	tdf.Append("NumRestrictions", units.size());
-	tdf.EnterSection("RESTRICT");
-	int restrictcount = 0;
-	for ( std::map<std::string, int>::const_iterator itor = units.begin(); itor != units.end(); ++itor ) {
-		tdf.Append(stdprintf("Unit%d", restrictcount), itor->first );
-		tdf.Append(stdprintf("Limit%d", restrictcount), itor->second );
-		restrictcount++;
-	}
-	tdf.LeaveSection();
-
 
-	tdf.AppendLineBreak();
+	const std::map<std::string,int> units = battle.RestrictedUnits();
+	script.restrictions.assign( units.begin(), units.end() );
 
 	if ( battle.IsProxy() ) {
-		tdf.Append("NumPlayers", battle.GetNumPlayers() -1 );
-		tdf.Append("NumUsers", battle.GetNumUsers() -1 );
+		script.num_players = battle.GetNumPlayers() -1;
+		script.num_users = NumUsers -1;
 	} else {
-		tdf.Append("NumPlayers", battle.GetNumPlayers() );
-		tdf.Append("NumUsers", battle.GetNumUsers() );
+		script.num_players = battle.GetNumPlayers();
+		script.num_users = NumUsers;
 	}
 
-	tdf.AppendLineBreak();
-
-	unsigned int NumUsers = battle.GetNumUsers();
+	const std::string proxy_nick = battle.IsProxy() ? battle.GetFounder().GetNick() : std::string();
 
 	typedef std::map<int, int> ProgressiveTeamsVec;
 	typedef ProgressiveTeamsVec::iterator ProgressiveTeamsVecIter;
@@ -318,7 +297,7 @@ wxString Spring::WriteScriptTxt( IBattle& battle ) const
 	std::map<User*, int> player_to_number; // player -> ordernumber
 	srand ( time(NULL) );
 	for ( unsigned int i = 0; i < NumUsers; i++ ) {
-		User& user = battle.GetUser( i );
+		User& user = *users[i];
 		UserBattleStatus& status = user.BattleStatus();
 		if ( !status.spectator ) {
 			ProgressiveTeamsVecIter itor = teams_to_sorted_teams.find ( status.team );
@@ -327,107 +306,94 @@ wxString Spring::WriteScriptTxt( IBattle& battle ) const
 				free_team++;
 			}
 		}
-		if ( battle.IsProxy() && ( user.GetNick() == battle.GetFounder().GetNick() ) ) continue;
+		if ( battle.IsProxy() && ( user.GetNick() == proxy_nick ) ) continue;
 		if ( status.IsBot() ) continue;
-		tdf.EnterSection(stdprintf("PLAYER%d", i));
-		tdf.Append("Name", user.GetNick() );
-		tdf.Append("CountryCode", STD_STRING(TowxString(user.GetCountry()).Lower()));
-		tdf.Append("Spectator", status.spectator );
-		tdf.Append("Rank", (int)user.GetRank() );
-		tdf.Append("IsFromDemo", int(status.isfromdemo) );
-		if ( !status.scriptPassword.empty() ) {
-			tdf.Append("Password", status.scriptPassword );
-		}
+		ScriptTxt::Player player;
+		player.number = i;
+		player.name = user.GetNick();
+		player.country = STD_STRING(TowxString(user.GetCountry()).Lower());
+		player.spectator = status.spectator;
+		player.rank = (int)user.GetRank();
+		player.isfromdemo = status.isfromdemo;
+		player.password = status.scriptPassword;
 		if ( !status.spectator ) {
-			tdf.Append("Team", teams_to_sorted_teams[status.team] );
+			player.team = teams_to_sorted_teams[status.team];
 		} else {
 			int speccteam = 0;
 			if ( !teams_to_sorted_teams.empty() ) speccteam = rand() % teams_to_sorted_teams.size();
-			tdf.Append("Team", speccteam );
+			player.team = speccteam;
 		}
-		tdf.LeaveSection();
+		script.players.push_back( player );
 		player_to_number[&user] = i;
 	}
 	for ( unsigned int i = 0; i < NumUsers; i++ ) {
-		User& user = battle.GetUser( i );
+		User& user = *users[i];
 		UserBattleStatus& status = user.BattleStatus();
 		if ( !status.IsBot() ) continue;
-		tdf.EnterSection(stdprintf("AI%d", i));
-		tdf.Append("Name", user.GetNick()); // AI's nick;
-		tdf.Append("ShortName", status.aishortname ); // AI libtype
-		tdf.Append("Version", status.aiversion ); // AI libtype version
-		tdf.Append("Team", teams_to_sorted_teams[status.team] );
-		tdf.Append("IsFromDemo", int(status.isfromdemo) );
-		tdf.Append("Host", player_to_number[&battle.GetUser( status.owner )] );
-		tdf.EnterSection("Options");
+		ScriptTxt::AI ai;
+		ai.number = i;
+		ai.name = user.GetNick(); // AI's nick;
+		ai.shortname = status.aishortname; // AI libtype
+		ai.version = status.aiversion; // AI libtype version
+		ai.team = teams_to_sorted_teams[status.team];
+		ai.isfromdemo = status.isfromdemo;
+		ai.host = player_to_number[&battle.GetUser( status.owner )];
 		int optionmapindex = battle.CustomBattleOptions().GetAIOptionIndex(user.GetNick());
 		if ( optionmapindex > 0 ) {
 			for (const auto& it : battle.CustomBattleOptions().getOptions((LSL::Enum::GameOption)optionmapindex )) {
-				tdf.Append(it.first, it.second.second);
+				ai.options.push_back( std::make_pair( it.first, it.second.second ) );
 			}
 		}
-		tdf.LeaveSection();
-		tdf.LeaveSection();
+		script.ais.push_back( ai );
 		player_to_number[&user] = i;
 	}
 
-	tdf.AppendLineBreak();
-
 	std::set<int> parsedteams;
 	const auto sides = LSL::usync().GetSides(battle.GetHostModName());
 	for ( unsigned int i = 0; i < NumUsers; i++ ) {
-		User& usr = battle.GetUser( i );
+		User& usr = *users[i];
 		UserBattleStatus& status = usr.BattleStatus();
 		if ( status.spectator ) continue;
 		if ( parsedteams.find( status.team ) != parsedteams.end() ) continue; // skip duplicates
 		parsedteams.insert( status.team );
 
-		tdf.EnterSection(stdprintf("TEAM%d", teams_to_sorted_teams[status.team]));
+		ScriptTxt::Team team;
+		team.number = teams_to_sorted_teams[status.team];
 		if ( status.IsBot() ) {
-			tdf.Append("TeamLeader", player_to_number[&battle.GetUser( status.owner )] );
+			team.leader = player_to_number[&battle.GetUser( status.owner )];
 		} else {
-			tdf.Append("TeamLeader", player_to_number[&usr] );
+			team.leader = player_to_number[&usr];
 		}
-		if ( battle.IsProxy() ) {
-			if ( startpostype == IBattle::ST_Pick ) {
-				tdf.Append("StartPosX", status.pos.x );
-				tdf.Append("StartPosZ", status.pos.y );
-			} else if ( ( startpostype == IBattle::ST_Fixed ) || ( startpostype == IBattle::ST_Random ) ) {
-				int teamnumber = teams_to_sorted_teams[status.team];
-				if ( teamnumber < int(remap_positions.size()) ) { // don't overflow
-					LSL::StartPos position = remap_positions[teamnumber];
-					tdf.Append("StartPosX", position.x );
-					tdf.Append("StartPosZ", position.y );
-				}
-			}
-		} else {
-			if ( startpostype == IBattle::ST_Pick ) {
-				tdf.Append("StartPosX", status.pos.x );
-				tdf.Append("StartPosZ", status.pos.y );
+		if ( startpostype == IBattle::ST_Pick ) {
+			team.has_startpos = true;
+			team.startx = status.pos.x;
+			team.startz = status.pos.y;
+		} else if ( battle.IsProxy() && ( ( startpostype == IBattle::ST_Fixed ) || ( startpostype == IBattle::ST_Random ) ) ) {
+			if ( team.number < int(remap_positions.size()) ) { // don't overflow
+				const LSL::StartPos& position = remap_positions[team.number];
+				team.has_startpos = true;
+				team.startx = position.x;
+				team.startz = position.y;
 			}
 		}
-
-		tdf.Append("AllyTeam",status.ally );
-
-		wxString colourstring =
-			TowxString( status.colour.Red()/255.0 ) + _T(' ') +
-			TowxString( status.colour.Green()/255.0 ) + _T(' ') +
-			TowxString( status.colour.Blue()/255.0 );
-		tdf.Append("RGBColor", STD_STRING(colourstring));
-
-		unsigned int side = status.side;
-		if ( side < sides.size() ) tdf.Append("Side", sides[side] );
-		tdf.Append("Handicap", status.handicap );
-		tdf.LeaveSection();
+		team.ally = status.ally;
+		team.red = status.colour.Red();
+		team.green = status.colour.Green();
+		team.blue = status.colour.Blue();
+		const unsigned int side = status.side;
+		if ( side < sides.size() ) {
+			team.has_side = true;
+			team.side = sides[side];
+		}
+		team.handicap = status.handicap;
+		script.teams.push_back( team );
 	}
 
-	tdf.AppendLineBreak();
-
 	unsigned int maxiter = std::max( NumUsers, battle.GetLastRectIdx() + 1 );
 	std::set<int> parsedallys;
 	for ( unsigned int i = 0; i < maxiter; i++ ) {
 
-		User& usr = battle.GetUser( i );
+		User& usr = ( i < NumUsers ) ? *users[i] : battle.GetUser( i );
 		UserBattleStatus& status = usr.BattleStatus();
 		BattleStartRect sr = battle.GetStartRect( i );
 		if ( status.spectator && !sr.IsOk() )
@@ -440,23 +406,29 @@ wxString Spring::WriteScriptTxt( IBattle& battle ) const
 		sr = battle.GetStartRect( ally );
 		parsedallys.insert( ally );
 
-		tdf.EnterSection( stdprintf("ALLYTEAM%d", ally));
-		tdf.Append("NumAllies", 0 );
-		if ( startpostype == IBattle::ST_Choose ) {
-			if ( sr.IsOk() ) {
-				const char* old_locale = std::setlocale(LC_NUMERIC, "C");
-
-				tdf.Append("StartRectLeft", wxFormat( _T("%.3f") ) % ( sr.left / 200.0 ) );
-				tdf.Append("StartRectTop", wxFormat( _T("%.3f") ) % ( sr.top / 200.0 ) );
-				tdf.Append("StartRectRight", wxFormat( _T("%.3f") ) % ( sr.right / 200.0 ) );
-				tdf.Append("StartRectBottom", wxFormat( _T("%.3f") ) % ( sr.bottom / 200.0 ) );
-
-				std::setlocale(LC_NUMERIC, old_locale);
-			}
+		ScriptTxt::AllyTeam allyteam;
+		allyteam.number = ally;
+		if ( ( startpostype == IBattle::ST_Choose ) && sr.IsOk() ) {
+			allyteam.has_rect = true;
+			allyteam.left = sr.left;
+			allyteam.top = sr.top;
+			allyteam.right = sr.right;
+			allyteam.bottom = sr.bottom;
 		}
-		tdf.LeaveSection();
+		script.allyteams.push_back( allyteam );
 	}
 
-	tdf.LeaveSection();
-	return TowxString(ret.str());
+	return script;
+}
+
+//! the start script as UTF-8
+static std::string GetScriptTxt( IBattle& battle )
+{
+	wxLogMessage(_T("0 WriteScriptTxt called "));
+	return ScriptTxt::Write( GetScript( battle ) );
+}
+
+wxString Spring::WriteScriptTxt( IBattle& battle ) const
+{
+	return TowxString( GetScriptTxt( battle ) );
 }
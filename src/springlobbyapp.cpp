@@ -54,6 +54,7 @@
 #include "log.h"
 #include "utils/conversion.h"
 #include "gui/ui.h"
+#include "startuploader.h"
 
 #include <wx/debugrpt.h>
 #include <wx/intl.h>
@@ -111,6 +112,9 @@ bool SpringLobbyApp::OnInit()
 	wxHandleFatalExceptions( !m_crash_handle_disable );
 #endif
 
+	// the timeline starts when the loader is created
+	const size_t init_stage = startupLoader().BeginStage("init");
+
     //initialize all loggers, we'll use the returned pointer to set correct parent window later
 	wxLogWindow *loggerwin = Logger::InitializeLoggingTargets( 0, m_log_console, m_log_file_path, m_log_window_show, m_log_verbosity);
 
@@ -157,21 +161,26 @@ bool SpringLobbyApp::OnInit()
 
 	// configure unitsync paths before trying to load
 	SlPaths::ReconfigureUnitsync();
+	startupLoader().EndStage(init_stage);
 
-	//unitsync first load, NEEDS to be blocking
-	SlPaths::RefreshSpringVersionList();
-	LSL::usync().ReloadUnitSyncLib();
-
-
-	sett().Setup(m_translationhelper);
+	// spring versions and unitsync are loaded in the background, windows update on OnUnitsyncReloaded
+	startupLoader().Start();
 
-	notificationManager(); //needs to be initialized too
-    ui().ShowMainWindow();
-    SetTopWindow( &ui().mw() );
-
-	ui().OnInit();
-
-	ui().mw().SetLogWin( loggerwin);
+	{
+		StartupLoader::ScopedStage stage("settings");
+		sett().Setup(m_translationhelper);
+		notificationManager(); //needs to be initialized too
+	}
+	{
+		StartupLoader::ScopedStage stage("main window");
+		ui().ShowMainWindow();
+		SetTopWindow( &ui().mw() );
+	}
+	{
+		StartupLoader::ScopedStage stage("ui");
+		ui().OnInit();
+		ui().mw().SetLogWin( loggerwin);
+	}
 	return true;
 }
 
@@ -191,6 +200,7 @@ int SpringLobbyApp::OnExit()
     }
 
   	sett().SaveSettings(); // to make sure that cache path gets saved before destroying unitsync
+	cfg().FinishSaving();
 
     SetEvtHandlerEnabled(false);
 	UiEvents::GetNotificationEventSender().Enable( false );
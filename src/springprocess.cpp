@@ -15,11 +15,15 @@ lsl/spring/springprocess.cpp
 
 
 #include <wx/log.h>
+#include <wx/stopwatch.h>
+#include <vector>
 
 #include "springprocess.h"
 #include "spring.h"
 #include "utils/conversion.h"
 #include "utils/platform.h"
+#include "utils/ringbuffer.h"
+#include "utils/spawnprocess.h"
 #include "log.h"
 
 #ifdef __WXMSW__
@@ -31,6 +35,18 @@ lsl/spring/springprocess.cpp
 
 DEFINE_LOCAL_EVENT_TYPE( wxEVT_SPRING_EXIT )
 
+//! size of the kept engine output
+static const size_t OUTPUT_SIZE = 256 * 1024;
+
+static wxMutex s_output_mutex;
+static RingBuffer s_output( OUTPUT_SIZE );
+
+std::string GetSpringOutput()
+{
+	wxMutexLocker lock( s_output_mutex );
+	return s_output.GetContents();
+}
+
 
 SpringProcess::SpringProcess( Spring& sp ) :
 		m_sp( sp ), m_exit_code( 0 )
@@ -63,7 +79,46 @@ void SpringProcess::OnExit()
 void* SpringProcess::Entry()
 {
 	slLogDebugFunc("");
+#ifdef __WXMSW__
 	RunProcess(m_cmd, m_params);
+#else
+	// no shell, the arguments are passed as they are
+	std::vector<std::string> argv;
+	argv.push_back( STD_STRING( m_cmd ) );
+	for ( size_t i = 0; i < m_params.GetCount(); i++ ) {
+		argv.push_back( STD_STRING( m_params[i] ) );
+	}
+	{
+		wxMutexLocker lock( s_output_mutex );
+		s_output.Clear();
+	}
+
+	wxStopWatch clock;
+	SpawnProcess proc;
+	std::string error;
+	if ( !proc.Start( argv, &error ) ) {
+		// already reported here, the exit code stays 0 so no crash report is offered
+		wxLogError( _T("Couldn't start %s: %s"), m_cmd.c_str(), TowxString( error ).c_str() );
+		return NULL;
+	}
+
+	// read until the engine closes its output, this also returns when it exits
+	bool first = true;
+	char buf[4096];
+	int len;
+	while ( ( len = proc.Read( buf, sizeof( buf ) ) ) != -1 ) {
+		if ( len == 0 ) continue;
+		if ( first ) {
+			wxLogMessage( _T("first engine output %ld ms after launch"), clock.Time() );
+			first = false;
+		}
+		wxMutexLocker lock( s_output_mutex );
+		s_output.Write( buf, len );
+	}
+	// nonzero, or -1 when killed by a signal, makes Ui offer the debug report with the output
+	m_exit_code = proc.Wait();
+	wxLogMessage( _T("engine exited with code %d after %ld ms"), m_exit_code, clock.Time() );
+#endif
 	return NULL;
 }
 
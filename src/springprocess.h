@@ -19,6 +19,7 @@ lsl/spring/springprocess.h
 #include <wx/thread.h>
 #include <wx/string.h>
 #include <wx/process.h>
+#include <string>
 
 BEGIN_DECLARE_EVENT_TYPES()
 DECLARE_LOCAL_EVENT_TYPE( wxEVT_SPRING_EXIT, 1 )
@@ -44,4 +45,7 @@ private:
 
 const int PROC_SPRING = wxID_HIGHEST;
 
+//! the last output of the engine (stdout and stderr), kept while it runs and after it exited
+std::string GetSpringOutput();
+
 #endif // SPRINGLOBBY_HEADERGUARD_SPRINGPROCESS_H
@@ -50,6 +50,7 @@ void key_binding::bind( const wxString& cmd, const wxString& keyString )
 		m_groups[ normKey ].push_back( cmd );
 		m_keyCmdSet.insert( std::make_pair( normKey, cmd ) );
 	}
+	m_cmdKeySet.insert( std::make_pair( cmd, normKey ) );
 }
 
 void key_binding::addKeySymSet( const wxString& name, const wxString& keyString )
@@ -190,49 +191,35 @@ bool key_binding::isEmpty() const
 
 void key_binding::unbindAllCmds( const wxString& cmd )
 {
-	key_command_set keyCmdSetCopy = m_keyCmdSet;
-	key_command_set keyCmdSetAnyCopy = m_keyCmdSetAny;
-
-	for ( key_command_set::const_iterator iter = keyCmdSetCopy.begin(); iter != keyCmdSetCopy.end(); ++iter )
+	//all commands matching cmd start with it, so they are next to each other in m_cmdKeySet
+	key_commands_sorted matches;
+	for ( key_command_set::const_iterator iter = m_cmdKeySet.lower_bound( std::make_pair( cmd, wxString() ) ); iter != m_cmdKeySet.end(); ++iter )
 	{
-		if ( key_binding::isCmd1MatchingCmd2( cmd, iter->second ) )
-		{
-			this->unbind( iter->second, iter->first );
-		}
+		if ( !iter->first.StartsWith( cmd ) )
+			break;
+		if ( key_binding::isCmd1MatchingCmd2( cmd, iter->first ) )
+			matches.push_back( *iter );
 	}
 
-	for ( key_command_set::const_iterator iter = keyCmdSetAnyCopy.begin(); iter != keyCmdSetAnyCopy.end(); ++iter )
+	for ( key_commands_sorted::const_iterator iter = matches.begin(); iter != matches.end(); ++iter )
 	{
-		if ( key_binding::isCmd1MatchingCmd2( cmd, iter->second ) )
-		{
-			this->unbind( iter->second, iter->first );
-		}
+		this->unbind( iter->first, iter->second );
 	}
 }
 
 void key_binding::unbindAllKeys( const wxString& key )
 {
-	if ( !key.StartsWith( wxT("Any+") ) )
+	const key_command_set& keyCmdSet = key.StartsWith( wxT("Any+") ) ? m_keyCmdSetAny : m_keyCmdSet;
+
+	key_commands_sorted matches;
+	for ( key_command_set::const_iterator iter = keyCmdSet.lower_bound( std::make_pair( key, wxString() ) ); iter != keyCmdSet.end() && iter->first == key; ++iter )
 	{
-		key_command_set keyCmdSetCopy = m_keyCmdSet;
-		for ( key_command_set::const_iterator iter = keyCmdSetCopy.begin(); iter != keyCmdSetCopy.end(); ++iter )
-		{
-			if ( iter->first == key )
-			{
-				this->unbind( iter->second, iter->first );
-			}
-		}
+		matches.push_back( *iter );
 	}
-	else
+
+	for ( key_commands_sorted::const_iterator iter = matches.begin(); iter != matches.end(); ++iter )
 	{
-		key_command_set keyCmdSetAnyCopy = m_keyCmdSetAny;
-		for ( key_command_set::const_iterator iter = keyCmdSetAnyCopy.begin(); iter != keyCmdSetAnyCopy.end(); ++iter )
-		{
-			if ( iter->first == key )
-			{
-				this->unbind( iter->second, iter->first );
-			}
-		}
+		this->unbind( iter->second, iter->first );
 	}
 }
 
@@ -244,6 +231,7 @@ void key_binding::unbind( const wxString& cmd, const wxString& keyString )
 	}
 
 	const wxString normKey = KeynameConverter::normalizeSpringKey( keyString );
+	m_cmdKeySet.erase( std::make_pair( cmd, normKey ) );
 	if ( normKey.StartsWith( wxT("Any+") ) )
 	{
 		m_keyCmdSetAny.erase( std::make_pair( normKey, cmd ) );
@@ -297,6 +285,7 @@ void key_binding::clear()
 	this->m_groupsAny.clear();
 	this->m_keyCmdSetAny.clear();
 	this->m_keyCmdSet.clear();
+	this->m_cmdKeySet.clear();
 	this->m_keySyms.clear();
 	this->m_keySymsSet.clear();
 	this->m_meta.clear();
@@ -370,6 +359,7 @@ const key_binding key_binding::operator-(const key_binding& other) const
 	resBind.m_groupsAny.clear();
 	resBind.m_keyCmdSet.clear();
 	resBind.m_keyCmdSetAny.clear();
+	resBind.m_cmdKeySet.clear();
 
 	//normal keys
 	for( KeyGroupMap::const_iterator iter = m_groups.begin(); iter != m_groups.end(); ++iter )
@@ -77,6 +77,8 @@ private:
 
 	key_command_set												m_keyCmdSet;
 	key_command_set												m_keyCmdSetAny;
+	//(command, key) pairs of both sets above, to find the keys of a command
+	key_command_set												m_cmdKeySet;
 
 	key_sym_map													m_keySyms;
 	key_sym_map													m_keySymsRev;
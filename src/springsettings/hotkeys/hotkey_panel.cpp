@@ -115,9 +115,10 @@ void hotkey_panel::OnAddCommand( const wxString& cmd )
 	{
 		CommandList::addCustomCommand( cmd );
 
-		//refresh view
-		this->updateTreeView();
-		this->addCommandToAllPanelProfiles( CommandList::getCommandByName( cmd ) );
+		//add the new command to the profiles and its row to the tree
+		const CommandList::Command& command = CommandList::getCommandByName( cmd );
+		this->addCommandToAllPanelProfiles( command );
+		this->m_pKeyConfigPanel->ImportRawCommand( command.m_category, command.m_command, command.m_id );
 	}
 	catch( const HotkeyException& ex )
 	{
@@ -518,7 +519,8 @@ key_binding_collection hotkey_panel::getProfilesFromSettings()
 void hotkey_panel::UpdateControls(int /*unused*/)
 {
 	m_uikeys_manager.setUiKeys(TowxString(SlPaths::GetUikeys()));
-	this->updateTreeView();
+	const key_binding_collection profiles = hotkey_panel::getProfilesFromSettings();
+	this->updateTreeView( profiles );
 
 	//Fetch the profiles
 	this->m_pKeyConfigPanel->RemoveAllProfiles();
@@ -531,7 +533,6 @@ void hotkey_panel::UpdateControls(int /*unused*/)
 
 	//put user profiles from springsettings configuration
 	{
-		key_binding_collection profiles = hotkey_panel::getProfilesFromSettings();
 		for( key_binding_collection::const_iterator piter = profiles.begin(); piter != profiles.end(); ++piter )
 		{
 			wxString profName = piter->first;
@@ -551,7 +552,7 @@ void hotkey_panel::UpdateControls(int /*unused*/)
 	selectProfileFromUikeys();
 }
 
-void hotkey_panel::updateTreeView()
+void hotkey_panel::updateTreeView( const key_binding_collection& profiles )
 {
 	wxKeyConfigPanel::ControlMap ctrlMap;
 
@@ -565,7 +566,6 @@ void hotkey_panel::updateTreeView()
 	}
 
 	{	//2. import springsettings-config-profiles
-		key_binding_collection profiles = hotkey_panel::getProfilesFromSettings();
 		for( key_binding_collection::const_iterator piter = profiles.begin(); piter != profiles.end(); ++piter )
 		{
 			const wxString profName = piter->first;
@@ -45,7 +45,7 @@ public:
 private:
 	void selectProfileFromUikeys();
 	wxString getNextFreeProfileName();
-	void updateTreeView();
+	void updateTreeView( const key_binding_collection& profiles );
 
 	static key_binding_collection getProfilesFromSettings();
 	static key_binding getBindingsFromProfile( const wxKeyProfile& profile );
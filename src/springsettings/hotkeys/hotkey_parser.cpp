@@ -9,6 +9,7 @@
 #include <wx/intl.h>
 #include <wx/log.h>
 #include <wx/textfile.h>
+#include <wx/ffile.h>
 #include <wx/tokenzr.h>
 #include <wx/filename.h>
 
@@ -110,12 +111,18 @@ hotkey_parser::~hotkey_parser(void)
 }
 std::vector<wxString> hotkey_parser::tokenize_uikeys_line( const wxString& line )
 {
-	wxStringTokenizer tkz( line, wxT(" \t") );
-
 	std::vector<wxString> data;
-	while ( tkz.HasMoreTokens() )
+	const size_t len = line.length();
+	size_t pos = 0;
+	while ( pos < len )
 	{
-		data.push_back( tkz.GetNextToken() );
+		while ( pos < len && ( line[pos] == wxT(' ') || line[pos] == wxT('\t') ) )
+			++pos;
+		const size_t start = pos;
+		while ( pos < len && line[pos] != wxT(' ') && line[pos] != wxT('\t') )
+			++pos;
+		if ( pos > start )
+			data.push_back( line.Mid( start, pos - start ) );
 	}
 	return data;
 }
@@ -125,55 +132,73 @@ const key_binding& hotkey_parser::getBindings() const
 	return this->m_bindings;
 }
 
-void hotkey_parser::writeBindingsToFile( const key_binding& springbindings )
+//! kinds of uikeys.txt lines, in the order they are written so keysyms come before the binds using them
+enum LineKind
 {
-	const wxString newTmpFilename = wxFileName::CreateTempFileName( _T("uikeys."));
-	wxTextFile newFile( newTmpFilename );
-
-	//open new file for writing
-	if ( ( !newFile.Exists() && !newFile.Create() ) || ( newFile.Exists() && !newFile.Open() ) )
-	{
-		throw HotkeyException( _("Error opening file for writing: ") + newTmpFilename );
-	}
-
-	//now read the old uikeys.txt line after line and copy all comments to the new file
-	wxTextFile oldFile( this->m_filename );
-	if ( !oldFile.Open() )
+	LINE_KEYSYM,
+	LINE_KEYSET,
+	LINE_FAKEMETA,
+	LINE_UNBIND,
+	LINE_BIND,
+	LINE_OTHER //comments and empty lines
+};
+
+//! position for a new line of @p kind: after the last line of the same or an earlier kind
+static size_t insertPosition( const std::vector<int>& kinds, int kind )
+{
+	size_t pos = kinds.size();
+	for( size_t i = kinds.size(); i > 0; --i )
 	{
-        throw HotkeyException( _("Error opening file for reading: ") + m_filename );
+		if ( kinds[i - 1] == LINE_OTHER )
+			continue;
+		if ( kinds[i - 1] <= kind )
+			return i;
+		pos = i - 1;
 	}
+	return pos;
+}
 
-	for( size_t i = 0; i < oldFile.GetLineCount(); ++i )
+void hotkey_parser::writeBindingsToFile( const key_binding& springbindings )
+{
+	//read the old uikeys.txt at once, only the lines of changed bindings are replaced
+	const wxMBConv* conv = &wxConvUTF8;
+	wxString oldContent;
 	{
-		wxString line = oldFile.GetLine( i );
-		line.Trim();
-		if ( line.StartsWith(wxT("//")) )
+		wxFFile oldFile( this->m_filename, wxT("rb") );
+		if ( !oldFile.IsOpened() || !oldFile.ReadAll( &oldContent, *conv ) )
 		{
-			newFile.AddLine( line );
+			throw HotkeyException( _("Error opening file for reading: ") + m_filename );
+		}
+		//comments in a legacy encoding aren't valid utf-8, latin-1 keeps their bytes as they are
+		if ( oldContent.empty() && oldFile.Length() > 0 )
+		{
+			conv = &wxConvISO8859_1;
+			if ( !oldFile.Seek( 0 ) || !oldFile.ReadAll( &oldContent, *conv ) )
+			{
+				throw HotkeyException( _("Error opening file for reading: ") + m_filename );
+			}
 		}
 	}
-	oldFile.Close();
+
+	//the lines the current bindings need
+	std::vector< std::pair<int, wxString> > wanted;
 
 	//add keysyms
-	//key_sym_map keySymRev;
 	for( key_sym_map::const_iterator iter = springbindings.getKeySyms().begin(); iter != springbindings.getKeySyms().end(); ++iter )
 	{
-		newFile.AddLine( wxT("keysym\t\t") + iter->first + wxT("\t\t") + iter->second );
-		//keySymRev[ KeynameConverter::convertHexValueToKey( iter->second ) ] = iter->first;
+		wanted.push_back( std::make_pair( LINE_KEYSYM, wxT("keysym\t\t") + iter->first + wxT("\t\t") + iter->second ) );
 	}
 
 	//add keysyms
-	//key_sym_map keySymSetRev;
 	for( key_sym_set_map::const_iterator iter = springbindings.getKeySymsSet().begin(); iter != springbindings.getKeySymsSet().end(); ++iter )
 	{
-		newFile.AddLine( wxT("keyset\t\t") + iter->first + wxT("\t\t") + springbindings.resolveKeySymKey(iter->second ) );
-		//keySymSetRev[ iter->second ] = iter->first;
+		wanted.push_back( std::make_pair( LINE_KEYSET, wxT("keyset\t\t") + iter->first + wxT("\t\t") + springbindings.resolveKeySymKey(iter->second ) ) );
 	}
 
 	//add fakemeta
 	if ( SpringDefaultProfile::getBindings().getMetaKey() != springbindings.getMetaKey() )
 	{
-		newFile.AddLine( wxT("fakemeta\t\t") + springbindings.getMetaKey() );
+		wanted.push_back( std::make_pair( LINE_FAKEMETA, wxT("fakemeta\t\t") + springbindings.getMetaKey() ) );
 	}
 
 	//check all default bindings if they still exist in current profile
@@ -181,17 +206,95 @@ void hotkey_parser::writeBindingsToFile( const key_binding& springbindings )
 	const key_commands_sorted unbinds = (SpringDefaultProfile::getBindings() - springbindings).getBinds();
 	for( key_commands_sorted::const_iterator iter = unbinds.begin(); iter != unbinds.end(); ++iter )
 	{
-		newFile.AddLine( wxT("unbind\t\t") + springbindings.resolveKeySymKeyAndSet( iter->first ) + wxT("\t\t") + iter->second );
+		wanted.push_back( std::make_pair( LINE_UNBIND, wxT("unbind\t\t") + springbindings.resolveKeySymKeyAndSet( iter->first ) + wxT("\t\t") + iter->second ) );
 	}
 
 	//add binds, should be ordered
 	const key_commands_sorted dobinds = (springbindings - SpringDefaultProfile::getBindings()).getBinds();
 	for( key_commands_sorted::const_iterator iter = dobinds.begin(); iter != dobinds.end(); ++iter )
 	{
-		newFile.AddLine( wxT("bind\t\t") + springbindings.resolveKeySymKeyAndSet( iter->first ) + wxT("\t\t") + iter->second );
+		wanted.push_back( std::make_pair( LINE_BIND, wxT("bind\t\t") + springbindings.resolveKeySymKeyAndSet( iter->first ) + wxT("\t\t") + iter->second ) );
 	}
 
-	newFile.Write();
+	//lines are compared by their tokens, so the user's spacing doesn't count as a change
+	std::map<wxString, size_t> wantedIndex;
+	for( size_t i = 0; i < wanted.size(); ++i )
+	{
+		const std::vector<wxString> tokens = tokenize_uikeys_line( wanted[i].second );
+		wxString key;
+		for( size_t t = 0; t < tokens.size(); ++t )
+			key += tokens[t] + wxT(" ");
+		wantedIndex.insert( std::make_pair( key, i ) );
+	}
+
+	//keep comments and the lines still wanted, drop the others
+	const wxString eol = oldContent.Contains( wxT("\r\n") ) ? wxT("\r\n") : wxT("\n");
+	std::vector<wxString> lines;
+	std::vector<int> kinds;
+	std::vector<bool> present( wanted.size(), false );
+	bool changed = false;
+	wxStringTokenizer oldLines( oldContent, wxT("\n"), wxTOKEN_RET_EMPTY_ALL );
+	while ( oldLines.HasMoreTokens() )
+	{
+		wxString line = oldLines.GetNextToken();
+		if ( !oldLines.HasMoreTokens() && line.empty() )
+			break; //the file ended with a newline
+		if ( line.EndsWith( wxT("\r") ) )
+			line.RemoveLast();
+
+		wxString statement = line;
+		const int cmtPos = statement.Find( wxT("//") );
+		if ( cmtPos != -1 )
+			statement.Truncate( cmtPos );
+		const std::vector<wxString> tokens = tokenize_uikeys_line( statement );
+		if ( tokens.empty() )
+		{
+			lines.push_back( line );
+			kinds.push_back( LINE_OTHER );
+			continue;
+		}
+		wxString key;
+		for( size_t t = 0; t < tokens.size(); ++t )
+			key += tokens[t] + wxT(" ");
+		std::map<wxString, size_t>::const_iterator it = wantedIndex.find( key );
+		if ( it == wantedIndex.end() || present[it->second] )
+		{
+			changed = true; //removed, changed or duplicate binding
+			continue;
+		}
+		present[it->second] = true;
+		lines.push_back( line );
+		kinds.push_back( wanted[it->second].first );
+	}
+
+	//add the new lines next to their kind
+	for( size_t i = 0; i < wanted.size(); ++i )
+	{
+		if ( present[i] )
+			continue;
+		changed = true;
+		const size_t pos = insertPosition( kinds, wanted[i].first );
+		lines.insert( lines.begin() + pos, wanted[i].second );
+		kinds.insert( kinds.begin() + pos, wanted[i].first );
+	}
+
+	//nothing changed, leave the file (and its backup) alone
+	if ( !changed )
+		return;
+
+	wxString content;
+	for( size_t i = 0; i < lines.size(); ++i )
+		content += lines[i] + eol;
+
+	//write next to uikeys.txt, so it can be renamed
+	const wxString newTmpFilename = this->m_filename + wxT(".tmp");
+	{
+		wxFFile newFile( newTmpFilename, wxT("wb") );
+		if ( !newFile.IsOpened() || !newFile.Write( content, *conv ) || !newFile.Close() )
+		{
+			throw HotkeyException( _("Error opening file for writing: ") + newTmpFilename );
+		}
+	}
 
 	const wxString prevFilenameBak = this->m_filename + wxT(".bak");
 
@@ -237,6 +340,7 @@ void hotkey_parser::setUiKeys(const wxString& filename )
 	this->m_bindings = SpringDefaultProfile::getBindings();
 
 	//2. now read uikeys.txt and modify the default profile
+	this->m_filename = filename;
 	wxTextFile uiFile( this->m_filename );
 
 	if ( !uiFile.Exists() || !uiFile.Open() ) {
@@ -263,5 +367,4 @@ void hotkey_parser::setUiKeys(const wxString& filename )
 
 		this->processLine( line );
 	}
-	this->m_filename = filename;
 }
@@ -7,6 +7,7 @@
 #include "utils/conversion.h"
 #include "log.h"
 #include "settings.h"
+#include "utils/slconfig.h"
 #include "utils/slpaths.h"
 #include "se_utils.h"
 #include "defines.h"
@@ -105,6 +106,7 @@ int Springsettings::OnExit()
 	}
 
 	sett().SaveSettings(); // to make sure that cache path gets saved before destroying unitsync
+	cfg().FinishSaving();
 
 	SetEvtHandlerEnabled(false);
   LSL::Util::DestroyGlobals();
@@ -0,0 +1,234 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "springconfig.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <locale>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+static std::string Trim( const std::string& s )
+{
+	const size_t begin = s.find_first_not_of( " \t\r" );
+	if ( begin == std::string::npos ) return std::string();
+	const size_t end = s.find_last_not_of( " \t\r" );
+	return s.substr( begin, end - begin + 1 );
+}
+
+SpringConfig::SpringConfig():
+	m_loaded( false ),
+	m_mtime( -1 ),
+	m_size( -1 )
+{
+}
+
+bool SpringConfig::GetFileStamp( long& mtime, long& size ) const
+{
+	struct stat st;
+	if ( stat( m_path.c_str(), &st ) != 0 ) return false;
+	mtime = st.st_mtime;
+	size = st.st_size;
+	return true;
+}
+
+void SpringConfig::Parse( const std::string& text )
+{
+	m_lines.clear();
+	m_values.clear();
+	std::istringstream in( text );
+	std::string line;
+	while ( std::getline( in, line ) ) {
+		Line l;
+		const std::string trimmed = Trim( line );
+		const size_t eq = trimmed.find( '=' );
+		if ( !trimmed.empty() && trimmed[0] != '#' && eq != std::string::npos && eq > 0 ) {
+			l.key = Trim( trimmed.substr( 0, eq ) );
+			// a key that appears twice: the last one wins, the first line is dropped on save
+			if ( m_values.find( l.key ) == m_values.end() ) m_lines.push_back( l );
+			m_values[l.key] = Trim( trimmed.substr( eq + 1 ) );
+		} else {
+			l.text = line;
+			m_lines.push_back( l );
+		}
+	}
+}
+
+bool SpringConfig::Load( const std::string& path )
+{
+	m_path = path;
+	m_edits.clear();
+	m_loaded = false;
+	if ( !GetFileStamp( m_mtime, m_size ) ) {
+		m_mtime = m_size = -1;
+		Parse( std::string() );
+		m_loaded = true;
+		return true;
+	}
+	std::ifstream in( path.c_str(), std::ios::in | std::ios::binary );
+	if ( !in ) return false;
+	std::ostringstream text;
+	text << in.rdbuf();
+	Parse( text.str() );
+	m_loaded = true;
+	return true;
+}
+
+bool SpringConfig::ReloadIfChanged()
+{
+	if ( !m_loaded ) return false;
+	long mtime = -1, size = -1;
+	if ( !GetFileStamp( mtime, size ) ) mtime = size = -1;
+	if ( mtime == m_mtime && size == m_size ) return true;
+	std::map<std::string, std::string> edits;
+	edits.swap( m_edits );
+	const bool res = Load( m_path );
+	m_edits.swap( edits );
+	return res;
+}
+
+std::string SpringConfig::Serialize() const
+{
+	std::string res;
+	std::map<std::string, std::string> added( m_edits );
+	for ( size_t i = 0; i < m_lines.size(); i++ ) {
+		const Line& line = m_lines[i];
+		if ( line.key.empty() ) {
+			res += line.text;
+		} else {
+			res += line.key + " = " + *Find( line.key );
+			added.erase( line.key );
+		}
+		res += '\n';
+	}
+	for ( std::map<std::string, std::string>::const_iterator it = added.begin(); it != added.end(); ++it ) {
+		res += it->first + " = " + it->second + '\n';
+	}
+	return res;
+}
+
+bool SpringConfig::Save()
+{
+	if ( !m_loaded || m_path.empty() ) return false;
+	if ( m_edits.empty() ) return true;
+	// don't overwrite what others wrote in the meantime
+	if ( !ReloadIfChanged() ) return false;
+
+	const std::string tmp = m_path + ".tmp";
+	{
+		std::ofstream out( tmp.c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+		if ( !out ) return false;
+		const std::string text = Serialize();
+		out.write( text.data(), text.size() );
+		out.close();
+		if ( !out ) {
+			remove( tmp.c_str() );
+			return false;
+		}
+	}
+#ifdef _WIN32
+	if ( !MoveFileExA( tmp.c_str(), m_path.c_str(), MOVEFILE_REPLACE_EXISTING ) ) {
+#else
+	if ( rename( tmp.c_str(), m_path.c_str() ) != 0 ) {
+#endif
+		remove( tmp.c_str() );
+		return false;
+	}
+
+	for ( std::map<std::string, std::string>::const_iterator it = m_edits.begin(); it != m_edits.end(); ++it ) {
+		if ( m_values.find( it->first ) == m_values.end() ) {
+			Line line;
+			line.key = it->first;
+			m_lines.push_back( line );
+		}
+		m_values[it->first] = it->second;
+	}
+	m_edits.clear();
+	GetFileStamp( m_mtime, m_size );
+	return true;
+}
+
+const std::string* SpringConfig::Find( const std::string& key ) const
+{
+	std::map<std::string, std::string>::const_iterator it = m_edits.find( key );
+	if ( it != m_edits.end() ) return &it->second;
+	it = m_values.find( key );
+	if ( it != m_values.end() ) return &it->second;
+	return NULL;
+}
+
+bool SpringConfig::Has( const std::string& key ) const
+{
+	return Find( key ) != NULL;
+}
+
+std::string SpringConfig::GetString( const std::string& key, const std::string& def ) const
+{
+	const std::string* value = Find( key );
+	return value ? *value : def;
+}
+
+// numbers are always written with a '.', independent of the locale the ui uses
+template<class T>
+static bool FromString( const std::string& s, T& value )
+{
+	std::istringstream in( s );
+	in.imbue( std::locale::classic() );
+	in >> value;
+	return !in.fail();
+}
+
+template<class T>
+static std::string ToString( T value )
+{
+	std::ostringstream out;
+	out.imbue( std::locale::classic() );
+	out << value;
+	return out.str();
+}
+
+int SpringConfig::GetInt( const std::string& key, int def ) const
+{
+	const std::string* value = Find( key );
+	int res;
+	if ( value && FromString( *value, res ) ) return res;
+	return def;
+}
+
+float SpringConfig::GetFloat( const std::string& key, float def ) const
+{
+	const std::string* value = Find( key );
+	float res;
+	if ( value && FromString( *value, res ) ) return res;
+	return def;
+}
+
+void SpringConfig::SetString( const std::string& key, const std::string& value )
+{
+	std::map<std::string, std::string>::const_iterator it = m_values.find( key );
+	if ( it != m_values.end() && it->second == value ) {
+		m_edits.erase( key );
+		return;
+	}
+	m_edits[key] = value;
+}
+
+void SpringConfig::SetInt( const std::string& key, int value )
+{
+	SetString( key, ToString( value ) );
+}
+
+void SpringConfig::SetFloat( const std::string& key, float value )
+{
+	SetString( key, ToString( value ) );
+}
+
+SpringConfig& springConfig()
+{
+	static SpringConfig config;
+	return config;
+}
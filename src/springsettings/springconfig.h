@@ -0,0 +1,72 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_HEADERGUARD_SPRINGCONFIG_H
+#define SPRINGLOBBY_HEADERGUARD_SPRINGCONFIG_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+/** Reads and writes springsettings.cfg directly.
+ *
+ * The file is parsed once into a key map, values are read from memory.
+ * Changes are kept in memory until Save(), which writes the whole file at once
+ * to a temporary file and renames it over the old one. Comments, unknown lines
+ * and the order of keys are kept.
+ * ReloadIfChanged() picks up changes other programs (spring, unitsync) made to
+ * the file, edits that weren't saved yet are applied on top.
+ */
+class SpringConfig
+{
+public:
+	SpringConfig();
+
+	//! parse @p path, a missing file counts as empty. Drops unsaved edits.
+	bool Load( const std::string& path );
+	//! reparse the file if it was modified since it was read
+	bool ReloadIfChanged();
+	//! write all edits, does nothing if there are none
+	bool Save();
+
+	bool IsLoaded() const { return m_loaded; }
+	bool IsDirty() const { return !m_edits.empty(); }
+	const std::string& GetPath() const { return m_path; }
+
+	bool Has( const std::string& key ) const;
+	std::string GetString( const std::string& key, const std::string& def ) const;
+	int GetInt( const std::string& key, int def ) const;
+	float GetFloat( const std::string& key, float def ) const;
+
+	void SetString( const std::string& key, const std::string& value );
+	void SetInt( const std::string& key, int value );
+	void SetFloat( const std::string& key, float value );
+
+	//! parse a file's content, used by Load()
+	void Parse( const std::string& text );
+	//! the file content with all edits applied
+	std::string Serialize() const;
+
+private:
+	struct Line
+	{
+		std::string text; //! verbatim for lines without a key
+		std::string key;
+	};
+
+	const std::string* Find( const std::string& key ) const;
+	bool GetFileStamp( long& mtime, long& size ) const;
+
+	std::string m_path;
+	bool m_loaded;
+	long m_mtime;
+	long m_size;
+
+	std::vector<Line> m_lines;
+	std::map<std::string, std::string> m_values; //! as read from the file
+	std::map<std::string, std::string> m_edits; //! not saved yet
+};
+
+//! the config of the spring version used by the settings tabs
+SpringConfig& springConfig();
+
+#endif // SPRINGLOBBY_HEADERGUARD_SPRINGCONFIG_H
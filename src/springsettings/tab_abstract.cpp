@@ -13,6 +13,7 @@
 #include <wx/combobox.h>
 #include <wx/textctrl.h>
 #include <wx/display.h>
+#include <stdexcept>
 
 
 #include "gui/spinctl/spinctrl.h"
@@ -25,7 +26,8 @@
 
 #include "log.h"
 
-#include <lslunitsync/unitsync.h>
+#include "springconfig.h"
+#include "utils/slpaths.h"
 
 
 intMap abstract_panel::intSettings;
@@ -107,15 +109,24 @@ bool abstract_panel::loadValuesIntoMap()
 //		const int current_x_res = LSL::susynclib().GetSpringConfigInt(RC_TEXT[0].key,display_rect.width);
 //		const int current_y_res = LSL::susynclib().GetSpringConfigInt(RC_TEXT[1].key,display_rect.height);
 
+		// read the file once instead of asking unitsync for every key
+		SpringConfig& config = springConfig();
+		const std::string path = SlPaths::GetSpringConfigFilePath();
+		if (path.empty())
+			throw std::runtime_error("no spring config file");
+		const bool loaded = (config.IsLoaded() && config.GetPath() == path) ? config.ReloadIfChanged() : config.Load(path);
+		if (!loaded)
+			throw std::runtime_error("could not read " + path);
+
 		for (int i = 0; i< intControls_size;++i)
 		{
       intSettings[intControls[i].key]
-          = LSL::usync().GetSpringConfigInt(STD_STRING(intControls[i].key),fromString(intControls[i].def));
+          = config.GetInt(STD_STRING(intControls[i].key),fromString(intControls[i].def));
 		}
     for (int i = 0; i< floatControls_size;++i)
     {
       floatSettings[floatControls[i].key]
-          = LSL::usync().GetSpringConfigFloat(STD_STRING(floatControls[i].key),fromString(floatControls[i].def));
+          = config.GetFloat(STD_STRING(floatControls[i].key),fromString(floatControls[i].def));
 		}
 	}
 	catch (...)
@@ -580,18 +591,19 @@ void abstract_panel::OnSpinControlChange(wxSpinEvent& event)
 
 //TODO inquire about floatsettings
 bool abstract_panel::saveSettings() {
-	try {
-		for (intMap::const_iterator i = intSettings.begin(); i != intSettings.end();++i) {
-			LSL::usync().SetSpringConfigInt(STD_STRING(i->first),i->second);
-		}
-		for (stringMap::const_iterator s = stringSettings.begin(); s != stringSettings.end();++s) {
-			LSL::usync().SetSpringConfigString(STD_STRING(s->first),STD_STRING(s->second));
-		}
-		for (floatMap::const_iterator f = floatSettings.begin(); f != floatSettings.end();++f) {
-			LSL::usync().SetSpringConfigFloat(STD_STRING(f->first),f->second);
-		}
-	} catch (...) {
-		customMessageBox(SS_MAIN_ICON,_("Could not save, unitsync not properly loaded"), _("SpringSettings Error"), wxOK|wxICON_HAND, 0);
+	// all values are applied in memory and written to the file at once
+	SpringConfig& config = springConfig();
+	for (intMap::const_iterator i = intSettings.begin(); i != intSettings.end();++i) {
+		config.SetInt(STD_STRING(i->first),i->second);
+	}
+	for (stringMap::const_iterator s = stringSettings.begin(); s != stringSettings.end();++s) {
+		config.SetString(STD_STRING(s->first),STD_STRING(s->second));
+	}
+	for (floatMap::const_iterator f = floatSettings.begin(); f != floatSettings.end();++f) {
+		config.SetFloat(STD_STRING(f->first),f->second);
+	}
+	if (!config.Save()) {
+		customMessageBox(SS_MAIN_ICON,_("Could not save the spring settings file"), _("SpringSettings Error"), wxOK|wxICON_HAND, 0);
 		return false;
 	}
 
@@ -15,6 +15,7 @@
 #include "presets.h"
 #include "frame.h"
 #include "settings.h"
+#include "springconfig.h"
 #include <lslunitsync/unitsync.h>
 #include <utils/conversion.h>
 
@@ -47,8 +48,8 @@ void tab_simple::getSetUpResolutionCBX()
 	else
 	{
 		try{
-            x_res = LSL::usync().GetSpringConfigInt(STD_STRING(RC_TEXT[0].key),fromString(RC_TEXT[0].def));
-            y_res = LSL::usync().GetSpringConfigInt(STD_STRING(RC_TEXT[1].key),fromString(RC_TEXT[1].def));
+            x_res = springConfig().GetInt(STD_STRING(RC_TEXT[0].key),fromString(RC_TEXT[0].def));
+            y_res = springConfig().GetInt(STD_STRING(RC_TEXT[1].key),fromString(RC_TEXT[1].def));
 		}
 		catch (...)	{}
 	}
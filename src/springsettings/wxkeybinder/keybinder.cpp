@@ -722,6 +722,16 @@ bool wxCmd::Load(wxConfigBase *p, const wxString &key)
 // wxCmdArray
 // --------------------
 
+void wxCmdArray::AddToIndex(size_t n)
+{
+    // keep the first one if ids or names are not unique
+    const wxCmd *p = Item(n);
+    if (m_ids.find(p->GetId()) == m_ids.end())
+        m_ids[p->GetId()] = n;
+    if (m_names.find(p->GetName()) == m_names.end())
+        m_names[p->GetName()] = n;
+}
+
 void wxCmdArray::Remove(size_t n)
 {
 	if ( n >= GetCount())
@@ -732,15 +742,38 @@ void wxCmdArray::Remove(size_t n)
 
     // then, remove that pointer from the array
     m_arr.RemoveAt(n);
+
+    // the following commands moved, rebuild the index
+    m_ids.clear();
+    m_names.clear();
+    for (size_t i=0; i < GetCount(); i++)
+        AddToIndex(i);
 }
 
 void wxCmdArray::Clear()
 {
-    for (size_t i=GetCount(); i > 0; i--)
-        Remove(0);
+    for (size_t i=0; i < GetCount(); i++)
+        delete Item(i);
 
-    // the array should be already empty
     m_arr.Clear();
+    m_ids.clear();
+    m_names.clear();
+}
+
+int wxCmdArray::FindId(int id) const
+{
+    wxCmdIdIndex::const_iterator it = m_ids.find(id);
+    if (it == m_ids.end())
+        return -1;
+    return it->second;
+}
+
+int wxCmdArray::FindName(const wxString &name) const
+{
+    wxCmdNameIndex::const_iterator it = m_names.find(name);
+    if (it == m_names.end())
+        return -1;
+    return it->second;
 }
 
 
@@ -1515,6 +1548,29 @@ void wxKeyConfigPanel::ImportRawList(const ControlMap& itemMap, const wxString &
 	FillCommandTree();
 }
 
+void wxKeyConfigPanel::ImportRawCommand(const wxString &category, const wxString &cmdName, int id)
+{
+	m_commandMap[category][cmdName] = id;
+
+	if ( !IsUsingTreeCtrl() )
+		return;
+
+	AddRootIfMissing(m_sRootName);
+	const wxTreeItemId rootid = m_pCommandsTree->GetRootItem();
+	wxTreeItemId catId = FindCategoryItem( category );
+	if ( !catId.IsOk() )
+	{
+		catId = m_pCommandsTree->AppendItem( rootid, category );
+		m_pCommandsTree->SortChildren( rootid );
+	}
+
+	if ( IsCommandShown( cmdName ) && !FindTreeItem( catId, cmdName ).IsOk() )
+	{
+		m_pCommandsTree->AppendItem( catId, cmdName, -1, -1, new wxExTreeItemData( id ) );
+		m_pCommandsTree->SortChildren( catId );
+	}
+}
+
 void wxKeyConfigPanel::FillCommandTree()
 {
 	if (!IsUsingTreeCtrl())
@@ -1538,33 +1594,13 @@ void wxKeyConfigPanel::FillCommandTree()
 
 		for( CommandList::const_iterator iiter = iter->second.begin(); iiter != iter->second.end(); ++iiter )
 		{
-			bool add = false;
-			if ( this->m_eFilterState == FS_ALL )
-			{
-				add = true;
-			}
-			else if ( this->m_eFilterState == FS_HIDE_EMPTY )
-			{
-				if ( m_kBinder.ContainsCommand( iiter->first ) )
-					add = true;
-			}
-			else if ( this->m_eFilterState == FS_DIFF_ONLY )
-			{
-				const wxKeyProfile* pDefaultProf = GetProfile(0);
-
-				const wxKeyProfile* pCurProf = this->GetSelProfile();
-
-				if ( (*pCurProf->GetCommandByName( iiter->first )) != (*pDefaultProf->GetCommandByName( iiter->first )) )
-					add = true;
-			}
-
-			if ( !add )
+			if ( !IsCommandShown( iiter->first ) )
 				continue;
 
 			wxExTreeItemData *treedata = new wxExTreeItemData(iiter->second);
 			m_pCommandsTree->AppendItem(newId, iiter->first, -1, -1, treedata );
-			m_pCommandsTree->SortChildren(newId);
 		}
+		m_pCommandsTree->SortChildren(newId);
 	}
 
 	m_pCommandsTree->SortChildren( rootid );
@@ -1576,6 +1612,68 @@ void wxKeyConfigPanel::FillCommandTree()
     m_pCommandsTree->Expand(m_pCommandsTree->GetRootItem());
 }
 
+wxTreeItemId wxKeyConfigPanel::FindCategoryItem(const wxString &category) const
+{
+	const wxTreeItemId rootid = m_pCommandsTree->GetRootItem();
+	wxTreeItemIdValue cookie;
+	wxTreeItemId catId = m_pCommandsTree->GetFirstChild( rootid, cookie );
+	while ( catId.IsOk() && m_pCommandsTree->GetItemText( catId ) != category )
+		catId = m_pCommandsTree->GetNextChild( rootid, cookie );
+	return catId;
+}
+
+bool wxKeyConfigPanel::IsCommandShown(const wxString &cmdName) const
+{
+	if ( this->m_eFilterState == FS_HIDE_EMPTY )
+	{
+		return m_kBinder.ContainsCommand( cmdName );
+	}
+	else if ( this->m_eFilterState == FS_DIFF_ONLY )
+	{
+		const wxKeyProfile* pDefaultProf = GetProfile(0);
+
+		const wxKeyProfile* pCurProf = this->GetSelProfile();
+
+		const wxCmd* pCurCmd = pCurProf->GetCommandByName( cmdName );
+		const wxCmd* pDefaultCmd = pDefaultProf->GetCommandByName( cmdName );
+		if ( !pCurCmd || !pDefaultCmd )
+			return pCurCmd != pDefaultCmd;
+		return (*pCurCmd) != (*pDefaultCmd);
+	}
+	return true;
+}
+
+void wxKeyConfigPanel::UpdateCommandTreeItem(const wxString &cmdName)
+{
+	//without a filter every command is shown anyway
+	if ( !IsUsingTreeCtrl() || this->m_eFilterState == FS_ALL )
+		return;
+
+	for( ControlMap::const_iterator iter = m_commandMap.begin(); iter != m_commandMap.end(); ++iter )
+	{
+		CommandList::const_iterator cmd = iter->second.find( cmdName );
+		if ( cmd == iter->second.end() )
+			continue;
+
+		const wxTreeItemId catId = FindCategoryItem( iter->first );
+		if ( !catId.IsOk() )
+			return;
+
+		const wxTreeItemId item = FindTreeItem( catId, cmdName );
+		const bool shown = IsCommandShown( cmdName );
+		if ( shown && !item.IsOk() )
+		{
+			m_pCommandsTree->AppendItem( catId, cmdName, -1, -1, new wxExTreeItemData( cmd->second ) );
+			m_pCommandsTree->SortChildren( catId );
+		}
+		else if ( !shown && item.IsOk() )
+		{
+			m_pCommandsTree->Delete( item );
+		}
+		return;
+	}
+}
+
 // ----------------------------------------------------------------------------
 // wxKeyConfigPanel - MISCELLANEOUS functions
 // ----------------------------------------------------------------------------
@@ -2340,12 +2438,13 @@ void wxKeyConfigPanel::OnAssignKey(wxCommandEvent &)
 #endif      // to avoid warnings in release mode
 
         m_pCurrCmd->RemoveShortcut(n);
+        UpdateCommandTreeItem(m_pCurrCmd->GetName());
     }
 #endif
 
     // and update the list of the key bindings
     FillInBindings();
-   	FillCommandTree();
+	UpdateCommandTreeItem(sel->GetName());
 
 	//select the new key
 	this->SelectKeyString( m_pKeyField->GetValue() );
@@ -2377,7 +2476,7 @@ void wxKeyConfigPanel::OnRemoveKey(wxCommandEvent &)
     // and update the list of the key bindings
     FillInBindings();
     UpdateButtons();
-	FillCommandTree();
+	UpdateCommandTreeItem(GetSelCmd()->GetName());
 
 #ifdef wxKEYBINDER_AUTO_SAVE
 	ApplyChanges();
@@ -2403,7 +2502,7 @@ void wxKeyConfigPanel::OnRemoveAllKey(wxCommandEvent &)
     // and update the list of the key bindings
     FillInBindings();
     UpdateButtons();
-	FillCommandTree();
+	UpdateCommandTreeItem(GetSelCmd()->GetName());
 
 #ifdef wxKEYBINDER_AUTO_SAVE
 	ApplyChanges();
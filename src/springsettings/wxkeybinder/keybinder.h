@@ -25,6 +25,7 @@
 #include "wx/combobox.h"
 #include "wx/app.h"
 #include "wx/hashset.h"
+#include "wx/hashmap.h"
 #include "wx/checkbox.h"
 
 
@@ -578,13 +579,22 @@ protected:
 
 
 
+WX_DECLARE_HASH_MAP( int, size_t, wxIntegerHash, wxIntegerEqual, wxCmdIdIndex );
+WX_DECLARE_STRING_HASH_MAP( size_t, wxCmdNameIndex );
+
 //! Defines a wxObjArray-like array of wxCmd.
 //! However, we cannot use the WX_DECLARE_OBJARRAY macro
 //! because wxCmd is an abstract class and thus we need
 //! to keep simple pointers stored, not the objects themselves.
+//! Commands are also indexed by ID and name; they must not be renamed
+//! once they are added.
 class wxCmdArray
 {
     wxArrayPtrVoid m_arr;
+    wxCmdIdIndex m_ids;
+    wxCmdNameIndex m_names;
+
+    void AddToIndex(size_t n);
 
 public:
     wxCmdArray() {}
@@ -602,10 +612,14 @@ public:
         return *this;
     }
 
-    void Add(wxCmd *p)          { m_arr.Add(p); }
+    void Add(wxCmd *p)          { m_arr.Add(p); AddToIndex(m_arr.GetCount() - 1); }
     void Remove(size_t n);
     void Clear();
 
+    //! Returns the index of the first command with the given ID or name, -1 if there is none.
+    int FindId(int id) const;
+    int FindName(const wxString &name) const;
+
     size_t GetCount() const        { return m_arr.GetCount(); }
     wxCmd *Item(int n) const    { return (wxCmd *)m_arr.Item(n); }
 };
@@ -739,10 +753,7 @@ protected:
 
     //! Returns the index of the first command with the given ID.
     int FindCmd(int id) const {
-        for (int i=0; i < (int)m_arrCmd.GetCount(); i++)
-            if (id == m_arrCmd.Item(i)->GetId())
-                return i;
-        return -1;
+        return m_arrCmd.FindId(id);
     }
 
     //! Returns the index of the first command that contains the
@@ -1011,10 +1022,9 @@ public:     // miscellaneous
 	}
 
 	const wxCmd* GetCommandByName( const wxString& cmdName ) const {
-		for (int i=0; i < (int)m_arrCmd.GetCount(); i++) {
-			if ( m_arrCmd.Item(i)->GetName() == cmdName )
-				return m_arrCmd.Item(i);
-		}
+		const int i = m_arrCmd.FindName( cmdName );
+		if ( i != -1 )
+			return m_arrCmd.Item(i);
 		return NULL;
 	}
 
@@ -1434,6 +1444,8 @@ public:     // import commands (to call BEFORE ShowModal):
 	WX_DECLARE_STRING_HASH_MAP( CommandList, ControlMap );
 	//! Supports only tree control
 	void ImportRawList(const ControlMap& itemMap, const wxString &rootname);
+	//! Adds a single command to the list imported by ImportRawList
+	void ImportRawCommand(const wxString &category, const wxString &cmdName, int id);
 	//end of vbs
 
 public:     // keyprofile utilities (to call BEFORE ShowModal):
@@ -1559,6 +1571,11 @@ protected:      // utilities
     virtual void UpdateDesc();
     virtual void FillInBindings();
 	virtual void FillCommandTree();
+	//! Shows or hides the tree item of a command whose bindings changed,
+	//! instead of filling the whole tree again.
+	virtual void UpdateCommandTreeItem(const wxString &cmdName);
+	bool IsCommandShown(const wxString &cmdName) const;
+	wxTreeItemId FindCategoryItem(const wxString &category) const;
     virtual void Reset();
     virtual void AddRootIfMissing(const wxString &rootname);
 
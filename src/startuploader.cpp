@@ -0,0 +1,125 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "startuploader.h"
+
+#include <wx/log.h>
+#include <lslunitsync/unitsync.h>
+#include <lslutils/globalsmanager.h>
+#include <lslutils/thread.h>
+
+#include "contentregistry.h"
+#include "utils/conversion.h"
+#include "utils/globalevents.h"
+#include "utils/slpaths.h"
+
+static const wxEventType StartupProbed = wxNewEventType();
+static const wxEventType StartupLoaded = wxNewEventType();
+
+//! validate the spring bundles, this loads every unitsync once
+class ProbeItem : public LSL::WorkItem
+{
+public:
+	void Run()
+	{
+		StartupLoader& loader = startupLoader();
+		StartupLoader::ScopedStage stage( "spring versions" );
+		loader.m_versions = SlPaths::ProbeSpringBundles( loader.m_candidates );
+		wxCommandEvent event( StartupProbed );
+		loader.AddPendingEvent( event );
+	}
+};
+
+//! first unitsync load, scans all archives
+class LoadItem : public LSL::WorkItem
+{
+public:
+	void Run()
+	{
+		{
+			StartupLoader::ScopedStage stage( "unitsync" );
+			contentRegistry().ReloadUnitsync();
+		}
+		wxCommandEvent event( StartupLoaded );
+		startupLoader().AddPendingEvent( event );
+	}
+};
+
+StartupLoader::StartupLoader():
+	m_thread( new LSL::WorkerThread() ),
+	m_finished( false )
+{
+	Connect( StartupProbed, wxCommandEventHandler( StartupLoader::OnProbed ) );
+	Connect( StartupLoaded, wxCommandEventHandler( StartupLoader::OnLoaded ) );
+}
+
+StartupLoader::~StartupLoader()
+{
+	delete m_thread;
+}
+
+void StartupLoader::Start()
+{
+	assert( wxThread::IsMain() );
+	// the config isn't thread-safe, so it's read here and the worker only gets the result
+	m_candidates = SlPaths::GetSpringBundleCandidates();
+	m_thread->DoWork( new ProbeItem() );
+}
+
+void StartupLoader::OnProbed( wxCommandEvent& /*event*/ )
+{
+	SlPaths::SetSpringVersionList( m_versions );
+	m_thread->DoWork( new LoadItem() );
+}
+
+void StartupLoader::OnLoaded( wxCommandEvent& /*event*/ )
+{
+	m_finished = true;
+	LogTimeline();
+	GlobalEvent::Send( GlobalEvent::OnUnitsyncFirstTimeLoad );
+	GlobalEvent::Send( GlobalEvent::OnUnitsyncReloaded );
+}
+
+size_t StartupLoader::BeginStage( const std::string& name )
+{
+	wxMutexLocker lock( m_mutex );
+	Stage stage;
+	stage.name = name;
+	stage.begin = m_clock.Time();
+	stage.end = -1;
+	m_stages.push_back( stage );
+	return m_stages.size() - 1;
+}
+
+void StartupLoader::EndStage( size_t id )
+{
+	wxMutexLocker lock( m_mutex );
+	m_stages[id].end = m_clock.Time();
+}
+
+void StartupLoader::LogTimeline()
+{
+	wxMutexLocker lock( m_mutex );
+	wxLogMessage( _T("startup timeline, ready after %ld ms:"), m_clock.Time() );
+	for ( size_t i = 0; i < m_stages.size(); i++ ) {
+		const Stage& stage = m_stages[i];
+		if ( stage.end < 0 ) continue;
+		wxLogMessage( _T("  %-16s %6ld - %6ld ms (%ld ms)"), TowxString( stage.name ).c_str(), stage.begin, stage.end, stage.end - stage.begin );
+	}
+}
+
+StartupLoader::ScopedStage::ScopedStage( const std::string& name ):
+	m_id( startupLoader().BeginStage( name ) )
+{
+}
+
+StartupLoader::ScopedStage::~ScopedStage()
+{
+	startupLoader().EndStage( m_id );
+}
+
+StartupLoader& startupLoader()
+{
+	static LSL::Util::LineInfo<StartupLoader> m( AT );
+	static LSL::Util::GlobalObjectHolder<StartupLoader, LSL::Util::LineInfo<StartupLoader> > s_loader( m );
+	return s_loader;
+}
@@ -0,0 +1,79 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_HEADERGUARD_STARTUPLOADER_H
+#define SPRINGLOBBY_HEADERGUARD_STARTUPLOADER_H
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+#include <wx/event.h>
+#include <wx/stopwatch.h>
+#include <wx/thread.h>
+#include <lslunitsync/springbundle.h>
+
+namespace LSL {
+class WorkerThread;
+}
+
+/** Loads installed content after the main window is shown.
+ *
+ * Spring versions are probed and unitsync is loaded in a background thread:
+ * probe spring versions -> store them (main thread) -> load unitsync -> OnUnitsyncFirstTimeLoad
+ * and OnUnitsyncReloaded. Until then unitsync reports no content, windows update
+ * themselves when the events arrive.
+ *
+ * Also keeps the startup timeline, which is logged once loading finished.
+ */
+class StartupLoader : public wxEvtHandler
+{
+public:
+	StartupLoader();
+	~StartupLoader();
+
+	//! start loading, main thread only
+	void Start();
+	//! true once unitsync was loaded the first time
+	bool IsFinished() const { return m_finished; }
+
+	//! begin a startup stage, returns its id for EndStage(). Thread-safe.
+	size_t BeginStage( const std::string& name );
+	void EndStage( size_t id );
+
+	//! marks a stage for the lifetime of the object
+	class ScopedStage
+	{
+	public:
+		explicit ScopedStage( const std::string& name );
+		~ScopedStage();
+	private:
+		size_t m_id;
+	};
+
+private:
+	friend class ProbeItem;
+	friend class LoadItem;
+
+	void OnProbed( wxCommandEvent& event );
+	void OnLoaded( wxCommandEvent& event );
+	void LogTimeline();
+
+	struct Stage
+	{
+		std::string name;
+		long begin, end; //! ms since the loader was created, end is -1 while running
+	};
+
+	LSL::WorkerThread* m_thread;
+	std::list<LSL::SpringBundle> m_candidates;
+	std::map<std::string, LSL::SpringBundle> m_versions;
+	bool m_finished;
+
+	wxMutex m_mutex;
+	wxStopWatch m_clock;
+	std::vector<Stage> m_stages;
+};
+
+StartupLoader& startupLoader();
+
+#endif // SPRINGLOBBY_HEADERGUARD_STARTUPLOADER_H
@@ -43,6 +43,7 @@ lsl/networking/tasserver.cpp
 #include "utils/slconfig.h"
 #include "utils/version.h"
 #include "settings.h"
+#include "spring.h"
 
 
 SLCONFIG("/Server/ExitMessage", "Using http://springlobby.info/", "Message which is send when leaving server");
@@ -264,6 +265,7 @@ void TASServer::Disconnect()
 	m_connected = false;
 	SendCmd( _T("EXIT ") + cfg().ReadString(_T("/Server/ExitMessage")) ); // EXIT command for new protocol compatibility
 	m_sock->Disconnect();
+	m_nat.Close();
 }
 
 bool TASServer::IsConnected()
@@ -311,15 +313,6 @@ wxString TASServer::GetPasswordHash( const wxString& pass ) const
 }
 
 
-User& TASServer::GetMe()
-{
-	return GetUser( GetUserName() );
-}
-const User& TASServer::GetMe() const
-{
-	return GetUser( GetUserName() );
-}
-
 void TASServer::Login()
 {
 	slLogDebugFunc("");
@@ -416,14 +409,18 @@ void TASServer::Notify()
 		// Nat travelsal "ping"
 		if ( m_battle_id != -1 ) {
 			IBattle *battle=GetCurrentBattle();
+			// in_game is only set once the server echoes it, the engine may own the port already
 			if ((battle) &&
-				( battle->GetNatType() == NAT_Hole_punching || ( battle->GetNatType() == NAT_Fixed_source_ports ) ) && !battle->GetInGame() ) {
+				( battle->GetNatType() == NAT_Hole_punching || ( battle->GetNatType() == NAT_Fixed_source_ports ) ) && !battle->GetInGame() && !spring().IsRunning() ) {
 				UdpPingTheServer(GetUserName());
 				if ( battle->IsFounderMe() ) {
 					UdpPingAllClients();
 				}
+				return;
 			}
 		}
+		// not in a nat traversal battle (anymore)
+		m_nat.Close();
 	}
 }
 
@@ -878,17 +875,36 @@ void TASServer::RelayCmd(  const wxString& command, const wxString& param )
 }
 
 
+//! pings keep the connection alive and overtake everything, the other classes only separate the send statistics
+static SendQueue::Priority GetSendPriority( const wxString& line )
+{
+	// raw commands come with their parameters
+	const wxString command = line.BeforeFirst( _T(' ') );
+	static const wxChar* control[] = { _T("PING"), NULL };
+	static const wxChar* battle[] = { _T("MYBATTLESTATUS"), _T("MYSTATUS"), _T("OPENBATTLE"), _T("JOINBATTLE"), _T("LEAVEBATTLE"),
+		_T("JOINBATTLEACCEPT"), _T("JOINBATTLEDENY"), _T("UPDATEBATTLEINFO"), _T("FORCETEAMNO"), _T("FORCEALLYNO"),
+		_T("FORCETEAMCOLOR"), _T("FORCESPECTATORMODE"), _T("HANDICAP"), _T("KICKFROMBATTLE"), _T("ADDBOT"), _T("REMOVEBOT"),
+		_T("UPDATEBOT"), _T("ADDSTARTRECT"), _T("REMOVESTARTRECT"), NULL };
+	static const wxChar* bulk[] = { _T("SETSCRIPTTAGS"), _T("REMOVESCRIPTTAGS"), _T("DISABLEUNITS"), _T("ENABLEUNITS"),
+		_T("ENABLEALLUNITS"), _T("CHANNELS"), _T("BANLIST"), _T("MUTELIST"), NULL };
+	for ( size_t i = 0; control[i] != NULL; i++ ) if ( command == control[i] ) return SendQueue::PRIO_CONTROL;
+	for ( size_t i = 0; battle[i] != NULL; i++ ) if ( command == battle[i] ) return SendQueue::PRIO_BATTLE;
+	for ( size_t i = 0; bulk[i] != NULL; i++ ) if ( command == bulk[i] ) return SendQueue::PRIO_BULK;
+	return SendQueue::PRIO_CHAT;
+}
+
 void TASServer::SendCmd( const wxString& command, const wxString& param )
 {
-	wxString cmd, msg;
+	wxString msg;
+	msg.reserve( command.length() + param.length() + 16 );
 	if ( m_id_transmission ) {
 		m_last_id++;
-		msg = msg + _T("#") + TowxString( m_last_id ) + _T(" ");
+		msg << _T("#") << m_last_id << _T(" ");
 	}
-	cmd = command;
-	if ( param.IsEmpty() ) msg = msg + cmd + _T("\n");
-	else msg = msg + cmd + _T(" ") + param + _T("\n");
-	bool send_success = m_sock->Send( msg );
+	msg << command;
+	if ( !param.IsEmpty() ) msg << _T(" ") << param;
+	msg << _T("\n");
+	bool send_success = m_sock->Send( msg, GetSendPriority( command ) );
 	if ((command == _T("LOGIN")) || command == _T("CHANGEPASSWORD")){
 		wxLogMessage( _T("sent: %s ... <password removed>"), command.c_str());
 		return;
@@ -1479,7 +1495,7 @@ void TASServer::StartHostedBattle()
 	if (battle) {
 		if ( ( battle->GetNatType() == NAT_Hole_punching ) || ( battle->GetNatType() == NAT_Fixed_source_ports ) ) {
 			UdpPingTheServer(GetUserName());
-			for (int i=0; i<5; ++i)UdpPingAllClients();
+			for (int i=0; i<5; ++i)UdpPingAllClients( true );
 		}
 	}
 
@@ -1871,47 +1887,26 @@ void TASServer::OnError(const wxString& err)
 }
 
 
-//! @brief Send udp ping.
+//! @brief Send udp ping to the server.
 //! @note used for nat travelsal.
-
-unsigned int TASServer::UdpPing(unsigned int src_port, const wxString &target, unsigned int target_port, const wxString &message)// full parameters version, used to ping all clients when hosting.
+void TASServer::UdpPingTheServer(const wxString &message)
 {
-	int result=0;
-	wxLogMessage(_T("UdpPing src_port=%d , target='%s' , target_port=%d , message='%s'"),src_port,target.c_str(),target_port, message.c_str());
-	wxIPV4address local_addr;
-	local_addr.AnyAddress(); // <--- THATS ESSENTIAL!
-	local_addr.Service(src_port);
-
-	wxDatagramSocket udp_socket(local_addr,/* wxSOCKET_WAITALL*/wxSOCKET_NONE);
-
-	wxIPV4address wxaddr;
-	wxaddr.Hostname(target);
-	wxaddr.Service(target_port);
-
-	if (udp_socket.IsOk()&&!udp_socket.Error()) {
-		std::string m=STD_STRING(message);
-		udp_socket.SendTo( wxaddr, m.c_str(), m.length() );
-		wxIPV4address true_local_addr;
-		if (udp_socket.GetLocal(true_local_addr)) {
-			result=true_local_addr.Service();
-		}
-	} else {
-		wxLogMessage(_T("socket's IsOk() is false, no UDP ping done."));
+	if ( spring().IsRunning() ) return; // the engine uses the port now
+	const unsigned int port = m_nat.Open( m_udp_private_port );
+	if ( port == 0 ) {
+		wxLogWarning(_T("couldn't bind UDP port %lu, no UDP ping done."), m_udp_private_port);
+		return;
 	}
-
-	if (udp_socket.Error()) {
-		wxLogWarning(_T("wxDatagramSocket Error=%d"),udp_socket.LastError());
+	if ( !m_nat.SendTo( STD_STRING(m_addr), m_nat_helper_port, STD_STRING(message) ) ) {
+		wxLogWarning(_T("UDP ping to %s:%lu failed"), m_addr.c_str(), m_nat_helper_port);
 	}
-	return result;
+	m_udp_private_port=port;
+	m_se->OnMyInternalUdpSourcePort( m_udp_private_port );
 }
 
-void TASServer::UdpPingTheServer(const wxString &message)
+void TASServer::CloseUdpSocket()
 {
-	unsigned int port=UdpPing(m_udp_private_port,m_addr,m_nat_helper_port,message);
-	if (port>0) {
-		m_udp_private_port=port;
-		m_se->OnMyInternalUdpSourcePort( m_udp_private_port );
-	}
+	m_nat.Close();
 }
 
 
@@ -1925,13 +1920,12 @@ struct UserOrder {
 };
 
 
-void TASServer::UdpPingAllClients()// used when hosting with nat holepunching. has some rudimentary support for fixed source ports.
+void TASServer::UdpPingAllClients( bool all )// used when hosting with nat holepunching. has some rudimentary support for fixed source ports.
 {
 	IBattle *battle=GetCurrentBattle();
 	if (!battle)return;
 	if (!battle->IsFounderMe())return;
-	wxLogMessage(_T("UdpPingAllClients()"));
-
+	if ( spring().IsRunning() ) return; // the engine uses the port now
 	// I'm gonna mimic tasclient's behavior.
 	// It of course doesnt matter in which order pings are sent,
 	// but when doing "fixed source ports", the port must be
@@ -1955,23 +1949,29 @@ void TASServer::UdpPingAllClients()// used when hosting with nat holepunching. h
 	std::sort(ordered_users.begin(),ordered_users.end());
 
 
+	std::map<std::string, NatPinger::Address> peers;
 	for (int i=0; i<int(ordered_users.size()); ++i) {
 		User &user=battle->GetUser(ordered_users[i].index);
 
-		wxString ip=TowxString(user.BattleStatus().ip);
+		const std::string& ip=user.BattleStatus().ip;
 		unsigned int port=user.BattleStatus().udpport;
-
-		unsigned int src_port=m_udp_private_port;
 		if ( battle->GetNatType() == NAT_Fixed_source_ports ) {
 			port = FIRST_UDP_SOURCEPORT + i;
 		}
-
-		wxLogMessage(_T(" pinging nick=%s , ip=%s , port=%u"),user.GetNick().c_str(),ip.c_str(),port);
-
 		if (port!=0 && !ip.empty()) {
-			UdpPing(src_port,ip,port,_T("hai!"));
+			peers[user.GetNick()] = NatPinger::Address( ip, port );
 		}
 	}
+
+	if ( m_nat.Open( m_udp_private_port ) == 0 ) {
+		wxLogWarning(_T("couldn't bind UDP port %lu, no UDP ping done."), m_udp_private_port);
+		return;
+	}
+	const long long now = wxGetLocalTimeMillis().GetValue();
+	m_nat.Receive( now );
+	m_nat.SetPeers( peers );
+	const size_t pinged = m_nat.PingPeers( "hai!", now, all );
+	wxLogMessage(_T("UdpPingAllClients() pinged %u of %u clients from port %u"), (unsigned int)pinged, (unsigned int)peers.size(), m_nat.GetPort());
 }
 
 
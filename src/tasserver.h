@@ -23,6 +23,7 @@ lsl/networking/tasserver.h
 
 #include "iserver.h"
 #include "utils/crc.h"
+#include "utils/natpinger.h"
 
 const unsigned int FIRST_UDP_SOURCEPORT = 8300;
 
@@ -58,16 +59,10 @@ public:
 	void Ping();
 
 	void UDPPing();/// used for nat travelsal
-	/// generic udp "ping" function
-	/// return value: actual source port which was used. May differ from src_port
-	/// 0 if udp ping failed
-	unsigned int UdpPing(unsigned int src_port, const wxString &target, unsigned int target_port, const wxString &message);
 	/// specialized udp ping functions
 	void UdpPingTheServer( const wxString &message );/// used for nat travelsal. pings the server.
-	void UdpPingAllClients();/// used when hosting with nat holepunching
-
-	const User& GetMe() const;
-	User& GetMe();
+	void UdpPingAllClients( bool all = false );/// used when hosting with nat holepunching, all: ignore the back-off of connected clients
+	void CloseUdpSocket();
 
 	void JoinChannel( const wxString& channel, const wxString& key );
 	void PartChannel( const wxString& channel );
@@ -191,6 +186,7 @@ private:
 
 	unsigned long m_udp_private_port;
 	unsigned long m_nat_helper_port;
+	NatPinger m_nat; /// keeps m_udp_private_port bound between pings
 
 	int m_battle_id;
 
@@ -0,0 +1,75 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE colourallocator
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <vector>
+#include "utils/colourallocator.h"
+
+typedef ColourAllocator::RGB RGB;
+
+static double MinDistance( const std::vector<RGB>& colours )
+{
+	double res = 1e9;
+	for ( size_t i = 0; i < colours.size(); i++ ) {
+		for ( size_t j = i + 1; j < colours.size(); j++ ) {
+			res = std::min( res, ColourAllocator::Distance( colours[i], colours[j] ) );
+		}
+	}
+	return res;
+}
+
+BOOST_AUTO_TEST_CASE( distinct )
+{
+	ColourAllocator alloc;
+	std::vector<RGB> used;
+	for ( int i = 0; i < 8; i++ ) {
+		used.push_back( alloc.GetFree( used ) );
+	}
+	BOOST_CHECK( MinDistance( used ) >= ColourAllocator::DefaultMinDistance );
+
+	// players that all want the same colour get distinct ones, the first keeps it
+	const std::vector<RGB> wanted( 6, RGB( 255, 0, 0 ) );
+	const std::vector<RGB> res = alloc.Assign( std::vector<RGB>(), wanted );
+	BOOST_CHECK( res[0] == RGB( 255, 0, 0 ) );
+	BOOST_CHECK( MinDistance( res ) >= ColourAllocator::DefaultMinDistance );
+}
+
+BOOST_AUTO_TEST_CASE( reuse )
+{
+	ColourAllocator alloc;
+	std::vector<RGB> used;
+	for ( int i = 0; i < 4; i++ ) {
+		used.push_back( alloc.GetFree( used ) );
+	}
+	// the colour of a player that left is handed out again
+	const RGB released = used.back();
+	used.pop_back();
+	BOOST_CHECK( alloc.GetFree( used ) == released );
+
+	// fixed colours are kept, a released one is free for the others
+	std::vector<RGB> fixed( 1, RGB( 0, 0, 255 ) );
+	std::vector<RGB> wanted( 1, RGB( 0, 0, 255 ) );
+	BOOST_CHECK( alloc.Assign( fixed, wanted )[0] != RGB( 0, 0, 255 ) );
+	fixed.clear();
+	BOOST_CHECK( alloc.Assign( fixed, wanted )[0] == RGB( 0, 0, 255 ) );
+}
+
+BOOST_AUTO_TEST_CASE( exhaustion )
+{
+	ColourAllocator alloc;
+	// more players than the palette has well separated colours
+	std::vector<RGB> used;
+	for ( int i = 0; i < 300; i++ ) {
+		used.push_back( alloc.GetFree( used ) );
+	}
+	BOOST_CHECK_EQUAL( used.size(), 300u );
+	BOOST_CHECK( MinDistance( used ) < ColourAllocator::DefaultMinDistance );
+
+	// when nothing is far enough away every entry still gets a colour
+	const std::vector<RGB> wanted( 64, RGB( 255, 255, 0 ) );
+	const std::vector<RGB> res = alloc.Assign( std::vector<RGB>(), wanted );
+	BOOST_CHECK_EQUAL( res.size(), wanted.size() );
+	BOOST_CHECK( res[0] == RGB( 255, 255, 0 ) );
+}
@@ -8,6 +8,7 @@
 
 #include <wx/string.h>
 #include <wx/filename.h>
+#include <wx/wfstream.h>
 
 SLCONFIG("/test/string", "hello world!", "test string");
 SLCONFIG("/test/long", -12345l, "test long");
@@ -54,3 +55,27 @@ BOOST_AUTO_TEST_CASE( slconfig )
 
 //	cfg().SaveFile();
 }
+
+BOOST_AUTO_TEST_CASE( slconfig_save )
+{
+	const wxString path = TowxString(SlPaths::GetConfigPath());
+	BOOST_CHECK(cfg().Write(_T("/test/saved"), (const wxString&)_T("first")));
+	cfg().SaveFile();
+	BOOST_CHECK(cfg().Write(_T("/test/saved"), (const wxString&)_T("second")));
+	cfg().SaveFile();
+	// both saves are coalesced and written here
+	cfg().FinishSaving();
+
+	wxFileInputStream instream(path);
+	BOOST_REQUIRE(instream.IsOk());
+	slConfig saved(instream, wxConvUTF8);
+	BOOST_CHECK(saved.Read(_T("/test/saved")) == _T("second"));
+
+	// saves after FinishSaving() are written directly
+	BOOST_CHECK(cfg().Write(_T("/test/saved"), (const wxString&)_T("third")));
+	cfg().SaveFile();
+	wxFileInputStream instream2(path);
+	BOOST_REQUIRE(instream2.IsOk());
+	slConfig saved2(instream2, wxConvUTF8);
+	BOOST_CHECK(saved2.Read(_T("/test/saved")) == _T("third"));
+}
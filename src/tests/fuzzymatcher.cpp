@@ -0,0 +1,109 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE fuzzymatcher
+#include <boost/test/unit_test.hpp>
+
+#include <stdlib.h>
+#include <clocale>
+#include <algorithm>
+#include "utils/fuzzymatcher.h"
+
+// reference implementation, full matrix
+static unsigned int Levenshtein( const std::string& a, const std::string& b, bool search = false )
+{
+	const size_t m = a.size(), n = b.size();
+	std::vector< std::vector<unsigned int> > d( m + 1, std::vector<unsigned int>( n + 1 ) );
+	for ( size_t i = 0; i <= m; i++ ) d[i][0] = i;
+	for ( size_t j = 0; j <= n; j++ ) d[0][j] = search ? 0 : j;
+	unsigned int best = m;
+	for ( size_t j = 1; j <= n; j++ ) {
+		for ( size_t i = 1; i <= m; i++ ) {
+			d[i][j] = std::min( std::min( d[i-1][j] + 1, d[i][j-1] + 1 ), d[i-1][j-1] + ( a[i-1] != b[j-1] ) );
+		}
+		best = std::min( best, d[m][j] );
+	}
+	return search ? best : d[m][n];
+}
+
+static std::string Random( size_t maxlen )
+{
+	std::string s( rand() % maxlen, ' ' );
+	for ( size_t i = 0; i < s.length(); i++ ) s[i] = "abcdAB_"[rand() % 7];
+	return s;
+}
+
+BOOST_AUTO_TEST_CASE( distance )
+{
+	BOOST_CHECK_EQUAL( FuzzyMatcher::Distance( "kitten", "sitting" ), 3u );
+	BOOST_CHECK_EQUAL( FuzzyMatcher::Distance( "", "abc" ), 3u );
+	// longer than 255, the old matrix used unsigned char
+	BOOST_CHECK_EQUAL( FuzzyMatcher::Distance( std::string( 300, 'a' ), "" ), 300u );
+	srand( 1 );
+	for ( int i = 0; i < 5000; i++ ) {
+		// long strings exercise the fallback for patterns longer than 64
+		const size_t maxlen = ( i % 4 == 0 ) ? 150 : 20;
+		const std::string a = FuzzyMatcher::Normalize( Random( maxlen ) );
+		const std::string b = FuzzyMatcher::Normalize( Random( maxlen ) );
+		const unsigned int d = Levenshtein( a, b );
+		BOOST_CHECK_EQUAL( FuzzyMatcher::Distance( a, b ), d );
+		const unsigned int max = rand() % 10;
+		const unsigned int cut = FuzzyMatcher::Distance( a, b, max );
+		BOOST_CHECK( d <= max ? cut == d : cut > max );
+		const unsigned int errors = rand() % 4;
+		BOOST_CHECK_EQUAL( FuzzyMatcher::Contains( b, a, errors ), Levenshtein( a, b, true ) <= errors );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( best )
+{
+	std::vector<std::string> maps;
+	maps.push_back( "Comet Catcher Redux" );
+	maps.push_back( "DeltaSiegeDry" );
+	maps.push_back( "Delta Siege Dry" );
+	FuzzyMatcher matcher( maps );
+	double d;
+	BOOST_CHECK_EQUAL( matcher.GetBest( "deltasiegedry", &d ), "DeltaSiegeDry" );
+	BOOST_CHECK_EQUAL( d, 0.0 );
+	BOOST_CHECK_EQUAL( matcher.GetBest( "comet", &d ), "Comet Catcher Redux" );
+	BOOST_CHECK_CLOSE( d, 14.0 / 19.0, 1e-9 );
+	BOOST_CHECK_EQUAL( matcher.FindBest( "" ), -1 );
+}
+
+BOOST_AUTO_TEST_CASE( normalize )
+{
+	BOOST_CHECK_EQUAL( FuzzyMatcher::Normalize( "DeltaSiege_Dry" ), "deltasiege_dry" );
+	// invalid utf-8 is kept as it is
+	BOOST_CHECK_EQUAL( FuzzyMatcher::Normalize( "A\xC3" ), "a\xC3" );
+	BOOST_CHECK_EQUAL( FuzzyMatcher::Normalize( "\xFF\x80Z" ), "\xFF\x80z" );
+	if ( setlocale( LC_CTYPE, "C.UTF-8" ) != NULL ) {
+		// ÄÖÜ and cyrillic ПРИВЕТ
+		BOOST_CHECK_EQUAL( FuzzyMatcher::Normalize( "\xC3\x84\xC3\x96\xC3\x9C" ), "\xC3\xA4\xC3\xB6\xC3\xBC" );
+		BOOST_CHECK_EQUAL( FuzzyMatcher::Normalize( "\xD0\x9F\xD0\xA0\xD0\x98" ), "\xD0\xBF\xD1\x80\xD0\xB8" );
+		setlocale( LC_CTYPE, "C" );
+	}
+}
+
+// the prefilter must not change the result of a plain scan
+BOOST_AUTO_TEST_CASE( prefilter )
+{
+	srand( 2 );
+	for ( int i = 0; i < 1000; i++ ) {
+		std::vector<std::string> candidates;
+		const int n = rand() % 30;
+		for ( int j = 0; j < n; j++ ) candidates.push_back( Random( 12 ) );
+		const std::string query = Random( 12 );
+		double best = 1.0;
+		int best_idx = -1;
+		for ( int j = 0; j < n; j++ ) {
+			const std::string a = FuzzyMatcher::Normalize( candidates[j] ), b = FuzzyMatcher::Normalize( query );
+			const double d = double( Levenshtein( a, b ) ) / std::max( a.length(), b.length() );
+			if ( d < best ) {
+				best = d;
+				best_idx = j;
+			}
+		}
+		double d;
+		BOOST_CHECK_EQUAL( FuzzyMatcher( candidates ).FindBest( query, &d ), best_idx );
+		BOOST_CHECK_CLOSE( d, best, 1e-9 );
+	}
+}
@@ -0,0 +1,91 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE iconcache
+#include <boost/test/unit_test.hpp>
+
+#include "utils/iconcache.h"
+
+// what IconImageList does: reuse the evicted slot or allocate a new one
+static int Get( IconCache& cache, uint64_t key, int& slots, bool owned = true )
+{
+	int slot = cache.Find( key );
+	if ( slot >= 0 ) return slot;
+	cache.Evict();
+	if ( !owned ) slot = 1000;
+	else {
+		slot = cache.TakeFreeSlot();
+		if ( slot < 0 ) slot = slots++;
+	}
+	cache.Insert( key, slot, owned );
+	return slot;
+}
+
+BOOST_AUTO_TEST_CASE( lru )
+{
+	IconCache cache( 3 );
+	int slots = 0;
+	BOOST_CHECK_EQUAL( Get( cache, 1, slots ), 0 );
+	BOOST_CHECK_EQUAL( Get( cache, 2, slots ), 1 );
+	BOOST_CHECK_EQUAL( Get( cache, 3, slots ), 2 );
+	BOOST_CHECK_EQUAL( Get( cache, 1, slots ), 0 );
+	// 2 is least recently used, its slot is reused
+	BOOST_CHECK_EQUAL( Get( cache, 4, slots ), 1 );
+	BOOST_CHECK_EQUAL( cache.Find( 2 ), -1 );
+	BOOST_CHECK_EQUAL( Get( cache, 3, slots ), 2 );
+	BOOST_CHECK_EQUAL( Get( cache, 5, slots ), 0 );
+	BOOST_CHECK_EQUAL( slots, 3 );
+	BOOST_CHECK_EQUAL( cache.Size(), 3u );
+
+	const IconCache::Stats& stats = cache.GetStats();
+	BOOST_CHECK_EQUAL( stats.hits, 2u );
+	BOOST_CHECK_EQUAL( stats.misses, 6u );
+	BOOST_CHECK_EQUAL( stats.evictions, 2u );
+}
+
+BOOST_AUTO_TEST_CASE( shared_slots )
+{
+	IconCache cache( 2 );
+	int slots = 0;
+	BOOST_CHECK_EQUAL( Get( cache, 1, slots, false ), 1000 );
+	BOOST_CHECK_EQUAL( Get( cache, 2, slots ), 0 );
+	// evicting a shared slot doesn't hand it out
+	BOOST_CHECK_EQUAL( Get( cache, 3, slots ), 1 );
+	BOOST_CHECK_EQUAL( Get( cache, 4, slots ), 0 );
+	BOOST_CHECK_EQUAL( slots, 2 );
+	// a freed slot waits for the next owned entry
+	BOOST_CHECK_EQUAL( Get( cache, 5, slots, false ), 1000 );
+	BOOST_CHECK( Get( cache, 6, slots ) < 2 );
+	BOOST_CHECK( Get( cache, 7, slots ) < 2 );
+	BOOST_CHECK_EQUAL( slots, 2 );
+}
+
+BOOST_AUTO_TEST_CASE( bounded )
+{
+	IconCache cache( 16 );
+	int slots = 0;
+	for ( int i = 0; i < 10000; i++ ) Get( cache, ( i * 7919 ) % 100, slots );
+	BOOST_CHECK_EQUAL( slots, 16 );
+	BOOST_CHECK_EQUAL( cache.Size(), 16u );
+}
+
+BOOST_AUTO_TEST_CASE( erase )
+{
+	IconCache cache( 4 );
+	int slots = 0;
+	BOOST_CHECK_EQUAL( Get( cache, 10, slots ), 0 );
+	BOOST_CHECK_EQUAL( Get( cache, 11, slots, false ), 1000 );
+	BOOST_CHECK_EQUAL( Get( cache, 12, slots ), 1 );
+	BOOST_CHECK_EQUAL( Get( cache, 20, slots ), 2 );
+	cache.Erase( 10, 19 );
+	BOOST_CHECK_EQUAL( cache.Size(), 1u );
+	BOOST_CHECK_EQUAL( cache.Find( 10 ), -1 );
+	BOOST_CHECK_EQUAL( cache.Find( 11 ), -1 );
+	BOOST_CHECK_EQUAL( cache.Find( 20 ), 2 );
+	// the owned slots are reused, the lru list is still intact
+	BOOST_CHECK( Get( cache, 10, slots ) < 2 );
+	BOOST_CHECK( Get( cache, 11, slots ) < 2 );
+	BOOST_CHECK_EQUAL( Get( cache, 30, slots ), 3 );
+	BOOST_CHECK_EQUAL( Get( cache, 31, slots ), 2 );
+	BOOST_CHECK_EQUAL( cache.Find( 20 ), -1 );
+	BOOST_CHECK_EQUAL( slots, 4 );
+}
@@ -0,0 +1,228 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE jsonreader
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <wx/stopwatch.h>
+#include "json/wx/jsonreader.h"
+#include "json/wx/jsondocument.h"
+
+//! writes all events in a compact form
+class Recorder : public wxJSONSaxHandler
+{
+public:
+	std::string out;
+	void StartObject() { out += "{"; }
+	void EndObject() { out += "}"; }
+	void StartArray() { out += "["; }
+	void EndArray() { out += "]"; }
+	bool Key( const char* key, size_t len ) { out += std::string( key, len ) + ":"; return std::string( key, len ) != "skip"; }
+	void String( const char* str, size_t len ) { out += "s" + std::string( str, len ) + ","; }
+	void Int( wxInt64 i ) { char buf[32]; sprintf( buf, "i%lld,", (long long)i ); out += buf; }
+	void Double( double d ) { char buf[32]; sprintf( buf, "d%g,", d ); out += buf; }
+	void Bool( bool b ) { out += b ? "t," : "f,"; }
+	void Null() { out += "n,"; }
+};
+
+static std::string Sax( const std::string& json, int* errors = NULL )
+{
+	wxJSONReader reader;
+	Recorder rec;
+	const int res = reader.Parse( json.data(), json.size(), rec );
+	if ( errors != NULL ) *errors = res;
+	return rec.out;
+}
+
+BOOST_AUTO_TEST_CASE( values )
+{
+	BOOST_CHECK_EQUAL( Sax( "[]" ), "[]" );
+	BOOST_CHECK_EQUAL( Sax( " { } " ), "{}" );
+	BOOST_CHECK_EQUAL( Sax( "[1,-2,0.5,1e3,true,false,null]" ), "[i1,i-2,d0.5,d1000,t,f,n,]" );
+	BOOST_CHECK_EQUAL( Sax( "{\"a\":{\"b\":[\"c\"]}}" ), "{a:{b:[sc,]}}" );
+	// too large for 64 bits
+	BOOST_CHECK_EQUAL( Sax( "[99999999999999999999]" ), "[d1e+20,]" );
+}
+
+BOOST_AUTO_TEST_CASE( strings )
+{
+	BOOST_CHECK_EQUAL( Sax( "[\"a\\\"b\\\\c\\/d\\n\"]" ), "[sa\"b\\c/d\n,]" );
+	BOOST_CHECK_EQUAL( Sax( "[\"\\u0041\\u00e9\\u20ac\"]" ), "[sA\xc3\xa9\xe2\x82\xac,]" );
+	BOOST_CHECK_EQUAL( Sax( "[\"\\ud83d\\ude00\"]" ), "[s\xf0\x9f\x98\x80,]" );
+	BOOST_CHECK_EQUAL( Sax( "[\"\xc3\xa9\"]" ), "[s\xc3\xa9,]" );
+}
+
+BOOST_AUTO_TEST_CASE( skip )
+{
+	BOOST_CHECK_EQUAL( Sax( "{\"skip\":{\"a\":[1,\"\\u0041\"]},\"b\":2}" ), "{skip:b:i2,}" );
+}
+
+BOOST_AUTO_TEST_CASE( errors )
+{
+	const char* invalid[] = { "", "1", "[1,]", "[01]", "[1.]", "{\"a\" 1}", "{\"a\":1,}", "[\"\\x\"]",
+		"[\"\\ud800\"]", "[\"a", "[tru]", "[1] x", "[\"\x01\"]", "{\"a\":[}" };
+	for ( size_t i = 0; i < sizeof( invalid ) / sizeof( invalid[0] ); i++ ) {
+		int errors = 0;
+		Sax( invalid[i], &errors );
+		BOOST_CHECK_MESSAGE( errors == 1, invalid[i] );
+	}
+
+	std::string deep( 1000, '[' );
+	deep += std::string( 1000, ']' );
+	int errors = 0;
+	Sax( deep, &errors );
+	BOOST_CHECK_EQUAL( errors, 1 );
+
+	wxJSONReader reader;
+	Recorder rec;
+	const std::string json = "[\n  1,\n  x]";
+	BOOST_CHECK_EQUAL( reader.Parse( json.data(), json.size(), rec ), 1 );
+	BOOST_CHECK( reader.GetErrors()[0].StartsWith( _T("Error: line 3, col 3") ) );
+}
+
+//! the fields used by the content download dialog
+struct Result
+{
+	Result(): size( 0 ) {}
+	std::string category, name;
+	long size;
+	bool operator==( const Result& o ) const { return category == o.category && name == o.name && size == o.size; }
+};
+
+class ResultSelector : public wxJSONSaxHandler
+{
+public:
+	ResultSelector(): m_level( 0 ), m_field( NULL ), m_size( false ) {}
+	std::vector<Result> results;
+
+	void StartObject() { if ( ++m_level == 2 ) m_current = Result(); }
+	void EndObject() { if ( m_level-- == 2 ) results.push_back( m_current ); }
+	void StartArray() { m_level++; }
+	void EndArray() { m_level--; }
+	bool Key( const char* key, size_t len )
+	{
+		const std::string name( key, len );
+		m_field = NULL;
+		m_size = ( name == "size" );
+		if ( name == "category" ) m_field = &m_current.category;
+		else if ( name == "springname" ) m_field = &m_current.name;
+		return m_field != NULL || m_size;
+	}
+	void String( const char* str, size_t len ) { if ( m_field != NULL ) m_field->assign( str, len ); }
+	void Int( wxInt64 i ) { if ( m_size ) m_current.size = i; }
+
+private:
+	int m_level;
+	std::string* m_field;
+	bool m_size;
+	Result m_current;
+};
+
+//! a springfiles search response of roughly the given size
+static std::string SearchResponse( size_t bytes )
+{
+	std::string json = "[";
+	char buf[1024];
+	for ( int i = 0; json.size() < bytes; i++ ) {
+		sprintf( buf, "%s{\"category\":\"%s\",\"springname\":\"Content %d v%d\",\"name\":\"content_%d.sd7\","
+			"\"size\":%d,\"md5\":\"%032x\",\"timestamp\":\"2014-01-01 00:00:00\","
+			"\"mirrors\":[\"http://mirror1/files/content_%d.sd7\",\"http://mirror2/files/content_%d.sd7\"],"
+			"\"tags\":[\"tag%d\"],\"description\":\"The \\\"best\\\" content, caf\\u00e9 edition\",\"version\":%d.5}",
+			i == 0 ? "" : ",", ( i % 2 ) ? "map" : "game", i, i % 7, i, 1000 + i * 37, i, i, i, i % 13, i );
+		json += buf;
+	}
+	json += "]";
+	return json;
+}
+
+BOOST_AUTO_TEST_CASE( search_results )
+{
+	const std::string json = SearchResponse( 10 * 1024 * 1024 );
+
+	// the old way: convert to wxString, build the tree, read the fields
+	wxStopWatch dom_watch;
+	wxJSONReader dom_reader;
+	wxJSONValue root;
+	BOOST_CHECK_EQUAL( dom_reader.Parse( wxString::FromUTF8( json.data(), json.size() ), &root ), 0 );
+	std::vector<Result> expected;
+	const wxJSONInternalArray* a = root.AsArray();
+	for ( unsigned i = 0; i < a->GetCount(); i++ ) {
+		wxJSONValue val = a->Item( i );
+		Result res;
+		res.category = std::string( val[_T("category")].AsString().mb_str( wxConvUTF8 ) );
+		res.name = std::string( val[_T("springname")].AsString().mb_str( wxConvUTF8 ) );
+		res.size = val[_T("size")].AsInt();
+		expected.push_back( res );
+	}
+	const long dom_ms = dom_watch.Time();
+
+	wxStopWatch sax_watch;
+	wxJSONReader sax_reader;
+	ResultSelector selector;
+	BOOST_CHECK_EQUAL( sax_reader.Parse( json.data(), json.size(), selector ), 0 );
+	const long sax_ms = sax_watch.Time();
+
+	BOOST_CHECK_EQUAL( selector.results.size(), expected.size() );
+	BOOST_CHECK( selector.results == expected );
+	BOOST_TEST_MESSAGE( "parsed " << json.size() << " bytes, " << expected.size() << " results: tree "
+		<< dom_ms << " ms, sax " << sax_ms << " ms" );
+}
+
+BOOST_AUTO_TEST_CASE( document )
+{
+	const std::string json = "[{\"b\":1,\"a\":\"x\",\"c\":[1,2.5,true,null],\"a\":\"caf\\u00e9\"},{\"size\":-5},[]]";
+	wxJSONDocument doc;
+	BOOST_CHECK_EQUAL( doc.Parse( json.data(), json.size() ), 0 );
+	const wxJSONNode root = doc.GetRoot();
+	BOOST_CHECK( root.IsArray() );
+	BOOST_CHECK_EQUAL( root.Size(), 3 );
+	// a member that appears twice keeps the last value
+	BOOST_CHECK_EQUAL( root[0].Size(), 3 );
+	BOOST_CHECK( root[0]["a"].AsString() == wxString::FromUTF8( "caf\xc3\xa9" ) );
+	BOOST_CHECK_EQUAL( root[0]["b"].AsInt(), 1 );
+	BOOST_CHECK_EQUAL( root[0]["c"][1].AsDouble(), 2.5 );
+	BOOST_CHECK( root[0]["c"][2].AsBool() );
+	BOOST_CHECK( root[0]["c"][3].IsNull() );
+	BOOST_CHECK_EQUAL( root[1][_T("size")].AsLong(), -5 );
+	BOOST_CHECK( root[1][_T("size")].AsString() == _T("-5") );
+	BOOST_CHECK( root[2].IsArray() && root[2].Size() == 0 );
+	// missing values are invalid, not errors
+	BOOST_CHECK( !root[0]["missing"].IsValid() );
+	BOOST_CHECK( !root[1]["a"].IsValid() );
+	BOOST_CHECK( !root[3].IsValid() );
+	BOOST_CHECK( !root[0]["b"]["c"].IsValid() );
+
+	BOOST_CHECK_EQUAL( doc.Parse( "[1,", 3 ), 1 );
+	BOOST_CHECK_EQUAL( doc.GetErrors().GetCount(), 1u );
+	BOOST_CHECK( !doc.GetRoot().IsValid() );
+}
+
+static size_t CountValues( const wxJSONNode& node )
+{
+	size_t res = 1;
+	for ( int i = 0; i < node.Size(); i++ ) res += CountValues( node[i] );
+	return res;
+}
+
+BOOST_AUTO_TEST_CASE( document_memory )
+{
+	const std::string json = SearchResponse( 10 * 1024 * 1024 );
+
+	wxStopWatch watch;
+	wxJSONDocument doc;
+	BOOST_CHECK_EQUAL( doc.Parse( json.data(), json.size() ), 0 );
+	const long ms = watch.Time();
+
+	const wxJSONNode root = doc.GetRoot();
+	BOOST_CHECK( root[root.Size() - 1]["springname"].AsString().StartsWith( _T("Content ") ) );
+
+	// a wxJSONValue tree allocates at least one wxJSONRefData for each value,
+	// not counting strings, hash maps and arrays
+	const size_t values = CountValues( root );
+	const size_t tree_bytes = values * sizeof( wxJSONRefData );
+	BOOST_CHECK_LE( doc.GetMemoryUsage() * 3, tree_bytes );
+	BOOST_TEST_MESSAGE( "document of " << json.size() << " bytes, " << values << " values: " << ms << " ms, "
+		<< doc.GetMemoryUsage() << " bytes, tree at least " << tree_bytes << " bytes" );
+}
@@ -0,0 +1,152 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE natpinger
+#include <boost/test/unit_test.hpp>
+
+#include <cstring>
+#include <string>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "utils/natpinger.h"
+
+//! a udp socket on the loopback interface, stands in for the server and the players
+class Endpoint
+{
+public:
+	Endpoint()
+	{
+		m_fd = socket( AF_INET, SOCK_DGRAM, 0 );
+		sockaddr_in addr;
+		memset( &addr, 0, sizeof( addr ) );
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+		bind( m_fd, reinterpret_cast<sockaddr*>( &addr ), sizeof( addr ) );
+		socklen_t len = sizeof( addr );
+		getsockname( m_fd, reinterpret_cast<sockaddr*>( &addr ), &len );
+		m_port = ntohs( addr.sin_port );
+	}
+	~Endpoint() { close( m_fd ); }
+
+	unsigned int Port() const { return m_port; }
+
+	//! next datagram, empty if none arrives within @p timeout_ms; @p from_port is set to its source port
+	std::string Receive( unsigned int* from_port = NULL, int timeout_ms = 200 )
+	{
+		pollfd pfd = { m_fd, POLLIN, 0 };
+		if ( poll( &pfd, 1, timeout_ms ) <= 0 ) return std::string();
+		char buf[512];
+		sockaddr_in from;
+		socklen_t len = sizeof( from );
+		const ssize_t got = recvfrom( m_fd, buf, sizeof( buf ), 0, reinterpret_cast<sockaddr*>( &from ), &len );
+		if ( got < 0 ) return std::string();
+		if ( from_port != NULL ) *from_port = ntohs( from.sin_port );
+		return std::string( buf, got );
+	}
+
+	void SendTo( unsigned int port, const std::string& msg )
+	{
+		sockaddr_in addr;
+		memset( &addr, 0, sizeof( addr ) );
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+		addr.sin_port = htons( port );
+		sendto( m_fd, msg.data(), msg.size(), 0, reinterpret_cast<sockaddr*>( &addr ), sizeof( addr ) );
+	}
+
+private:
+	int m_fd;
+	unsigned int m_port;
+};
+
+BOOST_AUTO_TEST_CASE( server )
+{
+	Endpoint server;
+	NatPinger pinger;
+	BOOST_CHECK( !pinger.SendTo( "127.0.0.1", server.Port(), "nick" ) );
+	const unsigned int port = pinger.Open( 0 );
+	BOOST_REQUIRE( port != 0 );
+	BOOST_CHECK_EQUAL( pinger.Open( 0 ), port );
+	BOOST_CHECK_EQUAL( pinger.Open( port ), port );
+
+	// every ping comes from the same port
+	for ( int i = 0; i < 3; i++ ) {
+		BOOST_CHECK( pinger.SendTo( "localhost", server.Port(), "nick" ) );
+		unsigned int from = 0;
+		BOOST_CHECK_EQUAL( server.Receive( &from ), "nick" );
+		BOOST_CHECK_EQUAL( from, port );
+	}
+
+	// the port is taken while the pinger has it
+	NatPinger other;
+	BOOST_CHECK_EQUAL( other.Open( port ), 0 );
+	pinger.Close();
+	BOOST_CHECK( !pinger.IsOpen() );
+	BOOST_CHECK_EQUAL( other.Open( port ), port );
+}
+
+BOOST_AUTO_TEST_CASE( peers )
+{
+	Endpoint a, b;
+	NatPinger pinger;
+	const unsigned int port = pinger.Open( 0 );
+	BOOST_REQUIRE( port != 0 );
+
+	std::map<std::string, NatPinger::Address> peers;
+	peers["a"] = NatPinger::Address( "127.0.0.1", a.Port() );
+	peers["b"] = NatPinger::Address( "127.0.0.1", b.Port() );
+	peers["bad"] = NatPinger::Address( "host.invalid", 1 );
+	pinger.SetPeers( peers );
+	BOOST_CHECK( !pinger.GetPeer( "bad" )->resolved );
+	BOOST_CHECK( pinger.GetPeer( "c" ) == NULL );
+
+	BOOST_CHECK_EQUAL( pinger.PingPeers( "hai!", 1000 ), 2 );
+	BOOST_CHECK_EQUAL( a.Receive(), "hai!" );
+	BOOST_CHECK_EQUAL( b.Receive(), "hai!" );
+
+	// a answers, b doesn't
+	a.SendTo( port, "hello" );
+	usleep( 20000 );
+	BOOST_CHECK_EQUAL( pinger.Receive( 1040 ), 1 );
+	BOOST_CHECK( pinger.GetPeer( "a" )->connected );
+	BOOST_CHECK_EQUAL( pinger.GetPeer( "a" )->latency_ms, 40 );
+	BOOST_CHECK( !pinger.GetPeer( "b" )->connected );
+	BOOST_CHECK_EQUAL( pinger.GetPeer( "b" )->latency_ms, -1 );
+
+	// a is pinged on calls 1, 3, 7, 15, 23 from now on, b every time
+	const int expected[] = { 1, 3, 7, 15, 23 };
+	size_t next = 0;
+	for ( int call = 1; call <= 24; call++ ) {
+		const bool due = ( next < 5 ) && ( expected[next] == call );
+		if ( due ) next++;
+		BOOST_CHECK_EQUAL( pinger.PingPeers( "hai!", 2000 ), due ? 2 : 1 );
+		BOOST_CHECK_EQUAL( b.Receive(), "hai!" );
+		BOOST_CHECK_EQUAL( a.Receive( NULL, due ? 200 : 0 ), due ? "hai!" : "" );
+	}
+	BOOST_CHECK_EQUAL( pinger.GetPeer( "a" )->pings, 6 );
+	BOOST_CHECK_EQUAL( pinger.GetPeer( "b" )->pings, 25 );
+
+	// all ignores the schedule
+	BOOST_CHECK_EQUAL( pinger.PingPeers( "hai!", 3000, true ), 2 );
+	BOOST_CHECK_EQUAL( a.Receive(), "hai!" );
+	BOOST_CHECK_EQUAL( b.Receive(), "hai!" );
+
+	// unchanged peers keep their state, a new address starts over
+	peers.erase( "b" );
+	pinger.SetPeers( peers );
+	BOOST_CHECK( pinger.GetPeer( "a" )->connected );
+	BOOST_CHECK( pinger.GetPeer( "b" ) == NULL );
+	peers["a"] = NatPinger::Address( "127.0.0.1", b.Port() );
+	pinger.SetPeers( peers );
+	BOOST_CHECK( !pinger.GetPeer( "a" )->connected );
+	BOOST_CHECK_EQUAL( pinger.PingPeers( "hai!", 4000 ), 1 );
+	BOOST_CHECK_EQUAL( b.Receive(), "hai!" );
+
+	// datagrams from unknown addresses are dropped
+	a.SendTo( port, "who?" );
+	usleep( 20000 );
+	BOOST_CHECK_EQUAL( pinger.Receive( 4100 ), 0 );
+}
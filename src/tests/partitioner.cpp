@@ -0,0 +1,102 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE partitioner
+#include <boost/test/unit_test.hpp>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <map>
+#include "utils/partitioner.h"
+
+using Partitioner::Item;
+
+// same rank formula as User::GetBalanceRank
+static double Rank( int rank )
+{
+	return 1.0 + 0.1 * rank / 7.0;
+}
+
+static std::vector<Item> RandomLobby( size_t players, int clans )
+{
+	std::vector<Item> items;
+	for ( size_t i = 0; i < players; i++ ) {
+		int group = -1;
+		if ( clans > 0 && rand() % 4 == 0 ) group = rand() % clans;
+		items.push_back( Item( Rank( rand() % 8 ), group ) );
+	}
+	return items;
+}
+
+static void CheckGroups( const std::vector<Item>& items, const std::vector<int>& res )
+{
+	std::map<int, int> bins;
+	for ( size_t i = 0; i < items.size(); i++ ) {
+		if ( items[i].group < 0 ) continue;
+		if ( bins.count( items[i].group ) == 0 ) bins[items[i].group] = res[i];
+		BOOST_CHECK( bins[items[i].group] == res[i] );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( exact )
+{
+	std::vector<Item> items;
+	const double w[] = { 8, 7, 6, 5, 4 };
+	for ( size_t i = 0; i < 5; i++ ) items.push_back( Item( w[i] ) );
+	Partitioner::Stats stats;
+	const std::vector<int> res = Partitioner::Balance( items, 2, 1000, &stats );
+	// {8,7} / {6,5,4}, greedy gives {8,5,4} / {7,6}
+	BOOST_CHECK( Partitioner::Spread( items, res, 2 ) < 1e-6 );
+	BOOST_CHECK( Partitioner::Spread( items, Partitioner::Greedy( items, 2 ), 2 ) > 1.0 );
+	BOOST_CHECK( stats.optimal );
+}
+
+BOOST_AUTO_TEST_CASE( groups )
+{
+	std::vector<Item> items;
+	for ( size_t i = 0; i < 6; i++ ) items.push_back( Item( 1.0, i < 3 ? 0 : -1 ) );
+	const std::vector<int> res = Partitioner::Balance( items, 2 );
+	CheckGroups( items, res );
+	BOOST_CHECK( Partitioner::Spread( items, res, 2 ) < 1e-6 );
+}
+
+BOOST_AUTO_TEST_CASE( relabel )
+{
+	std::vector<int> res;
+	std::vector<int> current;
+	for ( int i = 0; i < 6; i++ ) {
+		res.push_back( i % 3 );
+		current.push_back( ( i + 1 ) % 3 );
+	}
+	Partitioner::MinimizeRelabel( res, current, 3 );
+	BOOST_CHECK( res == current );
+}
+
+// quality harness: compare against the previous greedy strategy on random lobbies
+BOOST_AUTO_TEST_CASE( quality )
+{
+	srand( 1 );
+	const size_t sizes[] = { 4, 8, 16, 32 };
+	const size_t bins[] = { 2, 3, 4 };
+	for ( size_t s = 0; s < 4; s++ ) {
+		for ( size_t b = 0; b < 3; b++ ) {
+			double greedy_total = 0, balance_total = 0;
+			long worst_ms = 0;
+			const int rounds = 20;
+			for ( int r = 0; r < rounds; r++ ) {
+				const std::vector<Item> items = RandomLobby( sizes[s], 3 );
+				Partitioner::Stats stats;
+				const std::vector<int> res = Partitioner::Balance( items, bins[b], 50, &stats );
+				const double greedy = Partitioner::Spread( items, Partitioner::Greedy( items, bins[b] ), bins[b] );
+				const double spread = Partitioner::Spread( items, res, bins[b] );
+				CheckGroups( items, res );
+				BOOST_CHECK( spread <= stats.initial_spread + 1e-9 );
+				greedy_total += greedy;
+				balance_total += spread;
+				worst_ms = std::max( worst_ms, stats.elapsed_ms );
+			}
+			printf( "players %2u bins %u: mean spread greedy %.4f, partitioner %.4f, worst %ld ms\n",
+				(unsigned)sizes[s], (unsigned)bins[b], greedy_total / rounds, balance_total / rounds, worst_ms );
+			BOOST_CHECK( balance_total <= greedy_total + 1e-9 );
+		}
+	}
+}
@@ -0,0 +1,62 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE ringbuffer
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include "utils/ringbuffer.h"
+
+BOOST_AUTO_TEST_CASE( fill )
+{
+	RingBuffer ring( 8 );
+	BOOST_CHECK_EQUAL( ring.GetContents(), "" );
+	ring.Write( "abc" );
+	ring.Write( "def" );
+	BOOST_CHECK_EQUAL( ring.GetContents(), "abcdef" );
+	BOOST_CHECK_EQUAL( ring.GetSize(), 6 );
+	BOOST_CHECK_EQUAL( ring.GetDropped(), 0 );
+
+	// wraps around the end
+	ring.Write( "ghij" );
+	BOOST_CHECK_EQUAL( ring.GetContents(), "cdefghij" );
+	BOOST_CHECK_EQUAL( ring.GetDropped(), 2 );
+	ring.Write( "k" );
+	BOOST_CHECK_EQUAL( ring.GetContents(), "defghijk" );
+	BOOST_CHECK_EQUAL( ring.GetDropped(), 3 );
+
+	ring.Clear();
+	BOOST_CHECK_EQUAL( ring.GetContents(), "" );
+	BOOST_CHECK_EQUAL( ring.GetDropped(), 0 );
+	ring.Write( "xy" );
+	BOOST_CHECK_EQUAL( ring.GetContents(), "xy" );
+}
+
+BOOST_AUTO_TEST_CASE( large )
+{
+	RingBuffer ring( 4 );
+	ring.Write( "ab" );
+	ring.Write( "0123456789" );
+	BOOST_CHECK_EQUAL( ring.GetContents(), "6789" );
+	BOOST_CHECK_EQUAL( ring.GetDropped(), 8 );
+
+	RingBuffer none( 0 );
+	none.Write( "abc" );
+	BOOST_CHECK_EQUAL( none.GetContents(), "" );
+	BOOST_CHECK_EQUAL( none.GetDropped(), 3 );
+}
+
+BOOST_AUTO_TEST_CASE( stream )
+{
+	// compare against keeping everything, with writes of all sizes
+	const size_t cap = 37;
+	RingBuffer ring( cap );
+	std::string all;
+	for ( size_t i = 0; i < 200; i++ ) {
+		std::string chunk( i % 50, char( 'a' + i % 26 ) );
+		ring.Write( chunk );
+		all += chunk;
+		const std::string expected = all.substr( all.size() > cap ? all.size() - cap : 0 );
+		BOOST_CHECK_EQUAL( ring.GetContents(), expected );
+		BOOST_CHECK_EQUAL( ring.GetDropped(), all.size() - expected.size() );
+	}
+}
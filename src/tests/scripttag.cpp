@@ -0,0 +1,60 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE scripttag
+#include <boost/test/unit_test.hpp>
+
+#include "utils/scripttag.h"
+
+BOOST_AUTO_TEST_CASE( options )
+{
+	ScriptTag tag = ScriptTag::Parse( "game/mapoptions/metal" );
+	BOOST_CHECK_EQUAL( tag.kind, ScriptTag::TAG_MAPOPTION );
+	BOOST_CHECK_EQUAL( tag.name, "metal" );
+
+	tag = ScriptTag::Parse( "game/modoptions/deathmode" );
+	BOOST_CHECK_EQUAL( tag.kind, ScriptTag::TAG_MODOPTION );
+	BOOST_CHECK_EQUAL( tag.name, "deathmode" );
+
+	tag = ScriptTag::Parse( "game/startmetal" );
+	BOOST_CHECK_EQUAL( tag.kind, ScriptTag::TAG_ENGINEOPTION );
+	BOOST_CHECK_EQUAL( tag.name, "startmetal" );
+
+	// only the first part is the section, the rest is the option
+	tag = ScriptTag::Parse( "game/modoptions/a/b" );
+	BOOST_CHECK_EQUAL( tag.kind, ScriptTag::TAG_MODOPTION );
+	BOOST_CHECK_EQUAL( tag.name, "a/b" );
+}
+
+BOOST_AUTO_TEST_CASE( special )
+{
+	ScriptTag tag = ScriptTag::Parse( "game/restrict/armcom" );
+	BOOST_CHECK_EQUAL( tag.kind, ScriptTag::TAG_RESTRICT );
+	BOOST_CHECK_EQUAL( tag.name, "armcom" );
+
+	tag = ScriptTag::Parse( "game/hosttype" );
+	BOOST_CHECK_EQUAL( tag.kind, ScriptTag::TAG_HOSTTYPE );
+
+	tag = ScriptTag::Parse( "game/team12/startposx" );
+	BOOST_CHECK_EQUAL( tag.kind, ScriptTag::TAG_STARTPOSX );
+	BOOST_CHECK_EQUAL( tag.team, 12 );
+
+	tag = ScriptTag::Parse( "game/team3/startposy" );
+	BOOST_CHECK_EQUAL( tag.kind, ScriptTag::TAG_STARTPOSY );
+	BOOST_CHECK_EQUAL( tag.team, 3 );
+
+	tag = ScriptTag::Parse( "game/team3/startposz" );
+	BOOST_CHECK_EQUAL( tag.kind, ScriptTag::TAG_STARTPOS );
+
+	// team keys without a start position are engine options
+	tag = ScriptTag::Parse( "game/team3/handicap" );
+	BOOST_CHECK_EQUAL( tag.kind, ScriptTag::TAG_ENGINEOPTION );
+	BOOST_CHECK_EQUAL( tag.name, "team3/handicap" );
+}
+
+BOOST_AUTO_TEST_CASE( other )
+{
+	BOOST_CHECK_EQUAL( ScriptTag::Parse( "" ).kind, ScriptTag::TAG_NONE );
+	BOOST_CHECK_EQUAL( ScriptTag::Parse( "game" ).kind, ScriptTag::TAG_NONE );
+	BOOST_CHECK_EQUAL( ScriptTag::Parse( "foo/game/startmetal" ).kind, ScriptTag::TAG_NONE );
+	BOOST_CHECK_EQUAL( ScriptTag::Parse( "game/" ).kind, ScriptTag::TAG_ENGINEOPTION );
+}
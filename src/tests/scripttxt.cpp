@@ -0,0 +1,330 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE scripttxt
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include "utils/scripttxt.h"
+
+// the expected scripts are what LSL::TDF::TDFWriter wrote for the same battles
+
+BOOST_AUTO_TEST_CASE( client )
+{
+	ScriptTxt::Script s;
+	s.host_ip = "192.168.1.2";
+	s.host_port = 8452;
+	s.has_source_port = true;
+	s.source_port = 8300;
+	s.my_name = "player";
+	s.my_password = "secret";
+	// host only, not written
+	s.map_name = "Comet Catcher Redux";
+	s.players.push_back( ScriptTxt::Player() );
+
+	BOOST_CHECK_EQUAL( ScriptTxt::Write( s ),
+		"[GAME]\n"
+		"{\n"
+		"\tHostIP=192.168.1.2;\n"
+		"\tHostPort=8452;\n"
+		"\tSourcePort=8300;\n"
+		"\tIsHost=0;\n"
+		"\tMyPlayerName=player;\n"
+		"\tMyPasswd=secret;\n"
+		"}\n" );
+}
+
+BOOST_AUTO_TEST_CASE( host )
+{
+	ScriptTxt::Script s;
+	s.host_port = 8452;
+	s.is_host = true;
+	s.my_name = "host";
+	s.mod_hash = "1234";
+	s.map_hash = "-5678";
+	s.map_name = "Comet Catcher Redux";
+	s.game_type = "Balanced Annihilation V7.72";
+	s.startpostype = 2;
+	s.relay_startpostype = 2;
+	s.map_options.push_back( std::make_pair( "metal", "1.5" ) );
+	s.mod_options.push_back( std::make_pair( "deathmode", "com" ) );
+	s.mod_options.push_back( std::make_pair( "maxunits", "500" ) );
+	s.restrictions.push_back( std::make_pair( "armcom", 0 ) );
+	s.restrictions.push_back( std::make_pair( "corcom", 2 ) );
+	s.num_players = 3;
+	s.num_users = 4;
+
+	ScriptTxt::Player p;
+	p.number = 0;
+	p.name = "host";
+	p.country = "de";
+	p.rank = 3;
+	p.team = 0;
+	s.players.push_back( p );
+	p.number = 1;
+	p.name = "guest";
+	p.country = "us";
+	p.password = "pw";
+	p.rank = 0;
+	p.team = 1;
+	s.players.push_back( p );
+	p.number = 3;
+	p.name = "spec";
+	p.country = "";
+	p.password = "";
+	p.spectator = true;
+	p.isfromdemo = true;
+	p.team = 1;
+	s.players.push_back( p );
+
+	ScriptTxt::AI ai;
+	ai.number = 2;
+	ai.name = "bot";
+	ai.shortname = "KAIK";
+	ai.version = "0.13";
+	ai.team = 2;
+	ai.host = 1;
+	ai.options.push_back( std::make_pair( "difficulty", "hard" ) );
+	s.ais.push_back( ai );
+
+	ScriptTxt::Team t;
+	t.number = 0;
+	t.leader = 0;
+	t.ally = 0;
+	t.red = 255;
+	t.has_side = true;
+	t.side = "arm";
+	s.teams.push_back( t );
+	t.number = 1;
+	t.leader = 1;
+	t.ally = 1;
+	t.red = 0;
+	t.green = 128;
+	t.blue = 1;
+	t.side = "core";
+	t.handicap = 20;
+	s.teams.push_back( t );
+	t.number = 2;
+	t.ally = 1;
+	t.green = 0;
+	t.blue = 255;
+	t.has_side = false;
+	t.handicap = 0;
+	s.teams.push_back( t );
+
+	ScriptTxt::AllyTeam a;
+	a.number = 0;
+	a.has_rect = true;
+	a.left = 0;
+	a.top = 0;
+	a.right = 50;
+	a.bottom = 200;
+	s.allyteams.push_back( a );
+	a.number = 1;
+	a.left = 1;
+	a.top = 199;
+	a.right = 133;
+	a.bottom = 67;
+	s.allyteams.push_back( a );
+
+	BOOST_CHECK_EQUAL( ScriptTxt::Write( s ),
+		"[GAME]\n"
+		"{\n"
+		"\tHostIP=;\n"
+		"\tHostPort=8452;\n"
+		"\tIsHost=1;\n"
+		"\tMyPlayerName=host;\n"
+		"\n"
+		"\tModHash=1234;\n"
+		"\tMapHash=-5678;\n"
+		"\tMapname=Comet Catcher Redux;\n"
+		"\tGameType=Balanced Annihilation V7.72;\n"
+		"\n"
+		"\tstartpostype=2;\n"
+		"\t[mapoptions]\n"
+		"\t{\n"
+		"\t\tmetal=1.5;\n"
+		"\t}\n"
+		"\t[modoptions]\n"
+		"\t{\n"
+		"\t\trelayhoststartpostype=2;\n"
+		"\t\tdeathmode=com;\n"
+		"\t\tmaxunits=500;\n"
+		"\t}\n"
+		"\tNumRestrictions=2;\n"
+		"\t[RESTRICT]\n"
+		"\t{\n"
+		"\t\tUnit0=armcom;\n"
+		"\t\tLimit0=0;\n"
+		"\t\tUnit1=corcom;\n"
+		"\t\tLimit1=2;\n"
+		"\t}\n"
+		"\n"
+		"\tNumPlayers=3;\n"
+		"\tNumUsers=4;\n"
+		"\n"
+		"\t[PLAYER0]\n"
+		"\t{\n"
+		"\t\tName=host;\n"
+		"\t\tCountryCode=de;\n"
+		"\t\tSpectator=0;\n"
+		"\t\tRank=3;\n"
+		"\t\tIsFromDemo=0;\n"
+		"\t\tTeam=0;\n"
+		"\t}\n"
+		"\t[PLAYER1]\n"
+		"\t{\n"
+		"\t\tName=guest;\n"
+		"\t\tCountryCode=us;\n"
+		"\t\tSpectator=0;\n"
+		"\t\tRank=0;\n"
+		"\t\tIsFromDemo=0;\n"
+		"\t\tPassword=pw;\n"
+		"\t\tTeam=1;\n"
+		"\t}\n"
+		"\t[PLAYER3]\n"
+		"\t{\n"
+		"\t\tName=spec;\n"
+		"\t\tCountryCode=;\n"
+		"\t\tSpectator=1;\n"
+		"\t\tRank=0;\n"
+		"\t\tIsFromDemo=1;\n"
+		"\t\tTeam=1;\n"
+		"\t}\n"
+		"\t[AI2]\n"
+		"\t{\n"
+		"\t\tName=bot;\n"
+		"\t\tShortName=KAIK;\n"
+		"\t\tVersion=0.13;\n"
+		"\t\tTeam=2;\n"
+		"\t\tIsFromDemo=0;\n"
+		"\t\tHost=1;\n"
+		"\t\t[Options]\n"
+		"\t\t{\n"
+		"\t\t\tdifficulty=hard;\n"
+		"\t\t}\n"
+		"\t}\n"
+		"\n"
+		"\t[TEAM0]\n"
+		"\t{\n"
+		"\t\tTeamLeader=0;\n"
+		"\t\tAllyTeam=0;\n"
+		"\t\tRGBColor=1 0 0;\n"
+		"\t\tSide=arm;\n"
+		"\t\tHandicap=0;\n"
+		"\t}\n"
+		"\t[TEAM1]\n"
+		"\t{\n"
+		"\t\tTeamLeader=1;\n"
+		"\t\tAllyTeam=1;\n"
+		"\t\tRGBColor=0 0.501961 0.00392157;\n"
+		"\t\tSide=core;\n"
+		"\t\tHandicap=20;\n"
+		"\t}\n"
+		"\t[TEAM2]\n"
+		"\t{\n"
+		"\t\tTeamLeader=1;\n"
+		"\t\tAllyTeam=1;\n"
+		"\t\tRGBColor=0 0 1;\n"
+		"\t\tHandicap=0;\n"
+		"\t}\n"
+		"\n"
+		"\t[ALLYTEAM0]\n"
+		"\t{\n"
+		"\t\tNumAllies=0;\n"
+		"\t\tStartRectLeft=0.000;\n"
+		"\t\tStartRectTop=0.000;\n"
+		"\t\tStartRectRight=0.250;\n"
+		"\t\tStartRectBottom=1.000;\n"
+		"\t}\n"
+		"\t[ALLYTEAM1]\n"
+		"\t{\n"
+		"\t\tNumAllies=0;\n"
+		"\t\tStartRectLeft=0.005;\n"
+		"\t\tStartRectTop=0.995;\n"
+		"\t\tStartRectRight=0.665;\n"
+		"\t\tStartRectBottom=0.335;\n"
+		"\t}\n"
+		"}\n" );
+}
+
+BOOST_AUTO_TEST_CASE( playback )
+{
+	ScriptTxt::Script s;
+	s.host_port = 8452;
+	s.is_host = true;
+	s.my_name = "host";
+	s.my_password = "pw";
+	s.playback_key = "DemoFile";
+	s.playback_path = "/home/user/.spring/demos/x.sdf";
+	s.startpostype = 3;
+	s.relay_startpostype = 0;
+	s.num_players = -1;
+
+	ScriptTxt::Team t;
+	t.number = 0;
+	t.has_startpos = true;
+	t.startx = 1024;
+	t.startz = -1;
+	s.teams.push_back( t );
+
+	BOOST_CHECK_EQUAL( ScriptTxt::Write( s ),
+		"[GAME]\n"
+		"{\n"
+		"\tHostIP=;\n"
+		"\tHostPort=8452;\n"
+		"\tIsHost=1;\n"
+		"\tMyPlayerName=host;\n"
+		"\tMyPasswd=pw;\n"
+		"\n"
+		"\tModHash=;\n"
+		"\tMapHash=;\n"
+		"\tMapname=;\n"
+		"\tGameType=;\n"
+		"\n"
+		"\tDemoFile=/home/user/.spring/demos/x.sdf;\n"
+		"\n"
+		"\tstartpostype=3;\n"
+		"\t[mapoptions]\n"
+		"\t{\n"
+		"\t}\n"
+		"\t[modoptions]\n"
+		"\t{\n"
+		"\t\trelayhoststartpostype=0;\n"
+		"\t}\n"
+		"\tNumRestrictions=0;\n"
+		"\t[RESTRICT]\n"
+		"\t{\n"
+		"\t}\n"
+		"\n"
+		"\tNumPlayers=-1;\n"
+		"\tNumUsers=0;\n"
+		"\n"
+		"\n"
+		"\t[TEAM0]\n"
+		"\t{\n"
+		"\t\tTeamLeader=0;\n"
+		"\t\tStartPosX=1024;\n"
+		"\t\tStartPosZ=-1;\n"
+		"\t\tAllyTeam=0;\n"
+		"\t\tRGBColor=0 0 0;\n"
+		"\t\tHandicap=0;\n"
+		"\t}\n"
+		"\n"
+		"}\n" );
+}
+
+BOOST_AUTO_TEST_CASE( colours )
+{
+	// every channel value must match std::ostream formatting of c / 255.0
+	ScriptTxt::Script s;
+	s.is_host = true;
+	ScriptTxt::Team t;
+	s.teams.push_back( t );
+	for ( int c = 0; c < 256; c++ ) {
+		s.teams[0].red = c;
+		const std::string script = ScriptTxt::Write( s );
+		std::ostringstream expected;
+		expected << "RGBColor=" << c / 255.0 << " 0 0;";
+		BOOST_CHECK( script.find( expected.str() ) != std::string::npos );
+	}
+}
@@ -0,0 +1,100 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE sendqueue
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <cstring>
+#include "utils/sendqueue.h"
+
+static void Push( SendQueue& q, const std::string& line, SendQueue::Priority prio, long now = 0 )
+{
+	q.Push( line.data(), line.length(), prio, now );
+}
+
+static std::string Take( SendQueue& q, size_t max = std::string::npos, long now = 0 )
+{
+	std::vector<SendQueue::Span> spans;
+	q.Gather( spans );
+	std::string res;
+	for ( size_t i = 0; i < spans.size(); i++ ) res.append( spans[i].data, spans[i].len );
+	res = res.substr( 0, max );
+	q.Consume( res.length(), now );
+	return res;
+}
+
+BOOST_AUTO_TEST_CASE( priority )
+{
+	SendQueue q;
+	Push( q, "SAYBATTLE a\n", SendQueue::PRIO_CHAT );
+	Push( q, "SETSCRIPTTAGS x=1\n", SendQueue::PRIO_BULK );
+	Push( q, "LEAVEBATTLE\n", SendQueue::PRIO_BATTLE );
+	Push( q, "SAYBATTLE b\n", SendQueue::PRIO_CHAT );
+	Push( q, "PING\n", SendQueue::PRIO_CONTROL );
+	// only the ping overtakes, the commands depend on their order
+	BOOST_CHECK_EQUAL( Take( q ), "PING\nSAYBATTLE a\nSETSCRIPTTAGS x=1\nLEAVEBATTLE\nSAYBATTLE b\n" );
+	BOOST_CHECK( q.Empty() );
+}
+
+BOOST_AUTO_TEST_CASE( partial_write )
+{
+	SendQueue q;
+	Push( q, "SAY main hello\n", SendQueue::PRIO_CHAT );
+	BOOST_CHECK_EQUAL( Take( q, 4 ), "SAY " );
+	// a line that is already partially on the wire is finished first
+	Push( q, "PING\n", SendQueue::PRIO_CONTROL );
+	BOOST_CHECK_EQUAL( Take( q ), "main hello\nPING\n" );
+	BOOST_CHECK_EQUAL( q.Pending(), 0u );
+}
+
+BOOST_AUTO_TEST_CASE( shaping )
+{
+	SendQueue q;
+	q.SetRate( 10 ); // 10 bytes per second, burst 10
+	Push( q, "AAAAAAAAA\n", SendQueue::PRIO_BULK );
+	Push( q, "BBBBBBBBB\n", SendQueue::PRIO_BULK );
+	BOOST_CHECK_EQUAL( Take( q ), "AAAAAAAAA\n" );
+	BOOST_CHECK_EQUAL( Take( q ), "" );
+	// a ping arriving meanwhile overtakes the waiting line
+	Push( q, "PING\n", SendQueue::PRIO_CONTROL );
+	q.Refill( 500 );
+	BOOST_CHECK_EQUAL( Take( q ), "PING\n" );
+	q.Refill( 1000 );
+	BOOST_CHECK_EQUAL( Take( q ), "BBBBBBBBB\n" );
+
+	// lines longer than the burst pass once the bucket is full
+	Push( q, std::string( 25, 'C' ), SendQueue::PRIO_CHAT );
+	BOOST_CHECK_EQUAL( Take( q ), "" );
+	q.Refill( 1000 );
+	BOOST_CHECK_EQUAL( Take( q ).length(), 25u );
+}
+
+BOOST_AUTO_TEST_CASE( chunks )
+{
+	SendQueue q( 16 );
+	for ( int i = 0; i < 100; i++ ) {
+		const std::string line = std::string( i % 40, 'a' + i % 26 ) + "\n";
+		Push( q, line, SendQueue::Priority( i % SendQueue::PRIO_COUNT ) );
+		if ( i % 7 == 0 ) Take( q );
+	}
+	Take( q );
+	BOOST_CHECK( q.Empty() );
+	Push( q, "after\n", SendQueue::PRIO_CHAT );
+	BOOST_CHECK_EQUAL( Take( q ), "after\n" );
+}
+
+BOOST_AUTO_TEST_CASE( stats )
+{
+	SendQueue q;
+	Push( q, "PING\n", SendQueue::PRIO_CONTROL, 100 );
+	Push( q, "SAY x y\n", SendQueue::PRIO_CHAT, 100 );
+	Take( q, 5, 130 );
+	Take( q, std::string::npos, 250 );
+	const SendQueue::Stats& control = q.GetStats( SendQueue::PRIO_CONTROL );
+	const SendQueue::Stats& chat = q.GetStats( SendQueue::PRIO_CHAT );
+	BOOST_CHECK_EQUAL( control.lines, 1u );
+	BOOST_CHECK_EQUAL( control.max_ms, 30 );
+	BOOST_CHECK_EQUAL( chat.lines, 1u );
+	BOOST_CHECK_EQUAL( chat.bytes, 8u );
+	BOOST_CHECK_EQUAL( chat.max_ms, 150 );
+}
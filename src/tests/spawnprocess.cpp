@@ -0,0 +1,76 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE spawnprocess
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include "utils/spawnprocess.h"
+
+static std::string ReadAll( SpawnProcess& proc )
+{
+	std::string res;
+	char buf[64];
+	int len;
+	while ( ( len = proc.Read( buf, sizeof( buf ) ) ) != -1 ) {
+		res.append( buf, len );
+	}
+	return res;
+}
+
+BOOST_AUTO_TEST_CASE( output )
+{
+	std::vector<std::string> argv;
+	argv.push_back( "sh" );
+	argv.push_back( "-c" );
+	argv.push_back( "echo out; echo err >&2; exit 3" );
+	SpawnProcess proc;
+	BOOST_REQUIRE( proc.Start( argv ) );
+	BOOST_CHECK( proc.GetPid() > 0 );
+	BOOST_CHECK_EQUAL( ReadAll( proc ), "out\nerr\n" );
+	BOOST_CHECK_EQUAL( proc.Wait(), 3 );
+}
+
+BOOST_AUTO_TEST_CASE( arguments )
+{
+	// passed as they are, without a shell
+	std::vector<std::string> argv;
+	argv.push_back( "echo" );
+	argv.push_back( "a  b" );
+	argv.push_back( "$HOME" );
+	argv.push_back( "\"'; ls" );
+	SpawnProcess proc;
+	BOOST_REQUIRE( proc.Start( argv ) );
+	BOOST_CHECK_EQUAL( ReadAll( proc ), "a  b $HOME \"'; ls\n" );
+	BOOST_CHECK_EQUAL( proc.Wait(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( timeout )
+{
+	std::vector<std::string> argv;
+	argv.push_back( "sh" );
+	argv.push_back( "-c" );
+	argv.push_back( "sleep 1; echo late" );
+	SpawnProcess proc;
+	BOOST_REQUIRE( proc.Start( argv ) );
+	char buf[16];
+	BOOST_CHECK_EQUAL( proc.Read( buf, sizeof( buf ), 10 ), 0 );
+	BOOST_CHECK_EQUAL( ReadAll( proc ), "late\n" );
+	BOOST_CHECK_EQUAL( proc.Wait(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( missing )
+{
+	std::vector<std::string> argv;
+	argv.push_back( "/nonexistent/springlobby-test" );
+	SpawnProcess proc;
+	std::string error;
+	// glibc reports a missing program from posix_spawnp, others only through the exit code
+	if ( proc.Start( argv, &error ) ) {
+		ReadAll( proc );
+		BOOST_CHECK_EQUAL( proc.Wait(), 127 );
+	} else {
+		BOOST_CHECK( !error.empty() );
+	}
+	BOOST_CHECK( !proc.Start( std::vector<std::string>() ) );
+}
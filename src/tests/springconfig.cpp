@@ -0,0 +1,108 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE springconfig
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "springsettings/springconfig.h"
+
+static const char* FILENAME = "springconfig_test.cfg";
+
+static void WriteFile( const std::string& text )
+{
+	std::ofstream out( FILENAME, std::ios::out | std::ios::binary | std::ios::trunc );
+	out << text;
+}
+
+static std::string ReadFile()
+{
+	std::ifstream in( FILENAME, std::ios::in | std::ios::binary );
+	std::ostringstream res;
+	res << in.rdbuf();
+	return res.str();
+}
+
+BOOST_AUTO_TEST_CASE( parse )
+{
+	SpringConfig config;
+	config.Parse( "# comment\nXResolution = 1024\nYResolution=768\n\nSnd_volmaster = 0.75\nName = a = b\n" );
+	BOOST_CHECK( config.Has( "XResolution" ) );
+	BOOST_CHECK( !config.Has( "ZResolution" ) );
+	BOOST_CHECK_EQUAL( config.GetInt( "XResolution", 0 ), 1024 );
+	BOOST_CHECK_EQUAL( config.GetInt( "YResolution", 0 ), 768 );
+	BOOST_CHECK_EQUAL( config.GetInt( "ZResolution", 42 ), 42 );
+	BOOST_CHECK_CLOSE( config.GetFloat( "Snd_volmaster", 0 ), 0.75f, 0.0001 );
+	BOOST_CHECK_EQUAL( config.GetString( "Name", "" ), "a = b" );
+	// not a number
+	BOOST_CHECK_EQUAL( config.GetInt( "Name", 7 ), 7 );
+}
+
+BOOST_AUTO_TEST_CASE( edit )
+{
+	SpringConfig config;
+	config.Parse( "# comment\nB = 1\nA = 2\n" );
+	BOOST_CHECK( !config.IsDirty() );
+	config.SetInt( "B", 1 );
+	BOOST_CHECK( !config.IsDirty() );
+	config.SetInt( "B", 3 );
+	config.SetFloat( "C", 0.5f );
+	BOOST_CHECK( config.IsDirty() );
+	BOOST_CHECK_EQUAL( config.GetInt( "B", 0 ), 3 );
+	// comments and order are kept, new keys are appended
+	BOOST_CHECK_EQUAL( config.Serialize(), "# comment\nB = 3\nA = 2\nC = 0.5\n" );
+	config.SetInt( "B", 1 );
+	config.SetString( "C", "" );
+	BOOST_CHECK_EQUAL( config.Serialize(), "# comment\nB = 1\nA = 2\nC = \n" );
+}
+
+BOOST_AUTO_TEST_CASE( save )
+{
+	WriteFile( "# keep me\nXResolution = 1024\n" );
+	SpringConfig config;
+	BOOST_CHECK( config.Load( FILENAME ) );
+	config.SetInt( "XResolution", 1280 );
+	config.SetInt( "YResolution", 1024 );
+	BOOST_CHECK( config.Save() );
+	BOOST_CHECK( !config.IsDirty() );
+	BOOST_CHECK_EQUAL( ReadFile(), "# keep me\nXResolution = 1280\nYResolution = 1024\n" );
+
+	SpringConfig other;
+	BOOST_CHECK( other.Load( FILENAME ) );
+	BOOST_CHECK_EQUAL( other.GetInt( "YResolution", 0 ), 1024 );
+	remove( FILENAME );
+}
+
+BOOST_AUTO_TEST_CASE( reload )
+{
+	WriteFile( "A = 1\nB = 2\n" );
+	SpringConfig config;
+	BOOST_CHECK( config.Load( FILENAME ) );
+	config.SetInt( "B", 5 );
+
+	// changed by someone else, the size differs so it's noticed even within the same second
+	WriteFile( "A = 10\nB = 2\nC = 3\n" );
+	BOOST_CHECK( config.ReloadIfChanged() );
+	BOOST_CHECK_EQUAL( config.GetInt( "A", 0 ), 10 );
+	BOOST_CHECK_EQUAL( config.GetInt( "C", 0 ), 3 );
+	BOOST_CHECK_EQUAL( config.GetInt( "B", 0 ), 5 );
+
+	// saving merges the edits into the new content
+	BOOST_CHECK( config.Save() );
+	BOOST_CHECK_EQUAL( ReadFile(), "A = 10\nB = 5\nC = 3\n" );
+	remove( FILENAME );
+}
+
+BOOST_AUTO_TEST_CASE( missing )
+{
+	remove( FILENAME );
+	SpringConfig config;
+	BOOST_CHECK( config.Load( FILENAME ) );
+	BOOST_CHECK_EQUAL( config.GetInt( "A", 4 ), 4 );
+	config.SetInt( "A", 1 );
+	BOOST_CHECK( config.Save() );
+	BOOST_CHECK_EQUAL( ReadFile(), "A = 1\n" );
+	remove( FILENAME );
+}
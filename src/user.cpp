@@ -31,8 +31,7 @@ User::User( IServer& serv )
     m_battle(0),
     m_flagicon_idx( icons().GetFlagIcon( "" ) ),
     m_rankicon_idx( icons().GetRankIcon( 0 ) ),
-    m_statusicon_idx( icons().GetUserListStateIcon( GetStatus(), false, false ) ),
-    m_sideicon_idx( icons().ICON_NONE )
+    m_statusicon_idx( icons().GetUserListStateIcon( GetStatus(), false, false ) )
 {}
 
 User::User( const std::string& nick, IServer& serv )
@@ -41,8 +40,7 @@ User::User( const std::string& nick, IServer& serv )
     m_battle(0),
     m_flagicon_idx( icons().GetFlagIcon( "" ) ),
     m_rankicon_idx( icons().GetRankIcon( 0 ) ),
-    m_statusicon_idx( icons().GetUserListStateIcon( GetStatus(), false, false ) ),
-    m_sideicon_idx( icons().ICON_NONE )
+    m_statusicon_idx( icons().GetUserListStateIcon( GetStatus(), false, false ) )
 {}
 
 User::User( const std::string& nick, const std::string& country, const int& cpu, IServer& serv)
@@ -51,8 +49,7 @@ User::User( const std::string& nick, const std::string& country, const int& cpu,
     m_battle(0),
     m_flagicon_idx( icons().GetFlagIcon( country ) ),
     m_rankicon_idx( icons().GetRankIcon( 0 ) ),
-    m_statusicon_idx( icons().GetUserListStateIcon( GetStatus(), false, false ) ),
-    m_sideicon_idx( icons().ICON_NONE )
+    m_statusicon_idx( icons().GetUserListStateIcon( GetStatus(), false, false ) )
 {}
 
 User::User( const std::string& nick )
@@ -61,8 +58,7 @@ User::User( const std::string& nick )
     m_battle(0),
     m_flagicon_idx( icons().GetFlagIcon( "" ) ),
     m_rankicon_idx( icons().GetRankIcon( 0 ) ),
-    m_statusicon_idx( icons().GetUserListStateIcon( GetStatus(), false, false ) ),
-    m_sideicon_idx( icons().ICON_NONE )
+    m_statusicon_idx( icons().GetUserListStateIcon( GetStatus(), false, false ) )
 {}
 
 User::User( const std::string& nick, const std::string& country, const int& cpu )
@@ -71,8 +67,7 @@ User::User( const std::string& nick, const std::string& country, const int& cpu
     m_battle(0),
     m_flagicon_idx( icons().GetFlagIcon(country) ),
     m_rankicon_idx( icons().GetRankIcon( 0 ) ),
-    m_statusicon_idx( icons().GetUserListStateIcon( GetStatus(), false, false ) ),
-    m_sideicon_idx( icons().ICON_NONE )
+    m_statusicon_idx( icons().GetUserListStateIcon( GetStatus(), false, false ) )
 {}
 
 User::User()
@@ -81,8 +76,7 @@ User::User()
     m_battle(0),
     m_flagicon_idx( icons().GetFlagIcon( "" ) ),
     m_rankicon_idx( icons().GetRankIcon( 0 ) ),
-    m_statusicon_idx( icons().GetUserListStateIcon( GetStatus(), false, false ) ),
-    m_sideicon_idx( icons().ICON_NONE )
+    m_statusicon_idx( icons().GetUserListStateIcon( GetStatus(), false, false ) )
 {}
 
 User::~User(){
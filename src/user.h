@@ -206,9 +206,6 @@ class User : public CommonUser
     //bool operator< ( const User& other ) const { return m_nick < other.GetNick() ; }
     //User& operator= ( const User& other );
 
-    int GetSideiconIndex() const { return m_sideicon_idx; }
-    void SetSideiconIndex( const int idx ) { m_sideicon_idx = idx; }
-
 private:
     // User variables
 
@@ -217,7 +214,6 @@ private:
     int m_flagicon_idx;
     int m_rankicon_idx;
     int m_statusicon_idx;
-    int m_sideicon_idx;
 
 	//! copy-semantics?
 };
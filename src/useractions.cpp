@@ -44,10 +44,10 @@ bool UserActions::DoActionOnUser( const UserActions::ActionType action, const wx
     // preventing action on oneself wasn't the best idea, login gets disabled
     //if ( m_knownUsers.Index( name ) == -1 || ui().IsThisMe(name) || action == ActNone )
 
-    if ( m_knownUsers.Index( name ) == -1 || action == ActNone )
+    if ( action == ActNone )
         return false;
-    else
-        return ( m_actionsGroups.find( action ) != m_actionsGroups.end() && m_actionsPeople[action].Index( name ) != -1 );
+    const PeopleMap::const_iterator it = m_people.find( name );
+    return it != m_people.end() && ( it->second.actions & action ) != 0;
 }
 
 void UserActions::Init()
@@ -104,43 +104,32 @@ void UserActions::Init()
     m_groupNames = GetGroups();
     m_groupMap.clear();
     m_groupActions.clear();
-    m_actionsGroups.clear();
-    m_actionsPeople.clear();
-    m_knownUsers.Clear();
+    m_people.clear();
     for ( unsigned int i = 0; i < m_groupNames.GetCount(); ++i)
     {
         wxString name = m_groupNames[i];
         m_groupMap[name] = GetPeopleList( name );
+        m_groupActions[name] = GetGroupActions( name );
         for ( unsigned int k = 0; k < m_groupMap[name].GetCount(); ++k)
         {
-            wxString user = m_groupMap[name][k];
-            m_knownUsers.Add( user );
-            m_peopleGroup[ user ] = name;
+            Member& member = m_people[ m_groupMap[name][k] ];
+            member.group = name;
+            member.actions = m_groupActions[name];
         }
-        m_groupActions[name] = GetGroupActions( name );
     }
-    for ( size_t i = 0; i < m_actionNames.size(); ++i)
+    m_groupNames.Sort();
+}
+
+void UserActions::SetActionsOfGroup( const wxString& group, ActionType action )
+{
+    m_groupActions[group] = action;
+    const wxArrayString& members = m_groupMap[group];
+    for ( unsigned int i = 0; i < members.GetCount(); ++i)
     {
-        UserActions::ActionType cur = (UserActions::ActionType) (1 << i);
-        wxArrayString tmp;
-        for ( unsigned int j = 0; j < m_groupNames.GetCount(); ++j)
-        {
-            wxString name = m_groupNames[j];
-            if ( ( m_groupActions[name] & cur ) != 0 )
-            {
-                tmp.Add( name );
-                for ( unsigned int k = 0; k < m_groupMap[name].GetCount(); ++k)
-                {
-                    m_actionsPeople[cur].Add( (m_groupMap[name])[k] );
-                }
-            }
-        }
-        tmp.Sort();
-        m_actionsGroups[cur] = tmp;
+        PeopleMap::iterator it = m_people.find( members[i] );
+        if ( it != m_people.end() && it->second.group == group )
+            it->second.actions = action;
     }
-    m_actionsGroups[ActNone] = m_groupNames;
-    m_groupNames.Sort();
-    m_knownUsers.Sort();
 }
 
 void UserActions::UpdateUI()
@@ -172,7 +161,15 @@ void UserActions::AddUserToGroup( const wxString& group, const wxString& name )
         return;
     m_groupMap[group].Add(name);
     SetPeopleList( m_groupMap[group], group );
-    Init();
+    const GroupActionMap::const_iterator action = m_groupActions.find( group );
+    if ( action == m_groupActions.end() ) {
+        // the group was only created by writing its members
+        Init();
+    } else {
+        Member& member = m_people[name];
+        member.group = group;
+        member.actions = action->second;
+    }
     UpdateUI();
 }
 
@@ -181,7 +178,15 @@ void UserActions::DeleteGroup(const wxString& group )
 	if ( cfg().Exists( _T( "/Groups/" ) + group ) ) {
 		cfg().DeleteGroup( _T( "/Groups/" ) + group );
 	}
-	Init();
+	const wxArrayString& members = m_groupMap[group];
+	for ( unsigned int i = 0; i < members.GetCount(); ++i ) {
+		PeopleMap::iterator it = m_people.find( members[i] );
+		if ( it != m_people.end() && it->second.group == group ) m_people.erase( it );
+	}
+	m_groupMap.erase( group );
+	m_groupActions.erase( group );
+	const int index = m_groupNames.Index( group );
+	if ( index != wxNOT_FOUND ) m_groupNames.RemoveAt( index );
 	UpdateUI();
 }
 
@@ -207,7 +212,12 @@ void UserActions::AddGroup(const wxString& group )
 		SetGroupActions( group, UserActions::ActNone );
 		SetGroupHLColor( defaultHLcolor, group );
 	}
-	Init();
+	if ( m_groupActions.find( group ) == m_groupActions.end() ) {
+		m_groupMap[group] = GetPeopleList( group );
+		m_groupActions[group] = GetGroupActions( group );
+		m_groupNames.Add( group );
+		m_groupNames.Sort();
+	}
 	UpdateUI();
 }
 
@@ -216,8 +226,9 @@ void UserActions::ChangeAction( const wxString& group, const ActionType action,
 {
     ActionType old = m_groupActions[group];
     old = (ActionType) ( add ? (old | action) : (old & ~action ) );
+    if ( old == 0 ) old = UserActions::ActNone;
     SetGroupActions( group, old );
-    Init();
+    SetActionsOfGroup( group, old );
     UpdateUI();
 }
 
@@ -269,14 +280,14 @@ UserActions::ActionType UserActions::GetGroupAction( const wxString& group ) con
 
 wxString UserActions::GetGroupOfUser( const wxString& user ) const
 {
-	const PeopleGroupMap::const_iterator res = m_peopleGroup.find(user);
-    return res->second;
+	const PeopleMap::const_iterator res = m_people.find(user);
+	if ( res == m_people.end() ) return wxEmptyString;
+    return res->second.group;
 }
 
 void UserActions::SetGroupColor( const wxString& group, const wxColour& color )
 {
     SetGroupHLColor( color, group );
-    Init();
     UpdateUI();
 }
 
@@ -303,7 +314,7 @@ wxColour UserActions::GetGroupColor( const wxString& group ) const
 
 bool UserActions::IsKnown( const wxString& name, bool outputWarning ) const
 {
-    bool ret = m_knownUsers.Index( name ) != -1;
+    bool ret = m_people.find( name ) != m_people.end();
     if ( outputWarning ){
         customMessageBoxNoModal( SL_MAIN_ICON, _("To prevent logical inconsistencies, adding a user to more than one group is not allowed"),
            _("Cannot add user to group") );
@@ -314,10 +325,13 @@ bool UserActions::IsKnown( const wxString& name, bool outputWarning ) const
 
 void UserActions::RemoveUser(const wxString& name )
 {
-    wxString group = m_peopleGroup[name];
+    const PeopleMap::iterator it = m_people.find( name );
+    if ( it == m_people.end() )
+        return;
+    const wxString group = it->second.group;
+    m_people.erase( it );
     m_groupMap[group].Remove(name);
     SetPeopleList( m_groupMap[group], group );
-    Init();
     UpdateUI();
 }
 
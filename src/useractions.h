@@ -4,6 +4,7 @@
 #define USERACTIONS_HH_INCLUDED
 
 #include <wx/arrstr.h>
+#include <wx/hashmap.h>
 #include <map>
 #include <list>
 
@@ -15,7 +16,9 @@ class wxColour;
     by forcing a write to settings handler on every change data consistency is ensured \n
     to keep runtime overhead as small as possible for the often called query funcs, all data is structured in multiple
     maps and wherever possible sortedArrays (binary search instead of linear!) are used \n
-    the price is that on every change operation (very rare compared to queries) maps need to be cleared/reloaded \n
+    every known user has an entry in a hash map holding the group and the actions of that group as bit mask,
+    so DoActionOnUser is a single lookup and a bit test. Change operations update the maps in place,
+    only Init() reads everything from config \n
     currently Gui updates are handled old fashoined way by hangling around classes, this should be improved to dynamic events
 
 **/
@@ -76,21 +79,21 @@ private:
     typedef std::map<wxString,ActionType> GroupActionMap;
     /// groupname --> ActionType for that group
     GroupActionMap m_groupActions;
-    typedef std::map<ActionType,wxArrayString> ActionGroupsMap;
-    /// ActionType --> array of groups with that actiontype
-    ActionGroupsMap m_actionsGroups;
-    typedef std::map<ActionType,wxArrayString> ActionPeopleMap;
-    /// ActionType --> array of people with that actiontype
-    ActionPeopleMap m_actionsPeople;
-    ///nickname --> group map (we don't allow users to be in more than one group
-    typedef std::map<wxString,wxString> PeopleGroupMap;
-    PeopleGroupMap m_peopleGroup;
-    ///list all known users in groups
-    wxArrayString m_knownUsers;
+    struct Member {
+        Member(): actions(0) {}
+        wxString group;
+        /// ActionType bits of the group
+        unsigned int actions;
+    };
+    ///nickname --> group and actions of all known users (we don't allow users to be in more than one group)
+    WX_DECLARE_STRING_HASH_MAP( Member, PeopleMap );
+    PeopleMap m_people;
 
     //reload all maps and stuff
     void Init();
     void UpdateUI();
+    //! sets the actions of @p group and of all its members
+    void SetActionsOfGroup( const wxString& group, ActionType action );
 
     wxArrayString m_groupNames;
 };
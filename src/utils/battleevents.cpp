@@ -5,9 +5,15 @@
 
 namespace BattleEvents {
 	static std::map< BattleEventsTypes, EventSender<BattleEventData> > BattleEvents;
+	static EventSender<BattleTagsEventData> BattleTagsEvents;
 
 	EventSender<BattleEventData> &GetBattleEventSender( BattleEventsTypes cmd )
     {
 	   return BattleEvents[cmd];
     }
+
+	EventSender<BattleTagsEventData> &GetBattleTagsEventSender()
+	{
+		return BattleTagsEvents;
+	}
 }
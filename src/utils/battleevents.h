@@ -6,6 +6,7 @@
 #include "events.h"
 #include "ibattle.h"
 #include <utility>
+#include <vector>
 
 namespace BattleEvents {
 	enum BattleEventsTypes {
@@ -19,5 +20,10 @@ namespace BattleEvents {
 
 	EventSender<BattleEventData> &GetBattleEventSender( BattleEventsTypes cmd );
 
+	//! all option tags changed by one SETSCRIPTTAGS line
+	typedef std::pair<IBattle*,std::vector<std::string> > BattleTagsEventData;
+
+	EventSender<BattleTagsEventData> &GetBattleTagsEventSender();
+
 }
 #endif // SPRINGLOBBY_HEADERGUARD_BATTLEEVENTS_H
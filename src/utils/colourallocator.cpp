@@ -0,0 +1,175 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "colourallocator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+const double ColourAllocator::DefaultMinDistance = 25.0;
+
+//! palette entries are taken from this grid of the rgb cube
+static const int PALETTE_STEP = 51;
+//! too dark colours are unreadable on the minimap and in chat
+static const double PALETTE_MIN_LIGHTNESS = 35.0;
+//! every search treats neutral grey as taken, which steers picks towards saturated colours
+static const ColourAllocator::RGB NEUTRAL( 128, 128, 128 );
+
+ColourAllocator::ColourAllocator():
+	m_root(-1)
+{
+	for ( int r = 255; r >= 0; r -= PALETTE_STEP ) {
+		for ( int g = 255; g >= 0; g -= PALETTE_STEP ) {
+			for ( int b = 255; b >= 0; b -= PALETTE_STEP ) {
+				const RGB c( r, g, b );
+				const Lab lab = ToLab( c );
+				if ( lab.l < PALETTE_MIN_LIGHTNESS ) continue;
+				m_palette.push_back( c );
+				m_lab.push_back( lab );
+			}
+		}
+	}
+	std::vector<size_t> idx( m_palette.size() );
+	for ( size_t i = 0; i < idx.size(); i++ ) idx[i] = i;
+	m_tree.reserve( idx.size() );
+	m_root = Build( idx, 0, idx.size(), 0 );
+}
+
+static double Linear( unsigned char c )
+{
+	const double v = c / 255.0;
+	return ( v <= 0.04045 ) ? v / 12.92 : pow( ( v + 0.055 ) / 1.055, 2.4 );
+}
+
+static double LabF( double t )
+{
+	return ( t > 216.0 / 24389.0 ) ? cbrt( t ) : ( t * 24389.0 / 27.0 + 16.0 ) / 116.0;
+}
+
+ColourAllocator::Lab ColourAllocator::ToLab( const RGB& c )
+{
+	const double r = Linear( c.r ), g = Linear( c.g ), b = Linear( c.b );
+	// sRGB -> XYZ, normalized to the D65 white point
+	const double x = ( 0.4124 * r + 0.3576 * g + 0.1805 * b ) / 0.95047;
+	const double y = ( 0.2126 * r + 0.7152 * g + 0.0722 * b );
+	const double z = ( 0.0193 * r + 0.1192 * g + 0.9505 * b ) / 1.08883;
+	const double fx = LabF( x ), fy = LabF( y ), fz = LabF( z );
+	Lab lab;
+	lab.l = 116.0 * fy - 16.0;
+	lab.a = 500.0 * ( fx - fy );
+	lab.b = 200.0 * ( fy - fz );
+	return lab;
+}
+
+double ColourAllocator::Distance2( const Lab& a, const Lab& b )
+{
+	const double dl = a.l - b.l, da = a.a - b.a, db = a.b - b.b;
+	return dl * dl + da * da + db * db;
+}
+
+double ColourAllocator::Distance( const RGB& a, const RGB& b )
+{
+	return sqrt( Distance2( ToLab( a ), ToLab( b ) ) );
+}
+
+double ColourAllocator::Coord( const Lab& p, int axis )
+{
+	return axis == 0 ? p.l : ( axis == 1 ? p.a : p.b );
+}
+
+int ColourAllocator::Build( std::vector<size_t>& idx, size_t begin, size_t end, int depth )
+{
+	if ( begin >= end ) return -1;
+	const int axis = depth % 3;
+	const size_t mid = ( begin + end ) / 2;
+	std::nth_element( idx.begin() + begin, idx.begin() + mid, idx.begin() + end, [this, axis]( size_t x, size_t y ) {
+		return Coord( m_lab[x], axis ) < Coord( m_lab[y], axis );
+	} );
+	const int node = m_tree.size();
+	Node n;
+	n.index = idx[mid];
+	n.axis = axis;
+	n.left = -1;
+	n.right = -1;
+	m_tree.push_back( n );
+	const int left = Build( idx, begin, mid, depth + 1 );
+	const int right = Build( idx, mid + 1, end, depth + 1 );
+	m_tree[node].left = left;
+	m_tree[node].right = right;
+	return node;
+}
+
+void ColourAllocator::Nearest( int node, const Lab& target, const std::vector<double>& min_dist, double threshold, size_t& best, double& best_dist ) const
+{
+	if ( node < 0 ) return;
+	const Node& n = m_tree[node];
+	const Lab& p = m_lab[n.index];
+	if ( min_dist.empty() || min_dist[n.index] >= threshold ) {
+		const double d = Distance2( target, p );
+		if ( d < best_dist ) {
+			best_dist = d;
+			best = n.index;
+		}
+	}
+	const double diff = Coord( target, n.axis ) - Coord( p, n.axis );
+	const int near = diff < 0 ? n.left : n.right;
+	const int far = diff < 0 ? n.right : n.left;
+	Nearest( near, target, min_dist, threshold, best, best_dist );
+	if ( diff * diff < best_dist ) Nearest( far, target, min_dist, threshold, best, best_dist );
+}
+
+size_t ColourAllocator::Nearest( const Lab& target, const std::vector<double>& min_dist, double threshold ) const
+{
+	size_t best = m_palette.size();
+	double best_dist = std::numeric_limits<double>::max();
+	Nearest( m_root, target, min_dist, threshold, best, best_dist );
+	return best;
+}
+
+void ColourAllocator::Update( std::vector<double>& min_dist, const Lab& c ) const
+{
+	for ( size_t i = 0; i < m_lab.size(); i++ ) min_dist[i] = std::min( min_dist[i], Distance2( m_lab[i], c ) );
+}
+
+size_t ColourAllocator::Farthest( const std::vector<double>& min_dist ) const
+{
+	return std::max_element( min_dist.begin(), min_dist.end() ) - min_dist.begin();
+}
+
+ColourAllocator::RGB ColourAllocator::GetFree( const std::vector<RGB>& used ) const
+{
+	std::vector<double> min_dist( m_palette.size(), std::numeric_limits<double>::max() );
+	Update( min_dist, ToLab( NEUTRAL ) );
+	for ( size_t i = 0; i < used.size(); i++ ) Update( min_dist, ToLab( used[i] ) );
+	return m_palette[Farthest( min_dist )];
+}
+
+std::vector<ColourAllocator::RGB> ColourAllocator::Assign( const std::vector<RGB>& fixed, const std::vector<RGB>& wanted, double min_distance ) const
+{
+	const double threshold = min_distance * min_distance;
+	std::vector<double> min_dist( m_palette.size(), std::numeric_limits<double>::max() );
+	Update( min_dist, ToLab( NEUTRAL ) );
+	std::vector<Lab> assigned;
+	for ( size_t i = 0; i < fixed.size(); i++ ) {
+		assigned.push_back( ToLab( fixed[i] ) );
+		Update( min_dist, assigned.back() );
+	}
+
+	std::vector<RGB> result( wanted.size() );
+	for ( size_t i = 0; i < wanted.size(); i++ ) {
+		const Lab lab = ToLab( wanted[i] );
+		double closest = std::numeric_limits<double>::max();
+		for ( size_t j = 0; j < assigned.size(); j++ ) closest = std::min( closest, Distance2( lab, assigned[j] ) );
+		if ( closest >= threshold ) {
+			result[i] = wanted[i];
+			assigned.push_back( lab );
+		} else {
+			size_t pick = Nearest( lab, min_dist, threshold );
+			if ( pick == m_palette.size() ) pick = Farthest( min_dist );
+			result[i] = m_palette[pick];
+			assigned.push_back( m_lab[pick] );
+		}
+		Update( min_dist, assigned.back() );
+	}
+	return result;
+}
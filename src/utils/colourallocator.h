@@ -0,0 +1,77 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_HEADERGUARD_COLOURALLOCATOR_H
+#define SPRINGLOBBY_HEADERGUARD_COLOURALLOCATOR_H
+
+#include <vector>
+#include <cstddef>
+
+/** Picks well separated team colours.
+ *
+ * Distances are measured in CIELAB space (CIE76), so they roughly follow perceived
+ * differences. Candidates come from a fixed palette that is converted once and stored
+ * in a k-d tree for nearest neighbour lookups.
+ */
+class ColourAllocator
+{
+public:
+	struct RGB
+	{
+		unsigned char r, g, b;
+		RGB(): r(0), g(0), b(0) {}
+		RGB( unsigned char red, unsigned char green, unsigned char blue ): r(red), g(green), b(blue) {}
+		bool operator == ( const RGB& o ) const { return r == o.r && g == o.g && b == o.b; }
+		bool operator != ( const RGB& o ) const { return !( *this == o ); }
+	};
+
+	//! colours closer than this are hard to tell apart in game
+	static const double DefaultMinDistance;
+
+	ColourAllocator();
+
+	//! perceptual distance between two colours
+	static double Distance( const RGB& a, const RGB& b );
+
+	//! palette colour that is the farthest away from all @p used colours
+	RGB GetFree( const std::vector<RGB>& used ) const;
+
+	/** Assign a colour to every entry of @p wanted in one pass.
+	 *
+	 * Colours in @p fixed never change. An entry keeps its wanted colour if it is at least
+	 * @p min_distance away from everything assigned before it, otherwise it gets the palette
+	 * colour closest to the wanted one that is far enough away, or the farthest palette colour
+	 * if there is none.
+	 */
+	std::vector<RGB> Assign( const std::vector<RGB>& fixed, const std::vector<RGB>& wanted, double min_distance = DefaultMinDistance ) const;
+
+private:
+	struct Lab
+	{
+		double l, a, b;
+	};
+	static Lab ToLab( const RGB& c );
+	static double Distance2( const Lab& a, const Lab& b );
+	static double Coord( const Lab& p, int axis );
+
+	struct Node
+	{
+		size_t index; //! palette entry
+		int axis;
+		int left, right; //! -1 for none
+	};
+	int Build( std::vector<size_t>& idx, size_t begin, size_t end, int depth );
+	//! nearest palette entry to @p target with min_dist[entry] >= @p threshold, or palette size
+	size_t Nearest( const Lab& target, const std::vector<double>& min_dist, double threshold ) const;
+	void Nearest( int node, const Lab& target, const std::vector<double>& min_dist, double threshold, size_t& best, double& best_dist ) const;
+
+	//! lower each palette entry's distance to the assigned set by colour @p c
+	void Update( std::vector<double>& min_dist, const Lab& c ) const;
+	size_t Farthest( const std::vector<double>& min_dist ) const;
+
+	std::vector<RGB> m_palette;
+	std::vector<Lab> m_lab;
+	std::vector<Node> m_tree;
+	int m_root;
+};
+
+#endif // SPRINGLOBBY_HEADERGUARD_COLOURALLOCATOR_H
@@ -0,0 +1,253 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "fuzzymatcher.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cwctype>
+
+//! patterns up to this length fit into one machine word
+static const size_t WORD_BITS = 64;
+
+//! match bit masks of a pattern, see Myers, "A fast bit-vector algorithm for approximate string matching"
+struct Pattern
+{
+	uint64_t peq[256];
+	size_t len;
+	explicit Pattern( const std::string& s ): len( s.length() )
+	{
+		memset( peq, 0, sizeof( peq ) );
+		for ( size_t i = 0; i < len; i++ ) peq[(unsigned char)s[i]] |= uint64_t( 1 ) << i;
+	}
+};
+
+/** Run the bit-vector recurrence over @p text.
+ * @param search if true, the pattern may start anywhere in the text (D[0][j] = 0), otherwise D[0][j] = j
+ * @return the distance (minimum over all end positions when searching), or max + 1 once it exceeds @p max
+ */
+static unsigned int Myers( const Pattern& p, const std::string& text, unsigned int max, bool search )
+{
+	const uint64_t last = uint64_t( 1 ) << ( p.len - 1 );
+	uint64_t pv = ~uint64_t( 0 );
+	uint64_t mv = 0;
+	unsigned int score = p.len;
+	unsigned int best = score;
+	const size_t n = text.length();
+	for ( size_t j = 0; j < n; j++ ) {
+		const uint64_t eq = p.peq[(unsigned char)text[j]];
+		const uint64_t xv = eq | mv;
+		const uint64_t xh = ( ( ( eq & pv ) + pv ) ^ pv ) | eq;
+		uint64_t ph = mv | ~( xh | pv );
+		uint64_t mh = pv & xh;
+		if ( ph & last ) score++;
+		else if ( mh & last ) score--;
+		ph <<= 1;
+		mh <<= 1;
+		if ( !search ) ph |= 1;
+		pv = mh | ~( xv | ph );
+		mv = ph & xv;
+		if ( search ) {
+			best = std::min( best, score );
+			if ( best <= max ) return best;
+		} else if ( score > max + ( n - j - 1 ) ) {
+			// every remaining column lowers the score by at most one
+			return max + 1;
+		}
+	}
+	return search ? best : score;
+}
+
+//! plain dynamic programming for patterns longer than a machine word
+static unsigned int Rows( const std::string& p, const std::string& text, unsigned int max, bool search )
+{
+	const size_t m = p.length(), n = text.length();
+	std::vector<unsigned int> col( m + 1 ), prev( m + 1 );
+	for ( size_t i = 0; i <= m; i++ ) col[i] = i;
+	unsigned int best = m;
+	for ( size_t j = 1; j <= n; j++ ) {
+		col.swap( prev );
+		col[0] = search ? 0 : j;
+		unsigned int low = col[0];
+		for ( size_t i = 1; i <= m; i++ ) {
+			const unsigned int cost = ( p[i - 1] != text[j - 1] );
+			col[i] = std::min( std::min( prev[i] + 1, col[i - 1] + 1 ), prev[i - 1] + cost );
+			low = std::min( low, col[i] );
+		}
+		if ( search ) {
+			best = std::min( best, col[m] );
+			if ( best <= max ) return best;
+		} else if ( low > max ) {
+			return max + 1;
+		}
+	}
+	return search ? best : col[m];
+}
+
+FuzzyMatcher::FuzzyMatcher( const std::vector<std::string>& candidates )
+{
+	SetCandidates( candidates );
+}
+
+void FuzzyMatcher::SetCandidates( const std::vector<std::string>& candidates )
+{
+	if ( candidates == m_candidates ) return;
+	m_candidates = candidates;
+	m_norm.resize( candidates.size() );
+	for ( size_t i = 0; i < candidates.size(); i++ ) {
+		m_norm[i].norm = Normalize( candidates[i] );
+		Trigrams( m_norm[i].norm, m_norm[i].trigrams );
+	}
+}
+
+//! length of the utf-8 sequence starting with @p c, 0 if it can't start one
+static size_t SequenceLength( unsigned char c )
+{
+	if ( c < 0x80 ) return 1;
+	if ( ( c & 0xE0 ) == 0xC0 ) return 2;
+	if ( ( c & 0xF0 ) == 0xE0 ) return 3;
+	if ( ( c & 0xF8 ) == 0xF0 ) return 4;
+	return 0;
+}
+
+static void AppendUtf8( std::string& res, uint32_t c )
+{
+	if ( c < 0x80 ) {
+		res += char( c );
+	} else if ( c < 0x800 ) {
+		res += char( 0xC0 | ( c >> 6 ) );
+		res += char( 0x80 | ( c & 0x3F ) );
+	} else if ( c < 0x10000 ) {
+		res += char( 0xE0 | ( c >> 12 ) );
+		res += char( 0x80 | ( ( c >> 6 ) & 0x3F ) );
+		res += char( 0x80 | ( c & 0x3F ) );
+	} else {
+		res += char( 0xF0 | ( c >> 18 ) );
+		res += char( 0x80 | ( ( c >> 12 ) & 0x3F ) );
+		res += char( 0x80 | ( ( c >> 6 ) & 0x3F ) );
+		res += char( 0x80 | ( c & 0x3F ) );
+	}
+}
+
+std::string FuzzyMatcher::Normalize( const std::string& s )
+{
+	std::string res;
+	res.reserve( s.length() );
+	for ( size_t i = 0; i < s.length(); ) {
+		const unsigned char c = s[i];
+		if ( c < 0x80 ) { // fast path, most map and game names are ascii
+			res += char( ( c >= 'A' && c <= 'Z' ) ? c + 'a' - 'A' : c );
+			i++;
+			continue;
+		}
+		const size_t len = SequenceLength( c );
+		uint32_t code = c & ( 0x7F >> len );
+		size_t k = 1;
+		for ( ; len > 0 && k < len && i + k < s.length() && ( (unsigned char)s[i + k] & 0xC0 ) == 0x80; k++ ) {
+			code = ( code << 6 ) | ( (unsigned char)s[i + k] & 0x3F );
+		}
+		if ( len == 0 || k < len || code > 0x10FFFF ) { // not utf-8, keep the byte
+			res += s[i];
+			i++;
+			continue;
+		}
+		const wint_t lower = std::towlower( wint_t( code ) );
+		AppendUtf8( res, ( lower > 0 && uint32_t( lower ) <= 0x10FFFF ) ? uint32_t( lower ) : code );
+		i += len;
+	}
+	return res;
+}
+
+void FuzzyMatcher::Trigrams( const std::string& s, std::vector<uint32_t>& res )
+{
+	res.clear();
+	for ( size_t i = 0; i + 2 < s.length(); i++ ) {
+		res.push_back( ( uint32_t( (unsigned char)s[i] ) << 16 ) | ( uint32_t( (unsigned char)s[i + 1] ) << 8 ) | (unsigned char)s[i + 2] );
+	}
+	std::sort( res.begin(), res.end() );
+}
+
+unsigned int FuzzyMatcher::Distance( const std::string& a, const std::string& b, unsigned int max )
+{
+	const std::string& p = ( a.length() <= b.length() ) ? a : b;
+	const std::string& t = ( a.length() <= b.length() ) ? b : a;
+	if ( t.length() - p.length() > max ) return max + 1;
+	if ( p.empty() ) return t.length();
+	if ( p.length() <= WORD_BITS ) return Myers( Pattern( p ), t, max, false );
+	return Rows( p, t, max, false );
+}
+
+bool FuzzyMatcher::Contains( const std::string& text, const std::string& pattern, unsigned int max_errors )
+{
+	if ( pattern.length() <= max_errors ) return true;
+	if ( max_errors == 0 ) return text.find( pattern ) != std::string::npos;
+	if ( pattern.length() <= WORD_BITS ) return Myers( Pattern( pattern ), text, max_errors, true ) <= max_errors;
+	return Rows( pattern, text, max_errors, true ) <= max_errors;
+}
+
+//! number of trigrams two sorted lists have in common, counting duplicates
+static size_t Common( const std::vector<uint32_t>& a, const std::vector<uint32_t>& b )
+{
+	size_t res = 0;
+	std::vector<uint32_t>::const_iterator i = a.begin(), j = b.begin();
+	while ( i != a.end() && j != b.end() ) {
+		if ( *i < *j ) ++i;
+		else if ( *j < *i ) ++j;
+		else {
+			res++;
+			++i;
+			++j;
+		}
+	}
+	return res;
+}
+
+int FuzzyMatcher::FindBest( const std::string& query, double* distance ) const
+{
+	const std::string q = Normalize( query );
+	std::vector<uint32_t> q_trigrams;
+	Trigrams( q, q_trigrams );
+
+	// lower bounds: the length difference, and the q-gram lemma
+	// (strings within distance d share at least max(len) - 3 + 1 - 3d trigrams)
+	std::vector< std::pair<unsigned int, size_t> > order;
+	order.reserve( m_norm.size() );
+	for ( size_t i = 0; i < m_norm.size(); i++ ) {
+		const size_t m = q.length(), n = m_norm[i].norm.length();
+		const size_t longest = std::max( m, n );
+		if ( longest == 0 ) continue;
+		unsigned int bound = ( m > n ) ? m - n : n - m;
+		const size_t common = Common( q_trigrams, m_norm[i].trigrams );
+		if ( longest >= 2 + common ) bound = std::max<unsigned int>( bound, ( longest - 2 - common + 2 ) / 3 );
+		order.push_back( std::make_pair( bound, i ) );
+	}
+	// likely matches first, so the cut-off gets tight early
+	std::sort( order.begin(), order.end() );
+
+	// best normalized distance so far is best_d / best_len, must stay below 1
+	size_t best_d = 1, best_len = 1;
+	int best = -1;
+	for ( size_t k = 0; k < order.size(); k++ ) {
+		const size_t i = order[k].second;
+		const size_t len = std::max( q.length(), m_norm[i].norm.length() );
+		// distances up to max can tie or beat the best
+		const size_t max = best_d * len / best_len;
+		if ( order[k].first > max ) continue;
+		const size_t d = Distance( q, m_norm[i].norm, max );
+		if ( d > max ) continue;
+		const size_t lhs = d * best_len, rhs = best_d * len;
+		if ( lhs < rhs || ( lhs == rhs && best >= 0 && int( i ) < best ) ) {
+			best = i;
+			best_d = d;
+			best_len = len;
+		}
+	}
+	if ( distance != NULL ) *distance = ( best < 0 ) ? 1.0 : double( best_d ) / best_len;
+	return best;
+}
+
+std::string FuzzyMatcher::GetBest( const std::string& query, double* distance ) const
+{
+	const int idx = FindBest( query, distance );
+	if ( idx < 0 ) return std::string();
+	return m_candidates[idx];
+}
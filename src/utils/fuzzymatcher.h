@@ -0,0 +1,60 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_HEADERGUARD_FUZZYMATCHER_H
+#define SPRINGLOBBY_HEADERGUARD_FUZZYMATCHER_H
+
+#include <vector>
+#include <string>
+#include <climits>
+#include <stdint.h>
+
+/** Finds the closest match for a string in a set of candidates.
+ *
+ * Matching is case insensitive. Candidates are normalized once and keep their
+ * trigrams, which give a lower bound for the edit distance so most candidates
+ * are skipped without computing it. The edit distance itself uses Myers'
+ * bit-parallel algorithm and stops as soon as the candidate can't win anymore.
+ */
+class FuzzyMatcher
+{
+public:
+	FuzzyMatcher() {}
+	explicit FuzzyMatcher( const std::vector<std::string>& candidates );
+
+	//! replace the candidates, cheap if they didn't change
+	void SetCandidates( const std::vector<std::string>& candidates );
+	const std::vector<std::string>& GetCandidates() const { return m_candidates; }
+
+	/** Index of the candidate with the smallest edit distance normalized by the
+	 * longer string's length, the first one wins ties. Returns -1 if all
+	 * candidates are completely different.
+	 * @param distance If not NULL, set to the normalized distance of the match (1.0 if there is none)
+	 */
+	int FindBest( const std::string& query, double* distance = NULL ) const;
+	//! the candidate found by FindBest(), or an empty string
+	std::string GetBest( const std::string& query, double* distance = NULL ) const;
+
+	//! lower case utf-8 through towlower (depends on the current locale), matching works on bytes
+	static std::string Normalize( const std::string& s );
+
+	/** Edit distance between two normalized strings.
+	 * Returns a value greater than @p max as soon as the distance is known to exceed it.
+	 */
+	static unsigned int Distance( const std::string& a, const std::string& b, unsigned int max = UINT_MAX );
+
+	//! true if @p text contains @p pattern with at most @p max_errors edits, both normalized
+	static bool Contains( const std::string& text, const std::string& pattern, unsigned int max_errors );
+
+private:
+	struct Candidate
+	{
+		std::string norm;
+		std::vector<uint32_t> trigrams; //! sorted
+	};
+	static void Trigrams( const std::string& s, std::vector<uint32_t>& res );
+
+	std::vector<std::string> m_candidates;
+	std::vector<Candidate> m_norm;
+};
+
+#endif // SPRINGLOBBY_HEADERGUARD_FUZZYMATCHER_H
@@ -13,6 +13,7 @@ public:
 	static const wxEventType OnDownloadComplete;
 	static const wxEventType OnUnitsyncFirstTimeLoad;
 	static const wxEventType OnUnitsyncReloaded;
+	static const wxEventType OnContentAdded; //! see ContentRegistry
 	static const wxEventType OnSpringTerminated;
 	static const wxEventType OnSpringStarted;
 	static const wxEventType UpdateFinished;
@@ -0,0 +1,97 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "iconcache.h"
+
+#include <cassert>
+
+IconCache::IconCache( size_t capacity ):
+	m_capacity( capacity > 0 ? capacity : 1 ),
+	m_head( NONE ),
+	m_tail( NONE )
+{
+}
+
+void IconCache::Unlink( size_t entry )
+{
+	Entry& e = m_entries[entry];
+	if ( e.prev != NONE ) m_entries[e.prev].next = e.next;
+	else m_head = e.next;
+	if ( e.next != NONE ) m_entries[e.next].prev = e.prev;
+	else m_tail = e.prev;
+}
+
+void IconCache::PushFront( size_t entry )
+{
+	Entry& e = m_entries[entry];
+	e.prev = NONE;
+	e.next = m_head;
+	if ( m_head != NONE ) m_entries[m_head].prev = entry;
+	m_head = entry;
+	if ( m_tail == NONE ) m_tail = entry;
+}
+
+int IconCache::Find( uint64_t key )
+{
+	std::map<uint64_t, size_t>::const_iterator it = m_index.find( key );
+	if ( it == m_index.end() ) {
+		m_stats.misses++;
+		return -1;
+	}
+	m_stats.hits++;
+	if ( it->second != m_head ) {
+		Unlink( it->second );
+		PushFront( it->second );
+	}
+	return m_entries[it->second].slot;
+}
+
+void IconCache::Evict()
+{
+	if ( m_index.size() < m_capacity ) return;
+	const size_t entry = m_tail;
+	Unlink( entry );
+	m_index.erase( m_entries[entry].key );
+	m_free.push_back( entry );
+	m_stats.evictions++;
+	if ( m_entries[entry].owned ) m_free_slots.push_back( m_entries[entry].slot );
+}
+
+int IconCache::TakeFreeSlot()
+{
+	if ( m_free_slots.empty() ) return -1;
+	const int slot = m_free_slots.back();
+	m_free_slots.pop_back();
+	return slot;
+}
+
+void IconCache::Insert( uint64_t key, int slot, bool owned )
+{
+	assert( m_index.size() < m_capacity );
+	assert( m_index.find( key ) == m_index.end() );
+	size_t entry;
+	if ( m_free.empty() ) {
+		entry = m_entries.size();
+		m_entries.push_back( Entry() );
+	} else {
+		entry = m_free.back();
+		m_free.pop_back();
+	}
+	Entry& e = m_entries[entry];
+	e.key = key;
+	e.slot = slot;
+	e.owned = owned;
+	PushFront( entry );
+	m_index[key] = entry;
+}
+
+void IconCache::Erase( uint64_t first, uint64_t last )
+{
+	std::map<uint64_t, size_t>::iterator it = m_index.lower_bound( first );
+	while ( it != m_index.end() && it->first <= last ) {
+		const size_t entry = it->second;
+		Unlink( entry );
+		m_free.push_back( entry );
+		if ( m_entries[entry].owned ) m_free_slots.push_back( m_entries[entry].slot );
+		m_index.erase( it++ );
+	}
+}
@@ -0,0 +1,73 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_HEADERGUARD_ICONCACHE_H
+#define SPRINGLOBBY_HEADERGUARD_ICONCACHE_H
+
+#include <map>
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+
+/** Maps keys to image list slots, holds at most @p capacity entries.
+ *
+ * When the cache is full the least recently used entry is evicted and its slot
+ * is reused for the next icon, so the image list stops growing.
+ * Entries can also point to shared slots (fallback icons), these are never
+ * handed out for reuse.
+ */
+class IconCache
+{
+public:
+	struct Stats
+	{
+		unsigned long hits;
+		unsigned long misses;
+		unsigned long evictions;
+		Stats(): hits(0), misses(0), evictions(0) {}
+	};
+
+	explicit IconCache( size_t capacity );
+
+	//! slot of @p key or -1, marks it as most recently used
+	int Find( uint64_t key );
+
+	//! make room for a new entry, if the cache is full the least recently used one is dropped
+	void Evict();
+
+	//! a slot of an evicted entry that can be reused, or -1
+	int TakeFreeSlot();
+
+	//! add @p key, call Evict() first. @p owned: the slot belongs to this entry and may be reused
+	void Insert( uint64_t key, int slot, bool owned = true );
+
+	//! drop all entries with keys from @p first to @p last, their owned slots can be reused
+	void Erase( uint64_t first, uint64_t last );
+
+	size_t Size() const { return m_index.size(); }
+	size_t Capacity() const { return m_capacity; }
+	const Stats& GetStats() const { return m_stats; }
+
+private:
+	static const size_t NONE = (size_t)-1;
+
+	struct Entry
+	{
+		uint64_t key;
+		int slot;
+		bool owned;
+		size_t prev, next; //! lru list, head is most recently used
+	};
+
+	void Unlink( size_t entry );
+	void PushFront( size_t entry );
+
+	size_t m_capacity;
+	std::vector<Entry> m_entries;
+	std::vector<size_t> m_free; //! unused entries
+	std::vector<int> m_free_slots;
+	std::map<uint64_t, size_t> m_index;
+	size_t m_head, m_tail;
+	Stats m_stats;
+};
+
+#endif // SPRINGLOBBY_HEADERGUARD_ICONCACHE_H
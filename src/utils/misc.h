@@ -12,12 +12,13 @@ class wxString;
 /**
  * @brief Computes Levenshtein distance (edit distance) between two strings.
  * @return the Levenshtein distance normalized by the longest string's length.
- * @note Source: http://en.wikipedia.org/wiki/Levenshtein_distance
+ * @note Source: http://en.wikipedia.org/wiki/Levenshtein_distance, computed by FuzzyMatcher
  */
 double LevenshteinDistance(const wxString& _s, const wxString& _t);
 
 /**
  * @brief Gets the closest match for s in a, using LevenshteinDistance.
+ * @note Use FuzzyMatcher directly when matching against the same candidates repeatedly.
  * @param distance If not NULL, *distance is set to the edit distance from s to the return value.
  */
 wxString GetBestMatch(const wxArrayString& a, const wxString& s, double* distance = 0 );
@@ -0,0 +1,238 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "natpinger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef int socklen_t;
+#define INVALID_SOCK ( NatPinger::Socket( INVALID_SOCKET ) )
+#define CLOSE_SOCKET( s ) closesocket( SOCKET( s ) )
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#define INVALID_SOCK ( -1 )
+#define CLOSE_SOCKET( s ) close( s )
+#endif
+
+//! ipv4 address of @p host, numeric addresses are converted without a lookup
+static bool Resolve( const std::string& host, unsigned int& ip )
+{
+	addrinfo hints;
+	memset( &hints, 0, sizeof( hints ) );
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_DGRAM;
+	addrinfo* res = NULL;
+	if ( getaddrinfo( host.c_str(), NULL, &hints, &res ) != 0 || res == NULL ) return false;
+	ip = reinterpret_cast<sockaddr_in*>( res->ai_addr )->sin_addr.s_addr;
+	freeaddrinfo( res );
+	return true;
+}
+
+static sockaddr_in MakeAddr( unsigned int ip, unsigned int port )
+{
+	sockaddr_in addr;
+	memset( &addr, 0, sizeof( addr ) );
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = ip;
+	addr.sin_port = htons( port );
+	return addr;
+}
+
+//! true if the last socket call failed because it would have blocked
+static bool WouldBlock()
+{
+#ifdef _WIN32
+	return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+	return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+//! true if the last receive failed because of an icmp error for an earlier send, which can be skipped
+static bool PeerError()
+{
+#ifdef _WIN32
+	return WSAGetLastError() == WSAECONNRESET;
+#else
+	return errno == ECONNREFUSED || errno == EINTR;
+#endif
+}
+
+const unsigned int NatPinger::MAX_BACKOFF;
+
+NatPinger::NatPinger():
+	m_socket( INVALID_SOCK ),
+	m_port( 0 ),
+	m_last_ip( 0 )
+{
+}
+
+NatPinger::~NatPinger()
+{
+	Close();
+}
+
+unsigned int NatPinger::Open( unsigned int port )
+{
+	if ( IsOpen() && ( port == 0 || port == m_port ) ) return m_port;
+	Close();
+
+	Socket sock = socket( AF_INET, SOCK_DGRAM, IPPROTO_UDP );
+	if ( sock == INVALID_SOCK ) return 0;
+	const sockaddr_in local = MakeAddr( htonl( INADDR_ANY ), port );
+	sockaddr_in bound;
+	socklen_t len = sizeof( bound );
+	if ( bind( sock, reinterpret_cast<const sockaddr*>( &local ), sizeof( local ) ) != 0 ||
+	     getsockname( sock, reinterpret_cast<sockaddr*>( &bound ), &len ) != 0 ) {
+		CLOSE_SOCKET( sock );
+		return 0;
+	}
+#ifdef _WIN32
+	u_long nonblocking = 1;
+	ioctlsocket( SOCKET( sock ), FIONBIO, &nonblocking );
+#else
+	fcntl( sock, F_SETFL, fcntl( sock, F_GETFL ) | O_NONBLOCK );
+	fcntl( sock, F_SETFD, FD_CLOEXEC );
+#endif
+	m_socket = sock;
+	m_port = ntohs( bound.sin_port );
+	return m_port;
+}
+
+void NatPinger::Close()
+{
+	if ( !IsOpen() ) return;
+	CLOSE_SOCKET( m_socket );
+	m_socket = INVALID_SOCK;
+	m_port = 0;
+}
+
+bool NatPinger::IsOpen() const
+{
+	return m_socket != INVALID_SOCK;
+}
+
+bool NatPinger::SendTo( const std::string& host, unsigned int port, const std::string& message )
+{
+	if ( !IsOpen() ) return false;
+	if ( host != m_last_host ) {
+		if ( !Resolve( host, m_last_ip ) ) return false;
+		m_last_host = host;
+	}
+	const sockaddr_in addr = MakeAddr( m_last_ip, port );
+	return sendto( m_socket, message.data(), message.size(), 0, reinterpret_cast<const sockaddr*>( &addr ), sizeof( addr ) ) >= 0;
+}
+
+void NatPinger::SetPeers( const std::map<std::string, Address>& peers )
+{
+	PeerMap res;
+	for ( std::map<std::string, Address>::const_iterator it = peers.begin(); it != peers.end(); ++it ) {
+		const PeerMap::iterator old = m_peers.find( it->first );
+		if ( old != m_peers.end() && old->second.address.host == it->second.host && old->second.address.port == it->second.port ) {
+			res[it->first] = old->second;
+			continue;
+		}
+		Peer& peer = res[it->first];
+		peer.address = it->second;
+		peer.resolved = Resolve( it->second.host, peer.ip );
+	}
+	m_peers.swap( res );
+}
+
+const NatPinger::Peer* NatPinger::GetPeer( const std::string& id ) const
+{
+	const PeerMap::const_iterator it = m_peers.find( id );
+	if ( it == m_peers.end() ) return NULL;
+	return &it->second;
+}
+
+size_t NatPinger::PingPeers( const std::string& message, long long now_ms, bool all )
+{
+	if ( !IsOpen() ) return 0;
+	std::vector<sockaddr_in> targets;
+	targets.reserve( m_peers.size() );
+	for ( PeerMap::iterator it = m_peers.begin(); it != m_peers.end(); ++it ) {
+		Peer& peer = it->second;
+		if ( !peer.resolved ) continue;
+		if ( !all && peer.wait > 0 ) {
+			peer.wait--;
+			continue;
+		}
+		targets.push_back( MakeAddr( peer.ip, peer.address.port ) );
+		peer.pings++;
+		peer.last_ping_ms = now_ms;
+		peer.awaiting = true;
+		// the hole is open, keep it open with fewer pings
+		peer.interval = peer.connected ? std::min( peer.interval * 2, MAX_BACKOFF ) : 1;
+		peer.wait = peer.interval - 1;
+	}
+	if ( targets.empty() ) return 0;
+
+#if defined( __linux__ )
+	std::vector<mmsghdr> msgs( targets.size() );
+	iovec iov;
+	iov.iov_base = const_cast<char*>( message.data() );
+	iov.iov_len = message.size();
+	for ( size_t i = 0; i < targets.size(); i++ ) {
+		memset( &msgs[i], 0, sizeof( mmsghdr ) );
+		msgs[i].msg_hdr.msg_name = &targets[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof( sockaddr_in );
+		msgs[i].msg_hdr.msg_iov = &iov;
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+	size_t sent = 0;
+	while ( sent < msgs.size() ) {
+		const int res = sendmmsg( m_socket, &msgs[sent], msgs.size() - sent, 0 );
+		if ( res > 0 ) {
+			sent += res;
+		} else if ( res < 0 && errno == EINTR ) {
+			continue;
+		} else {
+			// skip the datagram that failed
+			sent++;
+		}
+	}
+#else
+	for ( size_t i = 0; i < targets.size(); i++ ) {
+		sendto( m_socket, message.data(), message.size(), 0, reinterpret_cast<const sockaddr*>( &targets[i] ), sizeof( sockaddr_in ) );
+	}
+#endif
+	return targets.size();
+}
+
+size_t NatPinger::Receive( long long now_ms )
+{
+	size_t res = 0;
+	if ( !IsOpen() ) return res;
+	char buf[512];
+	for ( ;; ) {
+		sockaddr_in from;
+		socklen_t len = sizeof( from );
+		const int got = recvfrom( m_socket, buf, sizeof( buf ), 0, reinterpret_cast<sockaddr*>( &from ), &len );
+		if ( got < 0 ) {
+			if ( !WouldBlock() && PeerError() ) continue;
+			break;
+		}
+		const unsigned int port = ntohs( from.sin_port );
+		for ( PeerMap::iterator it = m_peers.begin(); it != m_peers.end(); ++it ) {
+			Peer& peer = it->second;
+			if ( !peer.resolved || peer.ip != from.sin_addr.s_addr || peer.address.port != port ) continue;
+			if ( peer.awaiting ) {
+				peer.latency_ms = now_ms - peer.last_ping_ms;
+				peer.awaiting = false;
+			}
+			peer.connected = true;
+			res++;
+		}
+	}
+	return res;
+}
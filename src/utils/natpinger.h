@@ -0,0 +1,103 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_HEADERGUARD_NATPINGER_H
+#define SPRINGLOBBY_HEADERGUARD_NATPINGER_H
+
+#include <map>
+#include <string>
+
+/** UDP keep-alives for NAT traversal.
+ *
+ * Owns one UDP socket bound to the source port the engine will use later, so
+ * pings to the server and to the players of a hosted battle all come from the
+ * same port without rebinding it each time. Peers are pinged in one batch
+ * (sendmmsg on linux). A peer which sent something back counts as connected
+ * and is pinged less often: every 2nd, 4th ... up to every MAX_BACKOFF-th call
+ * of PingPeers().
+ *
+ * The socket has to be closed before the engine is started, as it binds the port itself.
+ */
+class NatPinger
+{
+public:
+	//! most PingPeers() calls a connected peer is skipped for
+	static const unsigned int MAX_BACKOFF = 8;
+
+	struct Address
+	{
+		std::string host;
+		unsigned int port;
+
+		Address(): port(0) {}
+		Address( const std::string& h, unsigned int p ): host(h), port(p) {}
+	};
+
+	struct Peer
+	{
+		Address address;
+		bool resolved;       //! host could be resolved, otherwise the peer isn't pinged
+		bool connected;      //! something arrived from the peer
+		long latency_ms;     //! from the last ping to the first reply after it, -1 if unknown
+		unsigned long pings; //! keep-alives sent
+
+		// ping schedule
+		unsigned int ip;        //! network byte order
+		unsigned int interval;  //! in PingPeers() calls
+		unsigned int wait;      //! calls until the next ping
+		long long last_ping_ms;
+		bool awaiting;          //! no reply since the last ping
+
+		Peer(): resolved(false), connected(false), latency_ms(-1), pings(0),
+			ip(0), interval(1), wait(0), last_ping_ms(0), awaiting(false) {}
+	};
+
+	NatPinger();
+	~NatPinger();
+
+	/** Bind the socket to @p port, 0 for any. An open socket is kept if it is bound there already.
+	 * @return the bound port, 0 if binding failed
+	 */
+	unsigned int Open( unsigned int port );
+	void Close();
+	bool IsOpen() const;
+	unsigned int GetPort() const { return m_port; }
+
+	//! send @p message to host:port right away, used for the server
+	bool SendTo( const std::string& host, unsigned int port, const std::string& message );
+
+	//! replace the peers, the state of peers whose address didn't change is kept
+	void SetPeers( const std::map<std::string, Address>& peers );
+	const Peer* GetPeer( const std::string& id ) const;
+
+	/** Send @p message to every peer that is due, or to all of them if @p all.
+	 * @param now_ms current time, for the latency
+	 * @return number of peers pinged
+	 */
+	size_t PingPeers( const std::string& message, long long now_ms, bool all = false );
+
+	/** Read everything that arrived on the socket without blocking.
+	 * @return number of datagrams from known peers
+	 */
+	size_t Receive( long long now_ms );
+
+private:
+	NatPinger( const NatPinger& );
+	NatPinger& operator=( const NatPinger& );
+
+	typedef std::map<std::string, Peer> PeerMap;
+	PeerMap m_peers;
+
+#ifdef _WIN32
+	typedef unsigned long long Socket; // SOCKET
+#else
+	typedef int Socket;
+#endif
+	Socket m_socket;
+	unsigned int m_port;
+
+	//! last SendTo() target, so the server name is resolved once
+	std::string m_last_host;
+	unsigned int m_last_ip;
+};
+
+#endif // SPRINGLOBBY_HEADERGUARD_NATPINGER_H
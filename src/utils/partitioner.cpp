@@ -0,0 +1,273 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "partitioner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <queue>
+
+namespace Partitioner
+{
+
+static const double epsilon = 1e-9;
+
+typedef std::chrono::steady_clock Clock;
+
+//! items that have to be placed together, sorted by weight
+struct Unit
+{
+	double weight;
+	std::vector<size_t> items;
+	Unit(): weight(0) {}
+	bool operator < ( const Unit& other ) const { return weight > other.weight; }
+};
+
+static std::vector<Unit> BuildUnits( const std::vector<Item>& items )
+{
+	std::vector<Unit> units;
+	std::map<int, size_t> groups;
+	for ( size_t i = 0; i < items.size(); i++ ) {
+		size_t idx = units.size();
+		if ( items[i].group >= 0 ) {
+			std::map<int, size_t>::const_iterator it = groups.find( items[i].group );
+			if ( it != groups.end() ) {
+				idx = it->second;
+			} else {
+				groups[items[i].group] = idx;
+			}
+		}
+		if ( idx == units.size() ) units.push_back( Unit() );
+		units[idx].weight += items[i].weight;
+		units[idx].items.push_back( i );
+	}
+	std::stable_sort( units.begin(), units.end() );
+	return units;
+}
+
+static std::vector<int> ToAssignment( const std::vector<Item>& items, const std::vector<Unit>& units, const std::vector<int>& unit_bins )
+{
+	std::vector<int> res( items.size(), 0 );
+	for ( size_t u = 0; u < units.size(); u++ ) {
+		for ( size_t j = 0; j < units[u].items.size(); j++ ) res[units[u].items[j]] = unit_bins[u];
+	}
+	return res;
+}
+
+static double UnitSpread( const std::vector<Unit>& units, const std::vector<int>& unit_bins, size_t bins )
+{
+	std::vector<double> sums( bins, 0.0 );
+	for ( size_t u = 0; u < units.size(); u++ ) sums[unit_bins[u]] += units[u].weight;
+	return *std::max_element( sums.begin(), sums.end() ) - *std::min_element( sums.begin(), sums.end() );
+}
+
+/** A partial k-way partition as used by the differencing heuristic,
+ * subsets are kept sorted by descending sum.
+ */
+struct Partial
+{
+	std::vector<double> sums;
+	std::vector< std::vector<size_t> > sets;
+	double Spread() const { return sums.front() - sums.back(); }
+	void Normalize()
+	{
+		std::vector<size_t> order( sums.size() );
+		for ( size_t i = 0; i < order.size(); i++ ) order[i] = i;
+		std::sort( order.begin(), order.end(), [this]( size_t a, size_t b ) { return sums[a] > sums[b]; } );
+		std::vector<double> s( sums.size() );
+		std::vector< std::vector<size_t> > t( sets.size() );
+		for ( size_t i = 0; i < order.size(); i++ ) {
+			s[i] = sums[order[i]];
+			t[i].swap( sets[order[i]] );
+		}
+		sums.swap( s );
+		sets.swap( t );
+	}
+};
+
+static std::vector<int> Differencing( const std::vector<Unit>& units, size_t bins )
+{
+	std::vector<Partial> parts( units.size() );
+	auto cmp = [&parts]( size_t a, size_t b ) { return parts[a].Spread() < parts[b].Spread(); };
+	std::priority_queue<size_t, std::vector<size_t>, decltype(cmp)> queue( cmp );
+	for ( size_t u = 0; u < units.size(); u++ ) {
+		parts[u].sums.assign( bins, 0.0 );
+		parts[u].sets.resize( bins );
+		parts[u].sums[0] = units[u].weight;
+		parts[u].sets[0].push_back( u );
+		queue.push( u );
+	}
+	// combine the two partitions with the largest spread, heaviest subset with lightest subset
+	while ( queue.size() > 1 ) {
+		const size_t a = queue.top();
+		queue.pop();
+		const size_t b = queue.top();
+		queue.pop();
+		for ( size_t i = 0; i < bins; i++ ) {
+			const size_t j = bins - 1 - i;
+			parts[a].sums[i] += parts[b].sums[j];
+			parts[a].sets[i].insert( parts[a].sets[i].end(), parts[b].sets[j].begin(), parts[b].sets[j].end() );
+		}
+		parts[b] = Partial();
+		parts[a].Normalize();
+		queue.push( a );
+	}
+	std::vector<int> unit_bins( units.size(), 0 );
+	if ( queue.empty() ) return unit_bins;
+	const Partial& res = parts[queue.top()];
+	for ( size_t i = 0; i < bins; i++ ) {
+		for ( size_t j = 0; j < res.sets[i].size(); j++ ) unit_bins[res.sets[i][j]] = i;
+	}
+	return unit_bins;
+}
+
+//! depth first branch and bound over the units, heaviest first
+class Search
+{
+public:
+	Search( const std::vector<Unit>& units, size_t bins, const std::vector<int>& initial, double initial_spread, Clock::time_point deadline ):
+		m_units( units ),
+		m_sums( bins, 0.0 ),
+		m_current( units.size(), 0 ),
+		m_best( initial ),
+		m_best_spread( initial_spread ),
+		m_remaining( units.size() + 1, 0.0 ),
+		m_deadline( deadline ),
+		m_nodes( 0 ),
+		m_timeout( false )
+	{
+		for ( size_t u = units.size(); u > 0; u-- ) m_remaining[u-1] = m_remaining[u] + units[u-1].weight;
+		m_average = m_remaining[0] / bins;
+	}
+
+	void Run() { Visit( 0 ); }
+
+	const std::vector<int>& Best() const { return m_best; }
+	double BestSpread() const { return m_best_spread; }
+	unsigned long Nodes() const { return m_nodes; }
+	bool Finished() const { return !m_timeout; }
+
+private:
+	void Visit( size_t idx )
+	{
+		if ( m_timeout || m_best_spread < epsilon ) return;
+		if ( ( ++m_nodes & 1023 ) == 0 && Clock::now() > m_deadline ) {
+			m_timeout = true;
+			return;
+		}
+		const double max = *std::max_element( m_sums.begin(), m_sums.end() );
+		const double min = *std::min_element( m_sums.begin(), m_sums.end() );
+		if ( idx == m_units.size() ) {
+			if ( max - min < m_best_spread - epsilon ) {
+				m_best_spread = max - min;
+				m_best = m_current;
+			}
+			return;
+		}
+		// the largest bin can only grow, the smallest can at most receive everything left
+		const double bound = std::max( max, m_average ) - std::min( m_average, min + m_remaining[idx] );
+		if ( bound >= m_best_spread - epsilon ) return;
+
+		std::vector<size_t> order( m_sums.size() );
+		for ( size_t i = 0; i < order.size(); i++ ) order[i] = i;
+		std::sort( order.begin(), order.end(), [this]( size_t a, size_t b ) { return m_sums[a] < m_sums[b]; } );
+		for ( size_t i = 0; i < order.size(); i++ ) {
+			// bins with equal sums are interchangeable
+			if ( i > 0 && m_sums[order[i]] - m_sums[order[i-1]] < epsilon ) continue;
+			const size_t bin = order[i];
+			m_sums[bin] += m_units[idx].weight;
+			m_current[idx] = bin;
+			Visit( idx + 1 );
+			m_sums[bin] -= m_units[idx].weight;
+		}
+	}
+
+	const std::vector<Unit>& m_units;
+	std::vector<double> m_sums;
+	std::vector<int> m_current;
+	std::vector<int> m_best;
+	double m_best_spread;
+	std::vector<double> m_remaining;
+	double m_average;
+	Clock::time_point m_deadline;
+	unsigned long m_nodes;
+	bool m_timeout;
+};
+
+std::vector<int> Balance( const std::vector<Item>& items, size_t bins, long time_budget_ms, Stats* stats )
+{
+	const Clock::time_point start = Clock::now();
+	if ( bins < 2 || items.empty() ) {
+		if ( stats ) *stats = Stats();
+		return std::vector<int>( items.size(), 0 );
+	}
+	const std::vector<Unit> units = BuildUnits( items );
+	const std::vector<int> initial = Differencing( units, bins );
+	const double initial_spread = UnitSpread( units, initial, bins );
+
+	Search search( units, bins, initial, initial_spread, start + std::chrono::milliseconds( time_budget_ms ) );
+	search.Run();
+
+	if ( stats ) {
+		stats->initial_spread = initial_spread;
+		stats->spread = search.BestSpread();
+		stats->nodes = search.Nodes();
+		stats->optimal = search.Finished();
+		stats->elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>( Clock::now() - start ).count();
+	}
+	return ToAssignment( items, units, search.Best() );
+}
+
+std::vector<int> Greedy( const std::vector<Item>& items, size_t bins )
+{
+	if ( bins < 2 ) return std::vector<int>( items.size(), 0 );
+	const std::vector<Unit> units = BuildUnits( items );
+	std::vector<double> sums( bins, 0.0 );
+	std::vector<int> unit_bins( units.size(), 0 );
+	for ( size_t u = 0; u < units.size(); u++ ) {
+		const size_t bin = std::min_element( sums.begin(), sums.end() ) - sums.begin();
+		sums[bin] += units[u].weight;
+		unit_bins[u] = bin;
+	}
+	return ToAssignment( items, units, unit_bins );
+}
+
+double Spread( const std::vector<Item>& items, const std::vector<int>& assignment, size_t bins )
+{
+	if ( bins == 0 ) return 0.0;
+	std::vector<double> sums( bins, 0.0 );
+	for ( size_t i = 0; i < items.size() && i < assignment.size(); i++ ) sums[assignment[i]] += items[i].weight;
+	return *std::max_element( sums.begin(), sums.end() ) - *std::min_element( sums.begin(), sums.end() );
+}
+
+void MinimizeRelabel( std::vector<int>& assignment, const std::vector<int>& current, size_t bins )
+{
+	// overlap[bin][label] = items in bin that currently have label
+	std::vector< std::vector<size_t> > overlap( bins, std::vector<size_t>( bins, 0 ) );
+	for ( size_t i = 0; i < assignment.size() && i < current.size(); i++ ) {
+		if ( current[i] < 0 || size_t( current[i] ) >= bins ) continue;
+		overlap[assignment[i]][current[i]]++;
+	}
+	std::vector<int> label( bins, -1 );
+	std::vector<bool> used( bins, false );
+	// greedy maximum overlap matching, bins are few so this is cheap
+	for ( size_t step = 0; step < bins; step++ ) {
+		size_t best_bin = bins, best_label = bins, best = 0;
+		for ( size_t b = 0; b < bins; b++ ) {
+			if ( label[b] >= 0 ) continue;
+			for ( size_t l = 0; l < bins; l++ ) {
+				if ( used[l] ) continue;
+				if ( best_bin == bins || overlap[b][l] > best ) {
+					best_bin = b;
+					best_label = l;
+					best = overlap[b][l];
+				}
+			}
+		}
+		label[best_bin] = best_label;
+		used[best_label] = true;
+	}
+	for ( size_t i = 0; i < assignment.size(); i++ ) assignment[i] = label[assignment[i]];
+}
+
+} // namespace Partitioner
@@ -0,0 +1,62 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_HEADERGUARD_PARTITIONER_H
+#define SPRINGLOBBY_HEADERGUARD_PARTITIONER_H
+
+#include <vector>
+#include <cstddef>
+
+/** k-way number partitioning used to balance players into alliances and control teams.
+ *
+ * Items sharing a group id (e.g. clan members) are always placed into the same bin.
+ * An initial solution is found with the Karmarkar-Karp complete differencing heuristic,
+ * which is then improved by a branch and bound search until it is proven optimal or
+ * the time budget is used up.
+ */
+namespace Partitioner
+{
+
+struct Item
+{
+	double weight;
+	int group; //! items with the same group >= 0 are kept together, -1 for none
+
+	Item(): weight(0), group(-1) {}
+	Item( double w, int g = -1 ): weight(w), group(g) {}
+};
+
+struct Stats
+{
+	double initial_spread; //! spread of the differencing solution
+	double spread;         //! spread of the returned solution
+	unsigned long nodes;   //! branch and bound nodes visited
+	bool optimal;          //! search finished inside the time budget
+	long elapsed_ms;
+
+	Stats(): initial_spread(0), spread(0), nodes(0), optimal(false), elapsed_ms(0) {}
+};
+
+/** Assign every item to one of @p bins bins, minimizing the difference between
+ * the largest and the smallest bin weight sum.
+ *
+ * @return bin index for each item, in the order of @p items
+ */
+std::vector<int> Balance( const std::vector<Item>& items, size_t bins, long time_budget_ms = 50, Stats* stats = NULL );
+
+/** Same contract as Balance, using the previous Battle::Autobalance strategy of always
+ * adding the heaviest remaining item to the lightest bin. Only used by the quality test.
+ */
+std::vector<int> Greedy( const std::vector<Item>& items, size_t bins );
+
+//! difference between the largest and smallest bin weight sum of an assignment
+double Spread( const std::vector<Item>& items, const std::vector<int>& assignment, size_t bins );
+
+/** Relabel the bins of @p assignment so that as many items as possible keep the label
+ * given in @p current, bins are interchangeable so this does not change the balance.
+ * Labels in @p current outside [0, bins) never match.
+ */
+void MinimizeRelabel( std::vector<int>& assignment, const std::vector<int>& current, size_t bins );
+
+} // namespace Partitioner
+
+#endif // SPRINGLOBBY_HEADERGUARD_PARTITIONER_H
@@ -0,0 +1,60 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "ringbuffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+RingBuffer::RingBuffer( size_t capacity ):
+	m_buf( capacity ),
+	m_begin( 0 ),
+	m_size( 0 ),
+	m_dropped( 0 )
+{
+}
+
+void RingBuffer::Write( const char* data, size_t len )
+{
+	const size_t cap = m_buf.size();
+	if ( cap == 0 ) {
+		m_dropped += len;
+		return;
+	}
+	if ( len >= cap ) {
+		// only the tail of data survives
+		m_dropped += m_size + len - cap;
+		memcpy( &m_buf[0], data + len - cap, cap );
+		m_begin = 0;
+		m_size = cap;
+		return;
+	}
+	const size_t overflow = ( m_size + len > cap ) ? m_size + len - cap : 0;
+	m_begin = ( m_begin + overflow ) % cap;
+	m_size -= overflow;
+	m_dropped += overflow;
+
+	// copy in at most two parts around the end of the buffer
+	const size_t end = ( m_begin + m_size ) % cap;
+	const size_t first = std::min( len, cap - end );
+	memcpy( &m_buf[end], data, first );
+	memcpy( &m_buf[0], data + first, len - first );
+	m_size += len;
+}
+
+std::string RingBuffer::GetContents() const
+{
+	std::string res;
+	if ( m_size == 0 ) return res;
+	res.reserve( m_size );
+	const size_t first = std::min( m_size, m_buf.size() - m_begin );
+	res.append( &m_buf[0] + m_begin, first );
+	res.append( &m_buf[0], m_size - first );
+	return res;
+}
+
+void RingBuffer::Clear()
+{
+	m_begin = 0;
+	m_size = 0;
+	m_dropped = 0;
+}
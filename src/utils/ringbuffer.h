@@ -0,0 +1,39 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_HEADERGUARD_RINGBUFFER_H
+#define SPRINGLOBBY_HEADERGUARD_RINGBUFFER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/** Keeps the last bytes written to it, older ones are dropped.
+ *
+ * Not thread-safe, callers sharing one between threads lock it themselves.
+ */
+class RingBuffer
+{
+public:
+	explicit RingBuffer( size_t capacity );
+
+	void Write( const char* data, size_t len );
+	void Write( const std::string& data ) { Write( data.data(), data.size() ); }
+
+	//! the stored bytes, oldest first
+	std::string GetContents() const;
+
+	void Clear();
+
+	size_t GetSize() const { return m_size; }
+	size_t GetCapacity() const { return m_buf.size(); }
+	//! bytes dropped because the buffer was full, since the last Clear()
+	size_t GetDropped() const { return m_dropped; }
+
+private:
+	std::vector<char> m_buf;
+	size_t m_begin; //! index of the oldest byte
+	size_t m_size;
+	size_t m_dropped;
+};
+
+#endif // SPRINGLOBBY_HEADERGUARD_RINGBUFFER_H
@@ -0,0 +1,52 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "scripttag.h"
+
+#include <cstdlib>
+
+static bool StartsWith( const std::string& s, size_t pos, const char* prefix, size_t len )
+{
+	return s.compare( pos, len, prefix ) == 0;
+}
+
+#define STARTS_WITH( s, pos, prefix ) StartsWith( s, pos, prefix, sizeof( prefix ) - 1 )
+
+//! the part after the first '/' at or after @p pos, empty if there is none
+static std::string AfterSlash( const std::string& s, size_t pos )
+{
+	const size_t slash = s.find( '/', pos );
+	if ( slash == std::string::npos ) return std::string();
+	return s.substr( slash + 1 );
+}
+
+ScriptTag ScriptTag::Parse( const std::string& key )
+{
+	ScriptTag res;
+	if ( !STARTS_WITH( key, 0, "game/" ) ) return res;
+	const size_t pos = 5;
+
+	if ( STARTS_WITH( key, pos, "mapoptions/" ) ) {
+		res.kind = TAG_MAPOPTION;
+		res.name = key.substr( pos + 11 );
+	} else if ( STARTS_WITH( key, pos, "modoptions/" ) ) {
+		res.kind = TAG_MODOPTION;
+		res.name = key.substr( pos + 11 );
+	} else if ( STARTS_WITH( key, pos, "restrict" ) ) {
+		res.kind = TAG_RESTRICT;
+		res.name = AfterSlash( key, pos );
+	} else if ( STARTS_WITH( key, pos, "team" ) && key.find( "startpos", pos ) != std::string::npos ) {
+		// team number up to the next '/'
+		const size_t slash = key.find( '/', pos );
+		const std::string team = key.substr( pos + 4, ( slash == std::string::npos ) ? std::string::npos : slash - pos - 4 );
+		res.team = atoi( team.c_str() );
+		if ( key.find( "startposx", pos ) != std::string::npos ) res.kind = TAG_STARTPOSX;
+		else if ( key.find( "startposy", pos ) != std::string::npos ) res.kind = TAG_STARTPOSY;
+		else res.kind = TAG_STARTPOS;
+	} else if ( STARTS_WITH( key, pos, "hosttype" ) ) {
+		res.kind = TAG_HOSTTYPE;
+	} else {
+		res.kind = TAG_ENGINEOPTION;
+		res.name = key.substr( pos );
+	}
+	return res;
+}
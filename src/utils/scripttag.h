@@ -0,0 +1,37 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_HEADERGUARD_SCRIPTTAG_H
+#define SPRINGLOBBY_HEADERGUARD_SCRIPTTAG_H
+
+#include <string>
+
+/** A SETSCRIPTTAGS key split into its parts.
+ *
+ * Keys are parsed once with plain string compares, so applying a tag doesn't
+ * need to walk its prefixes again.
+ */
+struct ScriptTag
+{
+	enum Kind {
+		TAG_NONE,          //! not below game/, only stored
+		TAG_ENGINEOPTION,  //! game/<name>
+		TAG_MAPOPTION,     //! game/mapoptions/<name>
+		TAG_MODOPTION,     //! game/modoptions/<name>
+		TAG_RESTRICT,      //! game/restrict/<name>, name is the unit
+		TAG_STARTPOSX,     //! game/team<team>/startposx
+		TAG_STARTPOSY,     //! game/team<team>/startposy
+		TAG_STARTPOS,      //! any other game/team<team>/...startpos..., ignored
+		TAG_HOSTTYPE       //! game/hosttype
+	};
+
+	ScriptTag(): kind( TAG_NONE ), team( 0 ) {}
+
+	Kind kind;
+	std::string name; //! option key or unit name
+	int team;         //! team of TAG_STARTPOS*
+
+	//! parse a lower case key
+	static ScriptTag Parse( const std::string& key );
+};
+
+#endif // SPRINGLOBBY_HEADERGUARD_SCRIPTTAG_H
@@ -0,0 +1,302 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "scripttxt.h"
+
+#include <sstream>
+
+namespace ScriptTxt
+{
+
+//! appends @p value in decimal, as std::ostream does
+static void AppendNumber( std::string& out, long value )
+{
+	char buf[24];
+	char* end = buf + sizeof( buf );
+	char* p = end;
+	unsigned long mag = ( value < 0 ) ? 0UL - (unsigned long)value : (unsigned long)value;
+	do {
+		*--p = '0' + mag % 10;
+		mag /= 10;
+	} while ( mag != 0 );
+	if ( value < 0 ) *--p = '-';
+	out.append( p, end - p );
+}
+
+/** appends @p value / 200 as "%.3f" would.
+ * value / 200 has at most three decimals, so this is exact and doesn't depend on the locale.
+ */
+static void AppendRectValue( std::string& out, long value )
+{
+	const long thousandths = value * 5;
+	const unsigned long mag = ( thousandths < 0 ) ? 0UL - (unsigned long)thousandths : (unsigned long)thousandths;
+	if ( thousandths < 0 ) out += '-';
+	AppendNumber( out, mag / 1000 );
+	out += '.';
+	const unsigned long frac = mag % 1000;
+	out += char( '0' + frac / 100 );
+	out += char( '0' + frac / 10 % 10 );
+	out += char( '0' + frac % 10 );
+}
+
+static std::vector<std::string> ChannelTable()
+{
+	std::vector<std::string> res( 256 );
+	for ( int i = 0; i < 256; i++ ) {
+		std::ostringstream s;
+		s << i / 255.0;
+		res[i] = s.str();
+	}
+	return res;
+}
+
+//! colour channel c / 255.0 as formatted by std::ostream, there are only 256 of them
+static const std::string& Channel( unsigned char c )
+{
+	static const std::vector<std::string> table = ChannelTable();
+	return table[c];
+}
+
+//! writes sections the way LSL::TDF::TDFWriter does
+class Emitter
+{
+public:
+	explicit Emitter( std::string& out ): m_out( out ), m_depth( 0 ) {}
+
+	void EnterSection( const char* name, long number = -1 )
+	{
+		Indent();
+		m_out += '[';
+		m_out += name;
+		if ( number >= 0 ) AppendNumber( m_out, number );
+		m_out += "]\n";
+		Indent();
+		m_out += "{\n";
+		m_depth++;
+	}
+
+	void LeaveSection()
+	{
+		m_depth--;
+		Indent();
+		m_out += "}\n";
+	}
+
+	void Append( const std::string& name, const std::string& value )
+	{
+		Key( name );
+		m_out += value;
+		m_out += ";\n";
+	}
+
+	void Append( const std::string& name, long value )
+	{
+		Key( name );
+		AppendNumber( m_out, value );
+		m_out += ";\n";
+	}
+
+	void AppendRect( const char* name, long value )
+	{
+		Key( name );
+		AppendRectValue( m_out, value );
+		m_out += ";\n";
+	}
+
+	void AppendColour( const char* name, unsigned char r, unsigned char g, unsigned char b )
+	{
+		Key( name );
+		m_out += Channel( r );
+		m_out += ' ';
+		m_out += Channel( g );
+		m_out += ' ';
+		m_out += Channel( b );
+		m_out += ";\n";
+	}
+
+	void AppendOptions( const Options& options )
+	{
+		for ( Options::const_iterator it = options.begin(); it != options.end(); ++it ) {
+			Append( it->first, it->second );
+		}
+	}
+
+	void AppendLineBreak()
+	{
+		m_out += '\n';
+	}
+
+private:
+	void Indent()
+	{
+		m_out.append( m_depth, '\t' );
+	}
+
+	void Key( const std::string& name )
+	{
+		Indent();
+		m_out += name;
+		m_out += '=';
+	}
+
+	std::string& m_out;
+	int m_depth;
+};
+
+static size_t OptionsSize( const Options& options )
+{
+	size_t res = 0;
+	for ( Options::const_iterator it = options.begin(); it != options.end(); ++it ) {
+		res += it->first.size() + it->second.size() + 8;
+	}
+	return res;
+}
+
+//! upper bound of the script size for the usual number lengths
+static size_t EstimateSize( const Script& s )
+{
+	size_t res = 512 + s.host_ip.size() + s.my_name.size() + s.my_password.size();
+	if ( !s.is_host ) return res;
+	res += s.mod_hash.size() + s.map_hash.size() + s.map_name.size() + s.game_type.size() + s.playback_path.size();
+	res += OptionsSize( s.map_options ) + OptionsSize( s.mod_options );
+	for ( size_t i = 0; i < s.restrictions.size(); i++ ) {
+		res += 2 * s.restrictions[i].first.size() + 48;
+	}
+	for ( size_t i = 0; i < s.players.size(); i++ ) {
+		const Player& p = s.players[i];
+		res += 160 + p.name.size() + p.country.size() + p.password.size();
+	}
+	for ( size_t i = 0; i < s.ais.size(); i++ ) {
+		const AI& ai = s.ais[i];
+		res += 192 + ai.name.size() + ai.shortname.size() + ai.version.size() + OptionsSize( ai.options );
+	}
+	for ( size_t i = 0; i < s.teams.size(); i++ ) {
+		res += 224 + s.teams[i].side.size();
+	}
+	res += 160 * s.allyteams.size();
+	return res;
+}
+
+std::string Write( const Script& s )
+{
+	std::string res;
+	res.reserve( EstimateSize( s ) );
+	Emitter tdf( res );
+
+	tdf.EnterSection( "GAME" );
+	tdf.Append( "HostIP", s.host_ip );
+	tdf.Append( "HostPort", s.host_port );
+	if ( s.has_source_port ) tdf.Append( "SourcePort", s.source_port );
+	tdf.Append( "IsHost", s.is_host );
+	tdf.Append( "MyPlayerName", s.my_name );
+	if ( !s.my_password.empty() ) tdf.Append( "MyPasswd", s.my_password );
+
+	if ( !s.is_host ) {
+		tdf.LeaveSection();
+		return res;
+	}
+
+	tdf.AppendLineBreak();
+	tdf.Append( "ModHash", s.mod_hash );
+	tdf.Append( "MapHash", s.map_hash );
+	tdf.Append( "Mapname", s.map_name );
+	tdf.Append( "GameType", s.game_type );
+	tdf.AppendLineBreak();
+
+	if ( !s.playback_key.empty() ) {
+		tdf.Append( s.playback_key, s.playback_path );
+		tdf.AppendLineBreak();
+	}
+
+	tdf.Append( "startpostype", s.startpostype );
+
+	tdf.EnterSection( "mapoptions" );
+	tdf.AppendOptions( s.map_options );
+	tdf.LeaveSection();
+
+	tdf.EnterSection( "modoptions" );
+	tdf.Append( "relayhoststartpostype", s.relay_startpostype );
+	tdf.AppendOptions( s.mod_options );
+	tdf.LeaveSection();
+
+	tdf.Append( "NumRestrictions", (long)s.restrictions.size() );
+	tdf.EnterSection( "RESTRICT" );
+	std::string key;
+	for ( size_t i = 0; i < s.restrictions.size(); i++ ) {
+		key = "Unit";
+		AppendNumber( key, i );
+		tdf.Append( key, s.restrictions[i].first );
+		key = "Limit";
+		AppendNumber( key, i );
+		tdf.Append( key, s.restrictions[i].second );
+	}
+	tdf.LeaveSection();
+
+	tdf.AppendLineBreak();
+	tdf.Append( "NumPlayers", s.num_players );
+	tdf.Append( "NumUsers", s.num_users );
+	tdf.AppendLineBreak();
+
+	for ( size_t i = 0; i < s.players.size(); i++ ) {
+		const Player& p = s.players[i];
+		tdf.EnterSection( "PLAYER", p.number );
+		tdf.Append( "Name", p.name );
+		tdf.Append( "CountryCode", p.country );
+		tdf.Append( "Spectator", p.spectator );
+		tdf.Append( "Rank", p.rank );
+		tdf.Append( "IsFromDemo", p.isfromdemo );
+		if ( !p.password.empty() ) tdf.Append( "Password", p.password );
+		tdf.Append( "Team", p.team );
+		tdf.LeaveSection();
+	}
+	for ( size_t i = 0; i < s.ais.size(); i++ ) {
+		const AI& ai = s.ais[i];
+		tdf.EnterSection( "AI", ai.number );
+		tdf.Append( "Name", ai.name );
+		tdf.Append( "ShortName", ai.shortname );
+		tdf.Append( "Version", ai.version );
+		tdf.Append( "Team", ai.team );
+		tdf.Append( "IsFromDemo", ai.isfromdemo );
+		tdf.Append( "Host", ai.host );
+		tdf.EnterSection( "Options" );
+		tdf.AppendOptions( ai.options );
+		tdf.LeaveSection();
+		tdf.LeaveSection();
+	}
+
+	tdf.AppendLineBreak();
+
+	for ( size_t i = 0; i < s.teams.size(); i++ ) {
+		const Team& t = s.teams[i];
+		tdf.EnterSection( "TEAM", t.number );
+		tdf.Append( "TeamLeader", t.leader );
+		if ( t.has_startpos ) {
+			tdf.Append( "StartPosX", t.startx );
+			tdf.Append( "StartPosZ", t.startz );
+		}
+		tdf.Append( "AllyTeam", t.ally );
+		tdf.AppendColour( "RGBColor", t.red, t.green, t.blue );
+		if ( t.has_side ) tdf.Append( "Side", t.side );
+		tdf.Append( "Handicap", t.handicap );
+		tdf.LeaveSection();
+	}
+
+	tdf.AppendLineBreak();
+
+	for ( size_t i = 0; i < s.allyteams.size(); i++ ) {
+		const AllyTeam& a = s.allyteams[i];
+		tdf.EnterSection( "ALLYTEAM", a.number );
+		tdf.Append( "NumAllies", 0 );
+		if ( a.has_rect ) {
+			tdf.AppendRect( "StartRectLeft", a.left );
+			tdf.AppendRect( "StartRectTop", a.top );
+			tdf.AppendRect( "StartRectRight", a.right );
+			tdf.AppendRect( "StartRectBottom", a.bottom );
+		}
+		tdf.LeaveSection();
+	}
+
+	tdf.LeaveSection();
+	return res;
+}
+
+} // namespace ScriptTxt
@@ -0,0 +1,113 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_HEADERGUARD_SCRIPTTXT_H
+#define SPRINGLOBBY_HEADERGUARD_SCRIPTTXT_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/** The start script passed to spring (script.txt).
+ *
+ * Spring::WriteScriptTxt takes a snapshot of the battle into a Script, Write() then
+ * formats it into a single UTF-8 buffer. The output is the same, byte for byte, as
+ * the one of LSL::TDF::TDFWriter used before.
+ */
+namespace ScriptTxt
+{
+
+typedef std::vector< std::pair<std::string, std::string> > Options;
+
+struct Player
+{
+	int number;
+	std::string name;
+	std::string country;
+	std::string password; //! not written if empty
+	bool spectator;
+	int rank;
+	bool isfromdemo;
+	int team;
+
+	Player(): number(0), spectator(false), rank(0), isfromdemo(false), team(0) {}
+};
+
+struct AI
+{
+	int number;
+	std::string name;
+	std::string shortname;
+	std::string version;
+	int team;
+	bool isfromdemo;
+	int host; //! number of the owning player
+	Options options;
+
+	AI(): number(0), team(0), isfromdemo(false), host(0) {}
+};
+
+struct Team
+{
+	int number;
+	int leader;
+	bool has_startpos;
+	int startx, startz;
+	int ally;
+	unsigned char red, green, blue;
+	bool has_side;
+	std::string side;
+	int handicap;
+
+	Team(): number(0), leader(0), has_startpos(false), startx(0), startz(0), ally(0),
+		red(0), green(0), blue(0), has_side(false), handicap(0) {}
+};
+
+struct AllyTeam
+{
+	int number;
+	bool has_rect;
+	int left, top, right, bottom; //! 0 - 200
+
+	AllyTeam(): number(0), has_rect(false), left(0), top(0), right(0), bottom(0) {}
+};
+
+struct Script
+{
+	// all clients
+	std::string host_ip;
+	long host_port;
+	bool has_source_port;
+	long source_port;
+	bool is_host;
+	std::string my_name;
+	std::string my_password; //! not written if empty
+
+	// host only
+	std::string mod_hash;
+	std::string map_hash;
+	std::string map_name;
+	std::string game_type;
+	std::string playback_key; //! DemoFile or Savefile, empty for a normal game
+	std::string playback_path;
+	long startpostype;
+	long relay_startpostype;
+	Options map_options;
+	Options mod_options;
+	std::vector< std::pair<std::string, int> > restrictions;
+	long num_players;
+	long num_users;
+	std::vector<Player> players;
+	std::vector<AI> ais;
+	std::vector<Team> teams;
+	std::vector<AllyTeam> allyteams;
+
+	Script(): host_port(0), has_source_port(false), source_port(0), is_host(false),
+		startpostype(0), relay_startpostype(0), num_players(0), num_users(0) {}
+};
+
+//! format @p script, the buffer is sized once up front
+std::string Write( const Script& script );
+
+} // namespace ScriptTxt
+
+#endif // SPRINGLOBBY_HEADERGUARD_SCRIPTTXT_H
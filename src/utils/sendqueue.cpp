@@ -0,0 +1,188 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "sendqueue.h"
+
+#include <cstring>
+#include <algorithm>
+
+//! idle chunks kept for reuse, more are freed
+static const size_t MAX_FREE_CHUNKS = 8;
+
+SendQueue::SendQueue( size_t chunk_size ):
+	m_chunk_size( chunk_size ),
+	m_current( NULL ),
+	m_written( 0 ),
+	m_pending( 0 ),
+	m_rate( -1 ),
+	m_burst( -1 ),
+	m_tokens( 0 )
+{
+}
+
+SendQueue::~SendQueue()
+{
+	Clear();
+	if ( m_current != NULL ) m_free.push_back( m_current );
+	for ( size_t i = 0; i < m_free.size(); i++ ) {
+		delete[] m_free[i]->data;
+		delete m_free[i];
+	}
+}
+
+void SendQueue::SetRate( int rate, int burst )
+{
+	m_rate = rate;
+	m_burst = ( burst > 0 ) ? burst : rate;
+	m_tokens = m_burst;
+}
+
+SendQueue::Chunk* SendQueue::Alloc( size_t len )
+{
+	if ( m_current != NULL && m_current->size - m_current->used >= len ) return m_current;
+	if ( len > m_chunk_size ) {
+		// oversized line, gets a chunk of its own which is freed after sending
+		Chunk* chunk = new Chunk;
+		chunk->data = new char[len];
+		chunk->size = len;
+		chunk->used = 0;
+		chunk->refs = 0;
+		return chunk;
+	}
+	if ( m_current != NULL ) {
+		Chunk* old = m_current;
+		m_current = NULL;
+		if ( old->refs == 0 ) {
+			old->used = 0;
+			m_free.push_back( old );
+		}
+	}
+	if ( m_free.empty() ) {
+		m_current = new Chunk;
+		m_current->data = new char[m_chunk_size];
+		m_current->size = m_chunk_size;
+	} else {
+		m_current = m_free.back();
+		m_free.pop_back();
+	}
+	m_current->used = 0;
+	m_current->refs = 0;
+	return m_current;
+}
+
+void SendQueue::Release( Chunk* chunk )
+{
+	if ( --chunk->refs > 0 ) return;
+	if ( chunk == m_current ) {
+		// nothing points into it anymore, start over at the beginning
+		chunk->used = 0;
+		return;
+	}
+	if ( chunk->size == m_chunk_size && m_free.size() < MAX_FREE_CHUNKS ) {
+		chunk->used = 0;
+		m_free.push_back( chunk );
+		return;
+	}
+	delete[] chunk->data;
+	delete chunk;
+}
+
+void SendQueue::Push( const char* data, size_t len, Priority prio, long now_ms )
+{
+	if ( len == 0 ) return;
+	Chunk* chunk = Alloc( len );
+	Line line;
+	line.chunk = chunk;
+	line.offset = chunk->used;
+	line.len = len;
+	line.queued_ms = now_ms;
+	line.prio = prio;
+	memcpy( chunk->data + chunk->used, data, len );
+	chunk->used += len;
+	chunk->refs++;
+	if ( prio == PRIO_CONTROL ) m_control.push_back( line );
+	else m_queue.push_back( line );
+	m_pending += len;
+}
+
+void SendQueue::Refill( long elapsed_ms )
+{
+	if ( m_rate <= 0 ) return;
+	m_tokens = std::min<double>( m_burst, m_tokens + elapsed_ms * m_rate / 1000.0 );
+}
+
+bool SendQueue::Take( size_t len )
+{
+	if ( m_rate <= 0 ) return true;
+	// a full bucket lets any line pass, otherwise lines longer than the burst would never be sent
+	if ( len > m_tokens && m_tokens < m_burst ) return false;
+	m_tokens -= len;
+	return true;
+}
+
+size_t SendQueue::Gather( std::vector<Span>& spans )
+{
+	while ( !m_control.empty() && Take( m_control.front().len ) ) {
+		m_inflight.push_back( m_control.front() );
+		m_control.pop_front();
+	}
+	// everything else waits until the control lines are out
+	while ( m_control.empty() && !m_queue.empty() && Take( m_queue.front().len ) ) {
+		m_inflight.push_back( m_queue.front() );
+		m_queue.pop_front();
+	}
+
+	spans.clear();
+	size_t total = 0;
+	for ( size_t i = 0; i < m_inflight.size(); i++ ) {
+		const Line& line = m_inflight[i];
+		const size_t skip = ( i == 0 ) ? m_written : 0;
+		Span span;
+		span.data = line.chunk->data + line.offset + skip;
+		span.len = line.len - skip;
+		spans.push_back( span );
+		total += span.len;
+	}
+	return total;
+}
+
+void SendQueue::Consume( size_t bytes, long now_ms )
+{
+	while ( bytes > 0 && !m_inflight.empty() ) {
+		const Line& line = m_inflight.front();
+		const size_t left = line.len - m_written;
+		if ( bytes < left ) {
+			m_written += bytes;
+			m_pending -= bytes;
+			return;
+		}
+		bytes -= left;
+		m_pending -= left;
+		Stats& stats = m_stats[line.prio];
+		const long latency = now_ms - line.queued_ms;
+		stats.lines++;
+		stats.bytes += line.len;
+		stats.total_ms += latency;
+		stats.max_ms = std::max( stats.max_ms, latency );
+		Release( line.chunk );
+		m_inflight.pop_front();
+		m_written = 0;
+	}
+}
+
+bool SendQueue::Empty() const
+{
+	return m_pending == 0;
+}
+
+void SendQueue::Clear()
+{
+	for ( size_t i = 0; i < m_control.size(); i++ ) Release( m_control[i].chunk );
+	m_control.clear();
+	for ( size_t i = 0; i < m_queue.size(); i++ ) Release( m_queue[i].chunk );
+	m_queue.clear();
+	for ( size_t i = 0; i < m_inflight.size(); i++ ) Release( m_inflight[i].chunk );
+	m_inflight.clear();
+	m_written = 0;
+	m_pending = 0;
+	m_tokens = m_burst;
+}
@@ -0,0 +1,116 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_HEADERGUARD_SENDQUEUE_H
+#define SPRINGLOBBY_HEADERGUARD_SENDQUEUE_H
+
+#include <deque>
+#include <vector>
+#include <cstddef>
+
+/** Outbound line queue with priority classes and a token bucket shaper.
+ *
+ * Lines are copied once into fixed size chunks and handed out as spans for
+ * gather writes, no per line allocation happens once the chunks are warm.
+ * Control lines (pings) go first, all other lines keep the order they were
+ * pushed in, because commands depend on each other (e.g. SAYBATTLE after
+ * JOINBATTLE). The other classes only separate the statistics.
+ * The bucket allows @p burst bytes at once and refills with @p rate bytes per second,
+ * a line is only taken as a whole so the server never sees half a command.
+ */
+class SendQueue
+{
+public:
+	enum Priority {
+		PRIO_CONTROL, //! pings, overtake everything else
+		PRIO_BATTLE,  //! battle commands and status
+		PRIO_CHAT,
+		PRIO_BULK,    //! script tags, listings
+		PRIO_COUNT
+	};
+
+	struct Span
+	{
+		const char* data;
+		size_t len;
+	};
+
+	//! time from Push() until the line was written completely
+	struct Stats
+	{
+		unsigned long lines;
+		unsigned long bytes;
+		double total_ms;
+		long max_ms;
+		Stats(): lines(0), bytes(0), total_ms(0), max_ms(0) {}
+	};
+
+	explicit SendQueue( size_t chunk_size = 4096 );
+	~SendQueue();
+
+	//! @p rate <= 0 disables shaping, @p burst <= 0 means one second worth of @p rate
+	void SetRate( int rate, int burst = -1 );
+	int GetRate() const { return m_rate; }
+
+	void Push( const char* data, size_t len, Priority prio, long now_ms );
+
+	//! add the tokens that accumulated during @p elapsed_ms
+	void Refill( long elapsed_ms );
+
+	/** Move lines that the bucket allows into the in-flight list and return spans
+	 * for everything in flight that was not written yet.
+	 * @return number of bytes covered by @p spans
+	 */
+	size_t Gather( std::vector<Span>& spans );
+
+	//! @p bytes of the gathered data were written
+	void Consume( size_t bytes, long now_ms );
+
+	bool Empty() const;
+	//! bytes queued or in flight
+	size_t Pending() const { return m_pending; }
+
+	//! drop everything, e.g. after a disconnect. Statistics are kept.
+	void Clear();
+
+	const Stats& GetStats( Priority prio ) const { return m_stats[prio]; }
+
+private:
+	struct Chunk
+	{
+		char* data;
+		size_t size;
+		size_t used;
+		size_t refs; //! lines still pointing into this chunk
+	};
+	struct Line
+	{
+		Chunk* chunk;
+		size_t offset;
+		size_t len;
+		long queued_ms;
+		Priority prio;
+	};
+
+	Chunk* Alloc( size_t len );
+	void Release( Chunk* chunk );
+	//! true if the bucket lets @p len bytes through now
+	bool Take( size_t len );
+
+	const size_t m_chunk_size;
+	Chunk* m_current;
+	std::vector<Chunk*> m_free;
+
+	std::deque<Line> m_control;
+	std::deque<Line> m_queue; //! all other classes, in push order
+	std::deque<Line> m_inflight;
+	size_t m_written; //! bytes of the first in-flight line already written
+	size_t m_pending;
+
+	int m_rate;
+	int m_burst;
+	double m_tokens;
+
+	Stats m_stats[PRIO_COUNT];
+};
+
+#endif // SPRINGLOBBY_HEADERGUARD_SENDQUEUE_H
@@ -3,8 +3,13 @@
 #include "slconfig.h"
 
 #include <wx/wfstream.h>
+#include <wx/mstream.h>
 #include <wx/log.h>
 #include <wx/filename.h>
+#include <wx/file.h>
+#include <wx/thread.h>
+#include <wx/stopwatch.h>
+#include <wx/time.h>
 
 #include "utils/slpaths.h"
 #include "utils/conversion.h"
@@ -13,16 +18,114 @@
 
 wxString slConfig::m_chosen_path = wxEmptyString;
 
+//! saves within this time are written at once
+static const long SAVE_DELAY_MS = 1000;
+
+//! replace @p path with @p content, serialized by the caller
+static bool WriteConfigFile( const wxString& path, const std::string& content )
+{
+	static unsigned int saves = 0;
+	wxStopWatch watch;
+	wxTempFile file;
+	if ( !file.Open( path ) || !file.Write( content.data(), content.size() ) || !file.Commit() ) {
+		wxLogError( _T( "can not save config: %s" ), path.c_str() );
+		return false;
+	}
+	saves++;
+	wxLogDebug( _T( "config file saved: %s (save #%u, %u bytes, %ld ms)" ), path.c_str(), saves, (unsigned int)content.size(), watch.Time() );
+	return true;
+}
+
+//! writes the config in the background, saves queued within SAVE_DELAY_MS result in one write
+class slConfigWriter : public wxThread
+{
+public:
+	explicit slConfigWriter( const wxString& path ):
+		wxThread( wxTHREAD_JOINABLE ),
+		m_cond( m_mutex ),
+		m_path( path ),
+		m_has_pending( false ),
+		m_stop( false )
+	{
+	}
+
+	//! replace the pending content, the first queued save starts the delay
+	void Queue( const std::string& content )
+	{
+		wxMutexLocker lock( m_mutex );
+		if ( !m_has_pending ) m_queued = wxGetLocalTimeMillis();
+		m_pending = content;
+		m_has_pending = true;
+		m_cond.Signal();
+	}
+
+	//! write the pending content now and end the thread
+	void Finish()
+	{
+		{
+			wxMutexLocker lock( m_mutex );
+			m_stop = true;
+			m_cond.Signal();
+		}
+		Wait();
+	}
+
+protected:
+	ExitCode Entry()
+	{
+		m_mutex.Lock();
+		while ( true ) {
+			if ( !m_has_pending && !m_stop ) {
+				m_cond.Wait();
+				continue;
+			}
+			if ( m_has_pending && !m_stop ) {
+				const long waited = ( wxGetLocalTimeMillis() - m_queued ).ToLong();
+				if ( waited < SAVE_DELAY_MS ) {
+					m_cond.WaitTimeout( SAVE_DELAY_MS - waited );
+					continue;
+				}
+			}
+			if ( m_has_pending ) {
+				std::string content;
+				content.swap( m_pending );
+				m_has_pending = false;
+				m_mutex.Unlock();
+				WriteConfigFile( m_path, content );
+				m_mutex.Lock();
+			}
+			if ( m_stop ) break;
+		}
+		m_mutex.Unlock();
+		return 0;
+	}
+
+private:
+	wxMutex m_mutex;
+	wxCondition m_cond;
+	const wxString m_path;
+	std::string m_pending;
+	bool m_has_pending;
+	bool m_stop;
+	wxLongLong m_queued;
+};
+
 
 slConfig::slConfig (const wxString& strLocal, const wxString& strGlobal):
-	wxFileConfig( wxEmptyString, wxEmptyString, strLocal, strGlobal, wxCONFIG_USE_LOCAL_FILE, wxConvUTF8 )
+	wxFileConfig( wxEmptyString, wxEmptyString, strLocal, strGlobal, wxCONFIG_USE_LOCAL_FILE, wxConvUTF8 ),
+	m_dirty( false ),
+	m_writer( NULL ),
+	m_finished( false )
 {
 	// nop
 }
 
 #if wxUSE_STREAMS
 slConfig::slConfig( wxInputStream& in, const wxMBConv& conv ):
-	wxFileConfig( in, conv )
+	wxFileConfig( in, conv ),
+	m_dirty( false ),
+	m_writer( NULL ),
+	m_finished( false )
 {
 	// nop
 }
@@ -73,15 +176,72 @@ slConfig* slConfig::Get() {
 
 void slConfig::SaveFile()
 {
-	Flush();
-	wxFileOutputStream outstream( slConfig::m_chosen_path );
+	if ( !m_dirty ) return;
+	m_dirty = false;
 
-	if ( !outstream.IsOk() ) {
-		// TODO: error handling
+	// wxFileConfig isn't thread-safe, so the content is serialized here
+	wxMemoryOutputStream outstream;
+	if ( !Save( outstream, wxConvUTF8 ) ) {
 		wxLogError(_T("can not save config: %s"), slConfig::m_chosen_path.c_str());
+		return;
+	}
+	std::string content( outstream.GetLength(), '\0' );
+	if ( !content.empty() ) outstream.CopyTo( &content[0], content.size() );
+	if ( content == m_saved ) return;
+	m_saved = content;
+
+	if ( m_writer == NULL && !m_finished ) {
+		m_writer = new slConfigWriter( slConfig::m_chosen_path );
+		if ( m_writer->Run() != wxTHREAD_NO_ERROR ) {
+			delete m_writer;
+			m_writer = NULL;
+			m_finished = true;
+		}
 	}
-	Save( outstream );
-	wxLogMessage(_T("config file saved: %s"), slConfig::m_chosen_path.c_str());
+	if ( m_writer != NULL ) {
+		m_writer->Queue( content );
+	} else {
+		WriteConfigFile( slConfig::m_chosen_path, content );
+	}
+}
+
+void slConfig::FinishSaving()
+{
+	m_finished = true;
+	if ( m_writer == NULL ) return;
+	m_writer->Finish();
+	delete m_writer;
+	m_writer = NULL;
+}
+
+bool slConfig::DoWriteString( const wxString& key, const wxString& szValue )
+{
+	m_dirty = true;
+	return wxFileConfig::DoWriteString( key, szValue );
+}
+
+bool slConfig::DeleteEntry( const wxString& key, bool bDeleteGroupIfEmpty )
+{
+	m_dirty = true;
+	return wxFileConfig::DeleteEntry( key, bDeleteGroupIfEmpty );
+}
+
+bool slConfig::DeleteGroup( const wxString& key )
+{
+	m_dirty = true;
+	return wxFileConfig::DeleteGroup( key );
+}
+
+bool slConfig::RenameEntry( const wxString& oldName, const wxString& newName )
+{
+	m_dirty = true;
+	return wxFileConfig::RenameEntry( oldName, newName );
+}
+
+bool slConfig::RenameGroup( const wxString& oldName, const wxString& newName )
+{
+	m_dirty = true;
+	return wxFileConfig::RenameGroup( oldName, newName );
 }
 
 /*
@@ -90,12 +250,15 @@ wxString slConfig::GetFilePath() const {
 }
 */
 
-#ifdef __WXMSW__
 bool slConfig::DoWriteLong( const wxString& key, long lValue )
 {
+	m_dirty = true;
+#ifdef __WXMSW__
 	return wxFileConfig::DoWriteString( key, TowxString<long>( lValue ) );
-}
+#else
+	return wxFileConfig::DoWriteLong( key, lValue );
 #endif
+}
 
 Default<wxString>& slConfig::GetDefaultsString() {
 	static Default<wxString> defaultString;
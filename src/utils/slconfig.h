@@ -6,6 +6,7 @@
 #include "utils/mixins.h"
 #include <wx/fileconf.h>
 #include <map>
+#include <string>
 
 // helper macros to expand __LINE__
 #define SLCONFIG__PASTE(a, b) a ## b
@@ -58,6 +59,7 @@ class Default {
 };
 
 class wxFileInputStream;
+class slConfigWriter;
 
 //! a proxy class to wxFileConfig
 // it allows direct access to the Read and Write mehtods of wxConfigBase
@@ -75,7 +77,18 @@ class slConfig : public wxFileConfig, public SL::NonCopyable
 	#endif // wxUSE_STREAMS
 
 //		wxString GetFilePath() const;
+		/** Save the config if it was changed since the last save.
+		 * The content is taken right away, writing it is left to a background thread which
+		 * waits a moment to coalesce following saves. The file is replaced atomically.
+		 */
 		void SaveFile();
+		//! write a pending save now and stop the background thread, later saves are written directly
+		void FinishSaving();
+
+		bool DeleteEntry(const wxString& key, bool bDeleteGroupIfEmpty = true);
+		bool DeleteGroup(const wxString& key);
+		bool RenameEntry(const wxString& oldName, const wxString& newName);
+		bool RenameGroup(const wxString& oldName, const wxString& newName);
 
 		//! container for default values
 		static Default<wxString>& GetDefaultsString();
@@ -118,14 +131,20 @@ class slConfig : public wxFileConfig, public SL::NonCopyable
 		};
 		static wxString m_chosen_path;
 
-#ifdef __WXMSW__
 protected:
 	//! on windows writing longs is broken so we redirect this to string
 	bool DoWriteLong(const wxString& key, long lValue);
-#endif
+	bool DoWriteString(const wxString& key, const wxString& szValue);
 
 private:
 	static slConfig* Create();
+
+	//! true if the config was changed since the last SaveFile()
+	bool m_dirty;
+	//! content of the last save, to skip saves which change nothing
+	std::string m_saved;
+	slConfigWriter* m_writer;
+	bool m_finished;
 };
 
 
@@ -6,6 +6,7 @@
 #include <wx/stdpaths.h>
 #include <wx/dir.h>
 #include <wx/log.h>
+#include <wx/thread.h>
 
 #include <lslunitsync/unitsync.h>
 #include <lslutils/config.h>
@@ -91,9 +92,13 @@ std::string SlPaths::GetCachePath()
 
 // ========================================================
 std::map<std::string, LSL::SpringBundle> SlPaths::m_spring_versions;
+std::map<std::string, std::string> SlPaths::m_compatible_versions;
+//! guards m_spring_versions and m_compatible_versions, the downloader thread replaces them after an engine download
+static wxMutex s_versions_mutex;
 
 std::map<std::string, LSL::SpringBundle> SlPaths::GetSpringVersionList()
 {
+	wxMutexLocker lock(s_versions_mutex);
 	return m_spring_versions;
 }
 
@@ -131,6 +136,11 @@ void SlPaths::EngineSubPaths(const LSL::StringVector& basedirs, LSL::StringVecto
 }
 
 void SlPaths::RefreshSpringVersionList(bool autosearch, const LSL::SpringBundle* additionalbundle)
+{
+	SetSpringVersionList(ProbeSpringBundles(GetSpringBundleCandidates(autosearch, additionalbundle)));
+}
+
+std::list<LSL::SpringBundle> SlPaths::GetSpringBundleCandidates(bool autosearch, const LSL::SpringBundle* additionalbundle)
 {
 	/*
 	FIXME: move to LSL's GetSpringVersionList() which does:
@@ -186,24 +196,40 @@ void SlPaths::RefreshSpringVersionList(bool autosearch, const LSL::SpringBundle*
 		bundle.version = configsection;
 		usync_paths.push_back(bundle);
 	}
+	return usync_paths;
+}
 
-	cfg().DeleteGroup(_T("/Spring/Paths"));
-
-	m_spring_versions.clear();
+std::map<std::string, LSL::SpringBundle> SlPaths::ProbeSpringBundles(const std::list<LSL::SpringBundle>& candidates)
+{
+	std::map<std::string, LSL::SpringBundle> res;
 	try {
-		const auto versions = LSL::SpringBundle::GetSpringVersionList( usync_paths );
+		const auto versions = LSL::SpringBundle::GetSpringVersionList( candidates );
 		for(const auto pair : versions) {
-			const LSL::SpringBundle& bundle = pair.second;
-			const std::string version = bundle.version;
-			m_spring_versions[version] = bundle;
-			SetSpringBinary(version, bundle.spring);
-			SetUnitSync(version, bundle.unitsync);
-			SetBundle(version, bundle.path);
+			res[pair.second.version] = pair.second;
 		}
 	} catch (const std::runtime_error& e) {
 		wxLogError(wxString::Format(_T("Couldn't get list of spring versions: %s"), e.what()));
 	} catch ( ...) {
-		wxLogError(_T("Unknown Execption caught in SlPaths::RefreshSpringVersionList"));
+		wxLogError(_T("Unknown Execption caught in SlPaths::ProbeSpringBundles"));
+	}
+	return res;
+}
+
+void SlPaths::SetSpringVersionList(const std::map<std::string, LSL::SpringBundle>& versions)
+{
+	cfg().DeleteGroup(_T("/Spring/Paths"));
+
+	{
+		wxMutexLocker lock(s_versions_mutex);
+		m_spring_versions = versions;
+		m_compatible_versions.clear();
+	}
+	for(const auto pair : versions) {
+		const LSL::SpringBundle& bundle = pair.second;
+		const std::string version = bundle.version;
+		SetSpringBinary(version, bundle.spring);
+		SetUnitSync(version, bundle.unitsync);
+		SetBundle(version, bundle.path);
 	}
 }
 
@@ -395,15 +421,21 @@ bool VersionSyncCompatible(const std::string& ver1, const std::string& ver2)
 
 std::string SlPaths::GetCompatibleVersion(const std::string& neededversion)
 {
-	const auto versionlist = SlPaths::GetSpringVersionList();
-	for ( const auto pair : versionlist ) {
-		const std::string ver = pair.first;
-		const LSL::SpringBundle bundle = pair.second;
-		if ( VersionSyncCompatible(neededversion, ver)) {
-			return ver;
+	// called for every battle in the list, most of them need the same few versions
+	wxMutexLocker lock(s_versions_mutex);
+	const auto cached = m_compatible_versions.find(neededversion);
+	if (cached != m_compatible_versions.end()) {
+		return cached->second;
+	}
+	std::string res;
+	for ( const auto& pair : m_spring_versions ) {
+		if ( VersionSyncCompatible(neededversion, pair.first)) {
+			res = pair.first;
+			break;
 		}
 	}
-	return "";
+	m_compatible_versions[neededversion] = res;
+	return res;
 }
 
 std::string SlPaths::GetExecutable()
@@ -3,6 +3,7 @@
 #ifndef SPRINGLOBBY_SLPATHS_H
 #define SPRINGLOBBY_SLPATHS_H
 
+#include <list>
 #include <map>
 #include <vector>
 #include <cstddef>
@@ -33,6 +34,13 @@ public:
 	 */
 
 	static void RefreshSpringVersionList(bool autosearch=true, const LSL::SpringBundle* additionalbundle = NULL);
+	/* RefreshSpringVersionList() in three steps, so the slow part can run in a background thread:
+	 * GetSpringBundleCandidates() and SetSpringVersionList() use the config and must run in the main thread,
+	 * ProbeSpringBundles() loads every unitsync to get its version and is thread-safe.
+	 */
+	static std::list<LSL::SpringBundle> GetSpringBundleCandidates(bool autosearch=true, const LSL::SpringBundle* additionalbundle = NULL);
+	static std::map<std::string, LSL::SpringBundle> ProbeSpringBundles(const std::list<LSL::SpringBundle>& candidates);
+	static void SetSpringVersionList(const std::map<std::string, LSL::SpringBundle>& versions);
 	static std::map<std::string, LSL::SpringBundle> GetSpringVersionList(); /// index -> version
 
 	static std::string GetCurrentUsedSpringIndex();
@@ -83,6 +91,8 @@ private:
 	static bool mkDir(const std::string& dir);
 	static bool IsSpringBin( const std::string& path );
 	static std::map<std::string, LSL::SpringBundle> m_spring_versions;
+	//! results of GetCompatibleVersion(), cleared when the version list changes
+	static std::map<std::string, std::string> m_compatible_versions;
 	static void PossibleEnginePaths(std::vector<std::string>& pl);
 };
 
@@ -0,0 +1,112 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef _WIN32
+
+#include "spawnprocess.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+SpawnProcess::SpawnProcess():
+	m_pid( -1 ),
+	m_output( -1 )
+{
+}
+
+SpawnProcess::~SpawnProcess()
+{
+	if ( m_output >= 0 ) close( m_output );
+}
+
+bool SpawnProcess::Start( const std::vector<std::string>& argv, std::string* error )
+{
+	if ( argv.empty() || m_pid > 0 ) {
+		if ( error != NULL ) *error = "invalid arguments";
+		return false;
+	}
+
+	// only the duplicates on stdout / stderr are inherited
+	int fds[2];
+#ifdef __APPLE__
+	// no pipe2(), a fork in another thread between these calls leaks the pipe
+	const bool piped = pipe( fds ) == 0;
+	if ( piped ) {
+		fcntl( fds[0], F_SETFD, FD_CLOEXEC );
+		fcntl( fds[1], F_SETFD, FD_CLOEXEC );
+	}
+#else
+	const bool piped = pipe2( fds, O_CLOEXEC ) == 0;
+#endif
+	if ( !piped ) {
+		if ( error != NULL ) *error = strerror( errno );
+		return false;
+	}
+
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_init( &actions );
+	posix_spawn_file_actions_adddup2( &actions, fds[1], STDOUT_FILENO );
+	posix_spawn_file_actions_adddup2( &actions, fds[1], STDERR_FILENO );
+
+	std::vector<char*> args;
+	args.reserve( argv.size() + 1 );
+	for ( size_t i = 0; i < argv.size(); i++ ) {
+		args.push_back( const_cast<char*>( argv[i].c_str() ) );
+	}
+	args.push_back( NULL );
+
+	pid_t pid;
+	const int res = posix_spawnp( &pid, args[0], &actions, NULL, &args[0], environ );
+	posix_spawn_file_actions_destroy( &actions );
+	close( fds[1] );
+	if ( res != 0 ) {
+		close( fds[0] );
+		if ( error != NULL ) *error = strerror( res );
+		return false;
+	}
+	m_pid = pid;
+	m_output = fds[0];
+	return true;
+}
+
+int SpawnProcess::Read( char* buf, size_t size, int timeout_ms )
+{
+	if ( m_output < 0 ) return -1;
+	pollfd pfd;
+	pfd.fd = m_output;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+	const int ready = poll( &pfd, 1, timeout_ms );
+	if ( ready == 0 || ( ready < 0 && errno == EINTR ) ) return 0;
+
+	ssize_t len;
+	do {
+		len = ( ready > 0 ) ? read( m_output, buf, size ) : -1;
+	} while ( len < 0 && errno == EINTR );
+	if ( len > 0 ) return len;
+	// end of output or error
+	close( m_output );
+	m_output = -1;
+	return -1;
+}
+
+int SpawnProcess::Wait()
+{
+	if ( m_pid <= 0 ) return -1;
+	int status = 0;
+	pid_t res;
+	do {
+		res = waitpid( m_pid, &status, 0 );
+	} while ( res < 0 && errno == EINTR );
+	m_pid = -1;
+	if ( res < 0 || !WIFEXITED( status ) ) return -1;
+	return WEXITSTATUS( status );
+}
+
+#endif // _WIN32
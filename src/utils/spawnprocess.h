@@ -0,0 +1,45 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_HEADERGUARD_SPAWNPROCESS_H
+#define SPRINGLOBBY_HEADERGUARD_SPAWNPROCESS_H
+
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+/** Runs a program with posix_spawn, POSIX only.
+ *
+ * The arguments are passed as they are, no shell is involved. stdout and stderr
+ * of the child both go into one pipe which is read with Read().
+ */
+class SpawnProcess
+{
+public:
+	SpawnProcess();
+	//! closes the pipe, doesn't wait for the child
+	~SpawnProcess();
+
+	/** Start the program @p argv[0], searched in PATH if it has no '/'.
+	 * @return false and sets @p error if it couldn't be started
+	 */
+	bool Start( const std::vector<std::string>& argv, std::string* error = NULL );
+
+	/** Read output of the child, waits up to @p timeout_ms (-1: forever) for some to arrive.
+	 * @return bytes read, 0 if none arrived in time, -1 once the output was closed
+	 */
+	int Read( char* buf, size_t size, int timeout_ms = -1 );
+
+	//! wait for the child to exit, returns its exit code, or -1 if it was killed or couldn't be waited for
+	int Wait();
+
+	pid_t GetPid() const { return m_pid; }
+
+private:
+	SpawnProcess( const SpawnProcess& );
+	SpawnProcess& operator=( const SpawnProcess& );
+
+	pid_t m_pid;
+	int m_output; //! read end of the pipe, -1 once closed
+};
+
+#endif // SPRINGLOBBY_HEADERGUARD_SPAWNPROCESS_H